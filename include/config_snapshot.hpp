@@ -0,0 +1,228 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <contracts.hpp>
+#include <tables/config_table.hpp>
+#include <tables/config_float_table.hpp>
+#include <tables/config_snapshot_table.hpp>
+#include <instrument.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace eosio;
+using std::string;
+
+/**
+ * A packed copy of the config parameters read on the transfer, harvest and proposal paths.
+ *
+ * settings keeps the confsnap singleton next to its config tables and updates a slot whenever
+ * configure, confwithdesc, conffloat or conffloatdsc writes one of the parameters below. A contract holds a
+ * config_snapshot::reader, which reads the singleton on first use and answers every later lookup of the
+ * action from that copy. Hot loops ask for a slot, config_get style helpers pass the parameter name.
+ *
+ * Slots are only ever appended, so a contract built against a shorter list keeps reading the slots it
+ * knows. A parameter without a slot, or one the snapshot does not have yet, is read from the config tables.
+ */
+namespace config_snapshot {
+
+  enum param : uint8_t {
+    batchsize,
+    rank_budget,
+    hrvst_payout,
+    hrvst_users,
+    hrvst_rgns,
+    hrvst_orgs,
+    hrvst_global,
+    qev_trx_cap,
+    i_trx_max,
+    org_trx_max,
+    htry_trx_max,
+    propmajority,
+    propdecaysec,
+    vdecayprntge,
+    propminstake,
+    propcyclesec,
+    prop_cmp_cap,
+    prop_al_cap,
+    decaytime,
+    param_count
+  };
+
+  constexpr name params[param_count] = {
+    "batchsize"_n,
+    "rank.budget"_n,
+    "hrvst.payout"_n,
+    "hrvst.users"_n,
+    "hrvst.rgns"_n,
+    "hrvst.orgs"_n,
+    "hrvst.global"_n,
+    "qev.trx.cap"_n,
+    "i.trx.max"_n,
+    "org.trx.max"_n,
+    "htry.trx.max"_n,
+    "propmajority"_n,
+    "propdecaysec"_n,
+    "vdecayprntge"_n,
+    "propminstake"_n,
+    "propcyclesec"_n,
+    "prop.cmp.cap"_n,
+    "prop.al.cap"_n,
+    "decaytime"_n
+  };
+
+  enum float_param : uint8_t {
+    cyctrx_trail,
+    regen_mul,
+    local_mul,
+    float_param_count
+  };
+
+  constexpr name float_params[float_param_count] = {
+    "cyctrx.trail"_n,
+    "regen.mul"_n,
+    "local.mul"_n
+  };
+
+  static_assert(param_count <= 64 && float_param_count <= 64, "a snapshot tracks at most 64 slots of each kind");
+
+  const int no_slot = -1;
+
+  template<size_t N>
+  constexpr int slot_of(const name (&slots)[N], name key) {
+    for (size_t i = 0; i < N; i++) {
+      if (slots[i] == key) return int(i);
+    }
+    return no_slot;
+  }
+
+  // The confsnap row as the reader keeps it. The table itself is only defined where it is read or written,
+  // so that it stays out of the ABI of the contracts that include this header.
+  struct snapshot {
+    uint64_t version;
+    std::vector<uint64_t> values;
+    std::vector<double> float_values;
+    uint64_t present;
+    uint64_t float_present;
+  };
+
+  // Called by settings after it wrote param, copies the value into the parameter's slot if it has one.
+  inline void update(name settings, name param, uint64_t value) {
+    int slot = slot_of(params, param);
+    if (slot == no_slot) return;
+
+    DEFINE_CONFIG_SNAPSHOT_TABLE
+    DEFINE_CONFIG_SNAPSHOT_SINGLETON
+    config_snapshot_tables snap(settings, settings.value);
+
+    config_snapshot_table s = snap.get_or_default(config_snapshot_table{ 0, {}, {}, 0, 0 });
+    if (s.values.size() < param_count) s.values.resize(param_count, 0);
+    s.values[slot] = value;
+    s.present |= uint64_t(1) << slot;
+    s.version += 1;
+    snap.set(s, settings);
+  }
+
+  inline void update_float(name settings, name param, double value) {
+    int slot = slot_of(float_params, param);
+    if (slot == no_slot) return;
+
+    DEFINE_CONFIG_SNAPSHOT_TABLE
+    DEFINE_CONFIG_SNAPSHOT_SINGLETON
+    config_snapshot_tables snap(settings, settings.value);
+
+    config_snapshot_table s = snap.get_or_default(config_snapshot_table{ 0, {}, {}, 0, 0 });
+    if (s.float_values.size() < float_param_count) s.float_values.resize(float_param_count, 0);
+    s.float_values[slot] = value;
+    s.float_present |= uint64_t(1) << slot;
+    s.version += 1;
+    snap.set(s, settings);
+  }
+
+  class reader {
+    public:
+      uint64_t get(param p) {
+        load();
+        if (p < s.values.size() && (s.present >> p) & 1) return s.values[p];
+        return from_table(params[p]);
+      }
+
+      double get(float_param p) {
+        load();
+        if (p < s.float_values.size() && (s.float_present >> p) & 1) return s.float_values[p];
+        return from_float_table(float_params[p]);
+      }
+
+      uint64_t get(name key) {
+        int slot = slot_of(params, key);
+        return slot == no_slot ? from_table(key) : get(param(slot));
+      }
+
+      // For parameters added after launch: fallback while the parameter has not been configured.
+      uint64_t get_or(param p, uint64_t fallback) {
+        load();
+        if (p < s.values.size() && (s.present >> p) & 1) return s.values[p];
+        uint64_t value = fallback;
+        find_in_table(params[p], value);
+        return value;
+      }
+
+      double get_float(name key) {
+        int slot = slot_of(float_params, key);
+        return slot == no_slot ? from_float_table(key) : get(float_param(slot));
+      }
+
+    private:
+      bool loaded = false;
+      snapshot s{ 0, {}, {}, 0, 0 };
+
+      void load() {
+        if (loaded) return;
+        DEFINE_CONFIG_SNAPSHOT_TABLE
+        DEFINE_CONFIG_SNAPSHOT_SINGLETON
+        config_snapshot_tables snap(contracts::settings, contracts::settings.value);
+
+        if (snap.exists()) {
+          config_snapshot_table row = snap.get();
+          s = snapshot{ row.version, row.values, row.float_values, row.present, row.float_present };
+        }
+        instrument::read();
+        loaded = true;
+      }
+
+      bool find_in_table(name key, uint64_t & value) {
+        DEFINE_CONFIG_TABLE
+        DEFINE_CONFIG_TABLE_MULTI_INDEX
+        config_tables config(contracts::settings, contracts::settings.value);
+
+        auto citr = config.find(key.value);
+        instrument::read();
+        if (citr == config.end()) return false;
+        value = citr->value;
+        return true;
+      }
+
+      uint64_t from_table(name key) {
+        uint64_t value = 0;
+        if (!find_in_table(key, value)) {
+          // only create the error message string in error case for efficiency
+          check(false, ("settings: the "+key.to_string()+" parameter has not been initialized").c_str());
+        }
+        return value;
+      }
+
+      double from_float_table(name key) {
+        DEFINE_CONFIG_FLOAT_TABLE
+        DEFINE_CONFIG_FLOAT_TABLE_MULTI_INDEX
+        config_float_tables configfloat(contracts::settings, contracts::settings.value);
+
+        auto citr = configfloat.find(key.value);
+        instrument::read();
+        if (citr == configfloat.end()) {
+          check(false, ("settings: the "+key.to_string()+" parameter has not been initialized").c_str());
+        }
+        return citr->value;
+      }
+  };
+
+}
@@ -5,34 +5,34 @@
 using eosio::name;
 
 namespace contracts {
-  name accounts = "accts.seeds"_n;
-  name harvest = "harvst.seeds"_n;
-  name settings = "settgs.seeds"_n;
-  name proposals = "funds.seeds"_n;
-  name referendums = "rules.seeds"_n;
-  name history = "histry.seeds"_n;
-  name token = "token.seeds"_n;
-  name tlostoken = "eosio.token"_n;
-  name policy = "policy.seeds"_n;
-  name bank = "system.seeds"_n;
-  name onboarding = "join.seeds"_n;
-  name acctcreator = "free.seeds"_n;
-  name forum = "forum.seeds"_n;
-  name scheduler = "cycle.seeds"_n;
-  name organization = "orgs.seeds"_n;
-  name exchange = "tlosto.seeds"_n;
-  name escrow = "escrow.seeds"_n;
-  name region = "region.seeds"_n;
-  name gratitude = "gratz.seeds"_n;
-  name pouch = "pouch.seeds"_n;
+  inline name accounts = "accts.seeds"_n;
+  inline name harvest = "harvst.seeds"_n;
+  inline name settings = "settgs.seeds"_n;
+  inline name proposals = "funds.seeds"_n;
+  inline name referendums = "rules.seeds"_n;
+  inline name history = "histry.seeds"_n;
+  inline name token = "token.seeds"_n;
+  inline name tlostoken = "eosio.token"_n;
+  inline name policy = "policy.seeds"_n;
+  inline name bank = "system.seeds"_n;
+  inline name onboarding = "join.seeds"_n;
+  inline name acctcreator = "free.seeds"_n;
+  inline name forum = "forum.seeds"_n;
+  inline name scheduler = "cycle.seeds"_n;
+  inline name organization = "orgs.seeds"_n;
+  inline name exchange = "tlosto.seeds"_n;
+  inline name escrow = "escrow.seeds"_n;
+  inline name region = "region.seeds"_n;
+  inline name gratitude = "gratz.seeds"_n;
+  inline name pouch = "pouch.seeds"_n;
 }
 namespace bankaccts {
-  name milestone = "milest.seeds"_n;
-  name alliances = "allies.seeds"_n;
-  name campaigns = "gift.seeds"_n;
-  name referrals = "refer.seeds"_n;
+  inline name milestone = "milest.seeds"_n;
+  inline name alliances = "allies.seeds"_n;
+  inline name campaigns = "gift.seeds"_n;
+  inline name referrals = "refer.seeds"_n;
 
-  name hyphabank = "seeds.hypha"_n;
+  inline name hyphabank = "seeds.hypha"_n;
 
-  name globaldho = "gdho.seeds"_n;
+  inline name globaldho = "gdho.seeds"_n;
 }
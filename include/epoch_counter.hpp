@@ -0,0 +1,70 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <eosio/system.hpp>
+#include <instrument.hpp>
+
+using namespace eosio;
+
+/**
+ * Counter tables that are reset by starting a new epoch instead of rewriting every row.
+ *
+ * A counter row carries an eosio::binary_extension<uint64_t> epoch, the epoch it was last written in, and
+ * the contract's epochs table holds the current epoch of each counter table. A row from an older epoch
+ * holds last period's counts: readers treat it as zero and writers reset it in place with renew() before
+ * counting. Resetting the whole table is then advance(), a single row write. Rows written before the
+ * table had an epoch read as epoch 0, the epoch every counter starts in.
+ */
+namespace epoch_counter {
+
+  template<typename Epochs>
+  uint64_t current(Epochs & epochs, name counter) {
+    auto eitr = epochs.find(counter.value);
+    instrument::read();
+    return eitr != epochs.end() ? eitr->epoch : 0;
+  }
+
+  // Starts a new epoch for counter, every row written before reads as zero from now on.
+  template<typename Epochs>
+  uint64_t advance(Epochs & epochs, name counter, name payer) {
+    uint64_t now = eosio::current_time_point().sec_since_epoch();
+
+    auto eitr = epochs.find(counter.value);
+    if (eitr == epochs.end()) {
+      epochs.emplace(payer, [&](auto & item) {
+        item.counter = counter;
+        item.epoch = 1;
+        item.started_at = now;
+      });
+      instrument::emplaced();
+      return 1;
+    }
+
+    epochs.modify(eitr, payer, [&](auto & item) {
+      item.epoch += 1;
+      item.started_at = now;
+    });
+    instrument::modified();
+    return eitr->epoch;
+  }
+
+  template<typename Row>
+  uint64_t epoch_of(const Row & row) {
+    return row.epoch.has_value() ? row.epoch.value() : 0;
+  }
+
+  template<typename Row>
+  bool fresh(const Row & row, uint64_t epoch) {
+    return epoch_of(row) == epoch;
+  }
+
+  // For use inside a modify: resets a row left from an older epoch and tags it with the current one.
+  template<typename Row, typename Reset>
+  void renew(Row & row, uint64_t epoch, Reset reset) {
+    if (!fresh(row, epoch)) {
+      reset(row);
+    }
+    row.epoch = epoch;
+  }
+
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <contracts.hpp>
+#include <tables/config_table.hpp>
+#include <tables/action_stats_table.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace eosio;
+using std::string;
+
+/**
+ * Opt-in resource counters for scheduled and chunked actions.
+ *
+ * An instrumented action calls instrument::begin(action) first and instrument::end(get_self()) last. In
+ * between, the action and the shared helpers it uses (ranking, rank_tree) report the rows they touch and
+ * the actions they send. Every action runs in a fresh contract instance, so the counters only ever hold
+ * one invocation. Helpers count whether or not their caller is instrumented, begin() starts from zero.
+ *
+ * Unless the instr.on config is 1, end() costs one config read and writes nothing. When it is on, the
+ * counters are added to the action's row in the contract's actstats table, which keeps the last
+ * ring_size calls for the p50/p99 figures. Reads count every row landed on and writes every row emplaced,
+ * modified or erased, the way the chain bills them. The chain clock does not move within a transaction,
+ * so elapsed_ms is the time since the previous call of the same action: for a chunked job, the time
+ * between its transactions.
+ */
+namespace instrument {
+
+  const uint32_t ring_size = 64;
+
+  struct counters {
+    name action;
+    uint64_t rows_read = 0;
+    uint64_t rows_modified = 0;
+    uint64_t rows_emplaced = 0;
+    uint64_t rows_erased = 0;
+    uint64_t inline_sent = 0;
+    uint64_t deferred_sent = 0;
+  };
+
+  inline counters current;
+
+  inline void begin(name action) {
+    current = counters();
+    current.action = action;
+  }
+
+  inline void read(uint64_t rows = 1) { current.rows_read += rows; }
+  inline void modified(uint64_t rows = 1) { current.rows_modified += rows; }
+  inline void emplaced(uint64_t rows = 1) { current.rows_emplaced += rows; }
+  inline void erased(uint64_t rows = 1) { current.rows_erased += rows; }
+  inline void sent_inline(uint64_t actions = 1) { current.inline_sent += actions; }
+  inline void sent_deferred(uint64_t transactions = 1) { current.deferred_sent += transactions; }
+
+  inline uint32_t clamp(uint64_t value) {
+    return uint32_t(std::min(value, uint64_t(UINT32_MAX)));
+  }
+
+  inline uint32_t percentile(std::vector<uint32_t> samples, uint64_t p) {
+    if (samples.empty()) return 0;
+    size_t k = (samples.size() - 1) * p / 100;
+    std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+  }
+
+  inline bool enabled() {
+    DEFINE_CONFIG_TABLE
+    DEFINE_CONFIG_TABLE_MULTI_INDEX
+
+    config_tables config(contracts::settings, contracts::settings.value);
+    auto citr = config.find(name("instr.on").value);
+    return citr != config.end() && citr->value == 1;
+  }
+
+  inline void end(name contract) {
+    if (current.action == name() || !enabled()) return;
+
+    DEFINE_ACTION_STATS_TABLE
+    DEFINE_ACTION_STATS_TABLE_MULTI_INDEX
+
+    action_stats_tables stats(contract, contract.value);
+
+    uint64_t now = eosio::current_time_point().time_since_epoch().count();
+    uint64_t writes = current.rows_modified + current.rows_emplaced + current.rows_erased;
+    uint64_t sent = current.inline_sent + current.deferred_sent;
+
+    auto record = [&](auto & item) {
+      item.action = current.action;
+      item.calls += 1;
+      item.rows_read += current.rows_read;
+      item.rows_modified += current.rows_modified;
+      item.rows_emplaced += current.rows_emplaced;
+      item.rows_erased += current.rows_erased;
+      item.inline_sent += current.inline_sent;
+      item.deferred_sent += current.deferred_sent;
+
+      uint32_t elapsed = item.last_at > 0 && now > item.last_at ? clamp((now - item.last_at) / 1000) : 0;
+      item.last_at = now;
+
+      if (item.reads.size() < ring_size) {
+        item.reads.push_back(clamp(current.rows_read));
+        item.writes.push_back(clamp(writes));
+        item.sent.push_back(clamp(sent));
+        item.elapsed_ms.push_back(elapsed);
+      } else {
+        item.reads[item.next] = clamp(current.rows_read);
+        item.writes[item.next] = clamp(writes);
+        item.sent[item.next] = clamp(sent);
+        item.elapsed_ms[item.next] = elapsed;
+      }
+      item.next = (item.next + 1) % ring_size;
+
+      item.p50_reads = percentile(item.reads, 50);
+      item.p99_reads = percentile(item.reads, 99);
+      item.p50_writes = percentile(item.writes, 50);
+      item.p99_writes = percentile(item.writes, 99);
+      item.p50_elapsed_ms = percentile(item.elapsed_ms, 50);
+      item.p99_elapsed_ms = percentile(item.elapsed_ms, 99);
+    };
+
+    auto sitr = stats.find(current.action.value);
+    if (sitr == stats.end()) {
+      stats.emplace(contract, [&](auto & item) {
+        item.calls = 0;
+        item.rows_read = 0;
+        item.rows_modified = 0;
+        item.rows_emplaced = 0;
+        item.rows_erased = 0;
+        item.inline_sent = 0;
+        item.deferred_sent = 0;
+        item.last_at = 0;
+        item.next = 0;
+        record(item);
+      });
+    } else {
+      stats.modify(sitr, contract, record);
+    }
+
+    current.action = name();
+  }
+
+  inline void clear(name contract) {
+    DEFINE_ACTION_STATS_TABLE
+    DEFINE_ACTION_STATS_TABLE_MULTI_INDEX
+
+    action_stats_tables stats(contract, contract.value);
+    auto sitr = stats.begin();
+    while (sitr != stats.end()) {
+      sitr = stats.erase(sitr);
+    }
+  }
+
+}
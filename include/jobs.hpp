@@ -0,0 +1,128 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <contracts.hpp>
+#include <tables/job_state_table.hpp>
+#include <instrument.hpp>
+
+using namespace eosio;
+
+/**
+ * State and completion reporting for jobs that run over several transactions.
+ *
+ * A job is named after the action that starts a pass, which is also the operation the scheduler calls.
+ * The pass calls jobs::start(get_self(), job) when it begins, jobs::chunk(get_self(), job, rows) from every
+ * transaction and jobs::finish(get_self(), job) from the last one. The contract's jobstate table then holds
+ * when the pass started and finished, how many transactions and rows it took, and whether it is running.
+ *
+ * finish() also tells the scheduler the operation is done, so operations that depend on it start in the
+ * next tick instead of after a fixed offset.
+ */
+namespace jobs {
+
+  const name status_running = "running"_n;
+  const name status_done = "done"_n;
+
+  // Tells the scheduler that operation has finished. Scheduled ops that do not signal ignore it.
+  inline void done(name contract, name operation) {
+    if (!is_account(contracts::scheduler)) {
+      return;
+    }
+
+    action(
+      permission_level{contract, "active"_n},
+      contracts::scheduler,
+      "opdone"_n,
+      std::make_tuple(contract, operation)
+    ).send();
+    instrument::sent_inline();
+  }
+
+  template<typename T>
+  void begin_pass(T & item, name job) {
+    item.job = job;
+    item.status = status_running;
+    item.started_at = eosio::current_time_point().sec_since_epoch();
+    item.finished_at = 0;
+    item.chunks = 0;
+    item.rows = 0;
+  }
+
+  // Starts a new pass, discarding the counters of the previous one.
+  inline void start(name contract, name job) {
+    DEFINE_JOB_STATE_TABLE
+    DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
+    job_state_tables jobstate(contract, contract.value);
+
+    auto jitr = jobstate.find(job.value);
+    instrument::read();
+    if (jitr == jobstate.end()) {
+      jobstate.emplace(contract, [&](auto & item) { begin_pass(item, job); });
+      instrument::emplaced();
+    } else {
+      jobstate.modify(jitr, contract, [&](auto & item) { begin_pass(item, job); });
+      instrument::modified();
+    }
+  }
+
+  // Counts one transaction of the pass. A chunk arriving after the last pass finished starts a new one.
+  inline void chunk(name contract, name job, uint64_t rows) {
+    DEFINE_JOB_STATE_TABLE
+    DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
+    job_state_tables jobstate(contract, contract.value);
+
+    auto count = [&](auto & item) {
+      item.chunks += 1;
+      item.rows += rows;
+    };
+
+    auto jitr = jobstate.find(job.value);
+    instrument::read();
+    if (jitr == jobstate.end()) {
+      jobstate.emplace(contract, [&](auto & item) {
+        begin_pass(item, job);
+        count(item);
+      });
+      instrument::emplaced();
+    } else {
+      jobstate.modify(jitr, contract, [&](auto & item) {
+        if (item.status != status_running) begin_pass(item, job);
+        count(item);
+      });
+      instrument::modified();
+    }
+  }
+
+  inline void finish(name contract, name job) {
+    DEFINE_JOB_STATE_TABLE
+    DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
+    job_state_tables jobstate(contract, contract.value);
+
+    auto jitr = jobstate.find(job.value);
+    instrument::read();
+    if (jitr != jobstate.end() && jitr->status == status_running) {
+      jobstate.modify(jitr, contract, [&](auto & item) {
+        item.status = status_done;
+        item.finished_at = eosio::current_time_point().sec_since_epoch();
+      });
+      instrument::modified();
+    }
+
+    done(contract, job);
+  }
+
+  inline void clear(name contract) {
+    DEFINE_JOB_STATE_TABLE
+    DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
+    job_state_tables jobstate(contract, contract.value);
+    auto jitr = jobstate.begin();
+    while (jitr != jobstate.end()) {
+      jitr = jobstate.erase(jitr);
+    }
+  }
+
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <utils.hpp>
+#include <instrument.hpp>
+
+using namespace eosio;
+
+/**
+ * Order statistics over a ranked value, so a row's percentile rank can be worked out the moment its
+ * value changes instead of waiting for the next full pass over the table.
+ *
+ * Values are mapped to 16 bit buckets: values below 1024 get a bucket of their own, larger values
+ * keep their 10 most significant bits (0.2% resolution). Bucket counts are kept in a 16-ary tree of
+ * rank_tree_table rows, 4 levels deep, so adding, removing or ranking a value touches 4 rows no matter
+ * how many values are in the tree. A node row is erased as soon as all its counts are back to 0.
+ *
+ * A value's rank is utils::rank(values in lower buckets, values in the tree), so equal values, and
+ * values within 0.2% of each other above 1024, share a rank.
+ *
+ * A tree only follows its table once it has been filled. The state row, past the node ids, holds the
+ * key initranks has reached and whether it went through the whole table, and update() and erase() only
+ * touch the tree for rows initranks has already inserted. The rest keep the rank of the last full pass,
+ * and rows initranks has not reached yet go in with their current value when it gets there. reset marks
+ * the emptied tree as built.
+ */
+namespace rank_tree {
+
+  const uint64_t levels = 4;
+  const uint64_t fanout = 16;
+  const uint64_t mantissa_bits = 10;
+
+  inline uint64_t bucket(uint64_t value) {
+    if (value < (1 << mantissa_bits)) {
+      return value;
+    }
+    uint64_t exponent = 64 - __builtin_clzll(value) - mantissa_bits;
+    return (exponent << (mantissa_bits - 1)) + (value >> exponent);
+  }
+
+  inline uint64_t node_id(uint64_t level, uint64_t bucket) {
+    return (level << 16) + (bucket >> (16 - 4 * level));
+  }
+
+  inline uint64_t slot(uint64_t level, uint64_t bucket) {
+    return (bucket >> (12 - 4 * level)) & (fanout - 1);
+  }
+
+  // counts[0] is the next key initranks inserts, counts[1] is 1 once it has inserted every row
+  const uint64_t state_id = levels << 16;
+
+  template<typename Tree>
+  void set_state(Tree & tree, uint64_t next, bool built, name payer) {
+    auto sitr = tree.find(state_id);
+    instrument::read();
+    if (sitr == tree.end()) {
+      tree.emplace(payer, [&](auto & item) {
+        item.id = state_id;
+        item.counts = { next, built ? 1ULL : 0ULL };
+      });
+      instrument::emplaced();
+    } else {
+      tree.modify(sitr, payer, [&](auto & item) {
+        item.counts = { next, built ? 1ULL : 0ULL };
+      });
+      instrument::modified();
+    }
+  }
+
+  // Records that every row with a key below next is in the tree.
+  template<typename Tree>
+  void built_to(Tree & tree, uint64_t next, name payer) {
+    set_state(tree, next, false, payer);
+  }
+
+  // Records that every row of the table is in the tree.
+  template<typename Tree>
+  void built(Tree & tree, name payer) {
+    set_state(tree, 0, true, payer);
+  }
+
+  template<typename Tree>
+  bool ready(Tree & tree) {
+    auto sitr = tree.find(state_id);
+    instrument::read();
+    return sitr != tree.end() && sitr->counts[1] == 1;
+  }
+
+  // Whether the row with this key is in the tree, so its changes have to be applied to it.
+  template<typename Tree>
+  bool tracks(Tree & tree, uint64_t key) {
+    auto sitr = tree.find(state_id);
+    instrument::read();
+    return sitr != tree.end() && (sitr->counts[1] == 1 || key < sitr->counts[0]);
+  }
+
+  // Adds delta to the count of the value's bucket.
+  template<typename Tree>
+  void add(Tree & tree, uint64_t value, int64_t delta, name payer) {
+    if (delta == 0) return;
+
+    uint64_t b = bucket(value);
+
+    for (uint64_t level = 0; level < levels; level++) {
+      uint64_t id = node_id(level, b);
+      uint64_t s = slot(level, b);
+
+      auto nitr = tree.find(id);
+      instrument::read();
+      if (nitr == tree.end()) {
+        check(delta > 0, "rank_tree: removing a value that is not in the tree");
+        tree.emplace(payer, [&](auto & item) {
+          item.id = id;
+          item.counts.resize(fanout, 0);
+          item.counts[s] = delta;
+        });
+        instrument::emplaced();
+        continue;
+      }
+
+      check(delta > 0 || nitr->counts[s] >= uint64_t(-delta), "rank_tree: removing a value that is not in the tree");
+
+      bool empty = true;
+      for (uint64_t i = 0; i < fanout; i++) {
+        uint64_t count = i == s ? nitr->counts[i] + delta : nitr->counts[i];
+        if (count > 0) {
+          empty = false;
+          break;
+        }
+      }
+
+      if (empty) {
+        tree.erase(nitr);
+        instrument::erased();
+      } else {
+        tree.modify(nitr, payer, [&](auto & item) {
+          item.counts[s] += delta;
+        });
+        instrument::modified();
+      }
+    }
+  }
+
+  template<typename Tree>
+  void insert(Tree & tree, uint64_t value, name payer) {
+    add(tree, value, 1, payer);
+  }
+
+  template<typename Tree>
+  void remove(Tree & tree, uint64_t value, name payer) {
+    add(tree, value, -1, payer);
+  }
+
+  // Moves one value between buckets. Nothing is written when both values share a bucket.
+  template<typename Tree>
+  void move(Tree & tree, uint64_t from, uint64_t to, name payer) {
+    if (bucket(from) == bucket(to)) return;
+    remove(tree, from, payer);
+    insert(tree, to, payer);
+  }
+
+  template<typename Tree>
+  uint64_t total(Tree & tree) {
+    auto ritr = tree.find(node_id(0, 0));
+    instrument::read();
+    if (ritr == tree.end()) return 0;
+
+    uint64_t sum = 0;
+    for (auto count : ritr->counts) {
+      sum += count;
+    }
+    return sum;
+  }
+
+  // Number of values in buckets lower than the value's bucket.
+  template<typename Tree>
+  uint64_t count_below(Tree & tree, uint64_t value) {
+    uint64_t b = bucket(value);
+    uint64_t below = 0;
+
+    for (uint64_t level = 0; level < levels; level++) {
+      auto nitr = tree.find(node_id(level, b));
+      instrument::read();
+      if (nitr == tree.end()) break;
+
+      uint64_t s = slot(level, b);
+      for (uint64_t i = 0; i < s; i++) {
+        below += nitr->counts[i];
+      }
+    }
+
+    return below;
+  }
+
+  template<typename Tree>
+  uint64_t rank_of(Tree & tree, uint64_t value) {
+    uint64_t t = total(tree);
+    if (t == 0) return 0;
+    return utils::rank(count_below(tree, value), t);
+  }
+
+  // Puts the changed value of the row with this key into the tree, if the tree follows that row.
+  // `from` is the previous value, ignored when the row is new.
+  template<typename Tree>
+  bool change(Tree & tree, uint64_t key, bool existed, uint64_t from, uint64_t to, name payer) {
+    if (!tracks(tree, key)) return false;
+    if (existed) {
+      move(tree, from, to, payer);
+    } else {
+      insert(tree, to, payer);
+    }
+    return true;
+  }
+
+  // As change(), and returns the row's new rank. `current` is returned untouched until the tree is
+  // built, a partly filled tree has no meaningful ranks and the rank passes keep them up to date.
+  template<typename Tree>
+  uint64_t update(Tree & tree, uint64_t key, bool existed, uint64_t from, uint64_t to, uint64_t current, name payer) {
+    if (!change(tree, key, existed, from, to, payer) || !ready(tree)) return current;
+    return rank_of(tree, to);
+  }
+
+  // Takes an erased row's value out of the tree, if the tree follows that row.
+  template<typename Tree>
+  void erase(Tree & tree, uint64_t key, uint64_t value, name payer) {
+    if (tracks(tree, key)) {
+      remove(tree, value, payer);
+    }
+  }
+
+  template<typename Tree>
+  void clear(Tree & tree) {
+    auto nitr = tree.begin();
+    while (nitr != tree.end()) {
+      nitr = tree.erase(nitr);
+    }
+  }
+
+}
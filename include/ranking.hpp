@@ -0,0 +1,265 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <eosio/transaction.hpp>
+#include <utils.hpp>
+#include <instrument.hpp>
+#include <tables/rank_cursor_table.hpp>
+#include <tables/rank_shadow_table.hpp>
+
+using namespace eosio;
+
+/**
+ * Ranks any multi_index secondary index in ascending key order, writing utils::rank(position, total)
+ * into each row's `rank` field.
+ *
+ * A pass is split over as many transactions as needed. Each transaction spends at most `budget` work
+ * units and records where it stopped in a rank_cursor_table row named after the job, so the pass can
+ * be resumed by a deferred call to the same action. Rows whose rank does not change are not rewritten.
+ *
+ * Typical use from an action that owns the ranked table:
+ *
+ *   if (!ranking::running(cursors, job)) ranking::start(cursors, job, total, get_self());
+ *   if (!ranking::step(cursors, job, index, budget, get_self())) {
+ *     ranking::schedule(get_self(), "thisaction"_n, ranking::sender_id(job, scope), budget, scope);
+ *   }
+ *
+ * Every pass is a generation. Before a pass changes a row's rank, the rank readers currently see is kept
+ * in a rank_shadow_table row tagged with the pass. The last call of the pass publishes it by setting the
+ * cursor's published generation, so readers going through ranking::published see either all the ranks
+ * of a pass or none of them. Shadows of published passes are erased by the next pass.
+ */
+namespace ranking {
+
+  // Work units charged against the per transaction budget. Reading the next row of a secondary
+  // index is the unit; rewriting a row also rewrites its secondary index entries.
+  const uint64_t read_cost = 1;
+  const uint64_t write_cost = 4;
+
+  inline uint128_t sender_id(name job, name scope) {
+    return (uint128_t(job.value) << 64) + scope.value;
+  }
+
+  // Ranked tables of several jobs share a scope, and a job ranks tables in several scopes.
+  inline name shadow_scope(name job, name scope) {
+    return name(job.value ^ scope.value);
+  }
+
+  template<typename Cursors>
+  bool running(Cursors & cursors, name job) {
+    auto citr = cursors.find(job.value);
+    return citr != cursors.end() && citr->finished_at == 0;
+  }
+
+  // Rows ranked so far by the job's current pass.
+  template<typename Cursors>
+  uint64_t position(Cursors & cursors, name job) {
+    auto citr = cursors.find(job.value);
+    return citr == cursors.end() ? 0 : citr->current;
+  }
+
+  // Starts a new pass over `total` rows, discarding any pass of the same job still in progress.
+  template<typename Cursors>
+  void start(Cursors & cursors, name job, uint64_t total, name payer) {
+    uint64_t now = eosio::current_time_point().sec_since_epoch();
+
+    auto citr = cursors.find(job.value);
+    uint64_t generation = citr == cursors.end() ? 1 : citr->generation + 1;
+    uint64_t published = citr == cursors.end() ? 0 : citr->published;
+
+    auto reset = [&](auto & item) {
+      item.job = job;
+      item.key = 0;
+      item.pk = 0;
+      item.current = 0;
+      item.total = total;
+      item.sum_rank = 0;
+      item.chunks = 0;
+      item.started_at = now;
+      item.finished_at = 0;
+      item.generation = generation;
+      item.published = published;
+    };
+
+    if (citr == cursors.end()) {
+      cursors.emplace(payer, reset);
+    } else {
+      cursors.modify(citr, payer, reset);
+    }
+  }
+
+  // Ranks rows from the job's cursor until the budget is spent or the index is exhausted.
+  // At least one row is ranked per call so a pass always makes progress. on_rank(pk, rank) is called
+  // for every row whose rank changed.
+  // Returns true when the pass is complete, and published.
+  template<typename Cursors, typename Index, typename OnRank>
+  bool step(Cursors & cursors, name job, Index & index, uint64_t budget, name payer, OnRank on_rank) {
+    typedef typename Index::secondary_key_type key_type;
+
+    DEFINE_RANK_SHADOW_TABLE
+    DEFINE_RANK_SHADOW_TABLE_MULTI_INDEX
+
+    auto citr = cursors.find(job.value);
+    check(citr != cursors.end() && citr->finished_at == 0, "ranking: no pass in progress for " + job.to_string());
+
+    uint64_t total = citr->total;
+    uint64_t current = citr->current;
+    uint64_t sum_rank = citr->sum_rank;
+    uint64_t generation = citr->generation;
+    uint64_t published = citr->published;
+
+    rank_shadow_tables shadows(cursors.get_code(), shadow_scope(job, name(cursors.get_scope())).value);
+
+    uint64_t spent = 0;
+
+    // shadows of published passes are not read anymore, clear them with up to half the budget
+    auto shadows_by_generation = shadows.template get_index<"bygeneration"_n>();
+    auto sitr = shadows_by_generation.begin();
+    uint64_t purged = 0;
+    while (sitr != shadows_by_generation.end() && sitr->generation <= published && spent + read_cost + write_cost <= budget / 2) {
+      sitr = shadows_by_generation.erase(sitr);
+      spent += read_cost + write_cost;
+      purged++;
+    }
+
+    key_type key = key_type(citr->key);
+    auto itr = index.lower_bound(key);
+    while (itr != index.end() && Index::extract_secondary_key(*itr) == key && itr->primary_key() < citr->pk) {
+      itr++;
+    }
+
+    uint64_t rewritten = 0;
+    uint64_t shadowed = 0;
+
+    while (total > 0 && itr != index.end() && (current == citr->current || spent + read_cost + 2 * write_cost <= budget)) {
+      uint64_t rank = utils::rank(current, total);
+      spent += read_cost;
+
+      if (itr->rank != rank) {
+        // a shadow left by an unpublished pass already holds the rank readers see
+        auto shitr = shadows.find(itr->primary_key());
+        if (shitr == shadows.end()) {
+          shadows.emplace(payer, [&](auto & item) {
+            item.pk = itr->primary_key();
+            item.rank = itr->rank;
+            item.generation = generation;
+          });
+          shadowed++;
+        } else if (shitr->generation <= published) {
+          shadows.modify(shitr, payer, [&](auto & item) {
+            item.rank = itr->rank;
+            item.generation = generation;
+          });
+          shadowed++;
+        } else if (shitr->generation != generation) {
+          shadows.modify(shitr, payer, [&](auto & item) {
+            item.generation = generation;
+          });
+          shadowed++;
+        }
+
+        index.modify(itr, payer, [&](auto & item) {
+          item.rank = rank;
+        });
+        spent += 2 * write_cost;
+        rewritten++;
+        on_rank(itr->primary_key(), rank);
+      }
+
+      sum_rank += rank;
+      current++;
+      itr++;
+    }
+
+    bool done = total == 0 || itr == index.end();
+
+    instrument::read(current - citr->current + rewritten + purged + 1);
+    instrument::modified(rewritten + shadowed + 1);
+    instrument::erased(purged);
+
+    cursors.modify(citr, payer, [&](auto & item) {
+      if (!done) {
+        item.key = uint128_t(Index::extract_secondary_key(*itr));
+        item.pk = itr->primary_key();
+      } else {
+        item.finished_at = eosio::current_time_point().sec_since_epoch();
+        item.published = generation;
+      }
+      item.current = current;
+      item.sum_rank = sum_rank;
+      item.chunks += 1;
+    });
+
+    return done;
+  }
+
+  template<typename Cursors, typename Index>
+  bool step(Cursors & cursors, name job, Index & index, uint64_t budget, name payer) {
+    return step(cursors, job, index, budget, payer, [](uint64_t, uint64_t) {});
+  }
+
+  // Erases the shadows of a job, for resets that also erase its cursor.
+  inline void clear_shadows(name contract, name job, name scope) {
+    DEFINE_RANK_SHADOW_TABLE
+    DEFINE_RANK_SHADOW_TABLE_MULTI_INDEX
+
+    rank_shadow_tables shadows(contract, shadow_scope(job, scope).value);
+    auto sitr = shadows.begin();
+    while (sitr != shadows.end()) {
+      sitr = shadows.erase(sitr);
+    }
+  }
+
+  // Ranks of a job's table as of its last published pass. Reads the cursor once, and only looks up
+  // shadows while a pass is unpublished.
+  class published {
+    public:
+      published(name contract, name job, name scope)
+      : shadows(contract, shadow_scope(job, scope).value)
+      {
+        rank_cursor_tables cursors(contract, scope.value);
+        auto citr = cursors.find(job.value);
+        instrument::read();
+        if (citr != cursors.end()) {
+          generation = citr->published;
+          pending = citr->generation != citr->published;
+        }
+      }
+
+      uint64_t rank(uint64_t pk, uint64_t live_rank) {
+        if (!pending) return live_rank;
+        auto sitr = shadows.find(pk);
+        instrument::read();
+        return sitr != shadows.end() && sitr->generation > generation ? sitr->rank : live_rank;
+      }
+
+    private:
+      DEFINE_RANK_CURSOR_TABLE
+      DEFINE_RANK_CURSOR_TABLE_MULTI_INDEX
+      DEFINE_RANK_SHADOW_TABLE
+      DEFINE_RANK_SHADOW_TABLE_MULTI_INDEX
+
+      rank_shadow_tables shadows;
+      uint64_t generation = 0;
+      bool pending = false;
+  };
+
+  // Queues the next transaction of a pass. Using a fixed sender id per job and scope means a
+  // restarted pass replaces the continuation of the old one instead of running alongside it.
+  template<typename... Args>
+  void schedule(name contract, name action_name, uint128_t id, Args... args) {
+    action next_execution(
+      permission_level{contract, "active"_n},
+      contract,
+      action_name,
+      std::make_tuple(args...)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 0;
+    tx.send(id, contract, true);
+    instrument::sent_deferred();
+  }
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <contracts.hpp>
+#include <instrument.hpp>
+
+#include <vector>
+
+using namespace eosio;
+
+/**
+ * Keeps harvest's scorevector table, one row per account with everything calc_contribution_score needs:
+ * the planted, transaction, reputation and community building ranks and the account's region.
+ *
+ * Those live in five tables across harvest, accounts and region. Harvest writes its own ranks into the
+ * vector directly. accounts and region call send() right after writing a rank or a membership, and a
+ * ranking pass collects the ranks it changed and sends them once per transaction. Erasing a ranked row
+ * sends rank 0, the same value calc_contribution_score used for a missing row.
+ */
+namespace score_vector {
+
+  const name planted = "planted"_n;
+  const name tx = "tx"_n;
+  const name rep = "rep"_n;
+  const name cbs = "cbs"_n;
+
+  struct rank_update {
+    name account;
+    uint64_t rank;
+  };
+
+  inline void send(name field, const std::vector<rank_update> & updates) {
+    if (updates.empty() || !is_account(contracts::harvest)) {
+      return;
+    }
+
+    action(
+      permission_level{contracts::harvest, "active"_n},
+      contracts::harvest,
+      "setranks"_n,
+      std::make_tuple(field, updates)
+    ).send();
+    instrument::sent_inline();
+  }
+
+  inline void send(name field, name account, uint64_t rank) {
+    send(field, std::vector<rank_update>{ rank_update{ account, rank } });
+  }
+
+  inline void send_region(name account, name region) {
+    if (!is_account(contracts::harvest)) {
+      return;
+    }
+
+    action(
+      permission_level{contracts::harvest, "active"_n},
+      contracts::harvest,
+      "setregion"_n,
+      std::make_tuple(account, region)
+    ).send();
+  }
+
+}
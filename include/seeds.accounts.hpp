@@ -6,9 +6,22 @@
 #include <tables/size_table.hpp>
 #include <tables/cbs_table.hpp>
 #include <tables/user_table.hpp>
+#include <tables/user_core_table.hpp>
 #include <tables/config_table.hpp>
 #include <tables/config_float_table.hpp>
+#include <tables/rank_cursor_table.hpp>
+#include <tables/rank_shadow_table.hpp>
+#include <tables/rank_tree_table.hpp>
+#include <tables/action_stats_table.hpp>
+#include <tables/job_state_table.hpp>
+#include <tables/referral_stats_table.hpp>
 #include <utils.hpp>
+#include <ranking.hpp>
+#include <rank_tree.hpp>
+#include <score_vector.hpp>
+#include <transfer_profile.hpp>
+#include <instrument.hpp>
+#include <jobs.hpp>
 
 using namespace eosio;
 using std::string;
@@ -19,7 +32,10 @@ CONTRACT accounts : public contract {
       accounts(name receiver, name code, datastream<const char*> ds)
         : contract(receiver, code, ds),
           users(receiver, receiver.value),
+          usercore(receiver, receiver.value),
           refs(receiver, receiver.value),
+          refstats(receiver, receiver.value),
+          refstatsst(receiver, receiver.value),
           cbs(receiver, receiver.value),
           vouches(receiver, receiver.value),
           vouchtotals(receiver, receiver.value),
@@ -65,11 +81,13 @@ CONTRACT accounts : public contract {
 
       ACTION rankreps();
       ACTION rankorgreps();
-      ACTION rankrep(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name scope);
+      ACTION rankrep(uint64_t budget, name scope);
+
+      ACTION setprofile(name field, name account, uint64_t value);
 
       ACTION rankcbss();
       ACTION rankorgcbss();
-      ACTION rankcbs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name scope);
+      ACTION rankcbs(uint64_t budget, name scope);
 
       ACTION changesize(name id, int64_t delta);
 
@@ -77,7 +95,9 @@ CONTRACT accounts : public contract {
       ACTION removeflag(name from, name to);
       ACTION punish(name account, uint64_t points);
       ACTION pnshvouchers(name account, uint64_t points, uint64_t start);
-      ACTION evaldemote(name to, uint64_t start_val, uint64_t chunk, uint64_t chunksize);
+      ACTION evaldemote(name to);
+
+      ACTION rankof(name tree, name account);
 
       ACTION testresident(name user);
       ACTION testcitizen(name user);
@@ -95,6 +115,10 @@ CONTRACT accounts : public contract {
       ACTION delcbsreporg(uint64_t start_org);
       ACTION testmigscope(name account, uint64_t amount);
 
+      ACTION initranks(name tree, uint64_t start); // MIGRATION ACTION
+      ACTION initrefstats(uint64_t start); // MIGRATION ACTION
+      ACTION initcore(uint64_t start); // MIGRATION ACTION
+
   private:
       symbol seeds_symbol = symbol("SEEDS", 4);
       symbol network_symbol = symbol("TLOS", 4);
@@ -107,6 +131,11 @@ CONTRACT accounts : public contract {
 
       const name not_found = ""_n;
 
+      const name rep_tree = "rep"_n;
+      const name org_rep_tree = "org.rep"_n;
+      const name cbs_tree = "cbs"_n;
+      const name org_cbs_tree = "org.cbs"_n;
+
       const name reputation_reward_resident = "refrep1.ind"_n;
       const name reputation_reward_citizen = "refrep2.ind"_n;
 
@@ -154,6 +183,9 @@ CONTRACT accounts : public contract {
       void send_subrep(name user, uint64_t amount);
       void send_to_escrow(name fromfund, name recipient, asset quantity, string memo);
       uint64_t countrefs(name user, int check_num_residents);
+      void change_ref_stats(name referrer, name invited, name from_status, name to_status, int64_t referrals);
+      void update_ref_stats(name referrer, name from_status, name to_status, int64_t referrals);
+      void set_ref_stats_state(uint64_t next, bool built);
       uint64_t rep_score(name user);
       void add_rep_item(name account, uint64_t reputation, name scope);
       uint64_t config_get(name key);
@@ -169,7 +201,9 @@ CONTRACT accounts : public contract {
       void send_punish(name account, uint64_t points);
       void send_eval_demote(name to);
       void send_punish_vouchers(name account, uint64_t points);
-      void calc_vouch_rep(name account);
+      int64_t calc_vouch_rep(name account, int64_t vouch_delta);
+      void send_rep_change(name user, int64_t delta);
+      void send_rep_rank(name account, uint64_t rank);
       name get_scope(name type);
       void send_add_cbs_org(name user, uint64_t amount);
 
@@ -179,6 +213,14 @@ CONTRACT accounts : public contract {
 
       DEFINE_USER_TABLE_MULTI_INDEX
 
+      DEFINE_USER_CORE_TABLE
+
+      DEFINE_USER_CORE_TABLE_MULTI_INDEX
+
+      void set_user_core(const user_table & user);
+      void set_profile_rep_rank(name account, uint64_t rank);
+      void erase_user_core(name account);
+
       DEFINE_REP_TABLE
 
       DEFINE_REP_TABLE_MULTI_INDEX
@@ -187,10 +229,38 @@ CONTRACT accounts : public contract {
 
       DEFINE_SIZE_TABLE_MULTI_INDEX
 
+      DEFINE_RANK_CURSOR_TABLE
+
+      DEFINE_RANK_CURSOR_TABLE_MULTI_INDEX
+
+      DEFINE_RANK_SHADOW_TABLE
+
+      DEFINE_RANK_SHADOW_TABLE_MULTI_INDEX
+
+      DEFINE_RANK_TREE_TABLE
+
+      DEFINE_RANK_TREE_TABLE_MULTI_INDEX
+
       DEFINE_CBS_TABLE
 
       DEFINE_CBS_TABLE_MULTI_INDEX
 
+      DEFINE_ACTION_STATS_TABLE
+
+      DEFINE_ACTION_STATS_TABLE_MULTI_INDEX
+
+      DEFINE_JOB_STATE_TABLE
+
+      DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
+      DEFINE_REFERRAL_STATS_TABLE
+
+      DEFINE_REFERRAL_STATS_TABLE_MULTI_INDEX
+
+      DEFINE_REFERRAL_STATS_STATE_TABLE
+
+      DEFINE_REFERRAL_STATS_STATE_SINGLETON
+
       TABLE ref_table {
         name referrer;
         name invited;
@@ -319,6 +389,30 @@ CONTRACT accounts : public contract {
     > balance_tables;
     balance_tables balances;
 
+    // from the organization and region contracts, read when filling usercore
+    TABLE organization_table {
+      name org_name;
+      name owner;
+      uint64_t status;
+      int64_t regen;
+      uint64_t reputation;
+      uint64_t voice;
+      asset planted;
+
+      uint64_t primary_key() const { return org_name.value; }
+    };
+
+    TABLE members_table {
+      name region;
+      name account;
+      time_point joined_date = current_block_time().to_time_point();
+
+      uint64_t primary_key() const { return account.value; }
+    };
+
+    typedef eosio::multi_index<"organization"_n, organization_table> organization_tables;
+    typedef eosio::multi_index<"members"_n, members_table> members_tables;
+
     struct [[eosio::table]] account {
       asset    balance;
 
@@ -329,10 +423,13 @@ CONTRACT accounts : public contract {
 
     cbs_tables cbs;
     ref_tables refs;
+    referral_stats_tables refstats;
+    referral_stats_state_tables refstatsst;
     vouches_tables vouches;
     vouches_totals_tables vouchtotals;
     req_vouch_tables reqvouch;
     user_tables users;
+    user_core_tables usercore;
     rep_tables rep;
     size_tables sizes;
 
@@ -372,8 +469,8 @@ CONTRACT accounts : public contract {
 EOSIO_DISPATCH(accounts, (reset)(adduser)(canresident)(makeresident)(cancitizen)(makecitizen)(update)(addref)(invitevouch)(addrep)(changesize)
 (subrep)(testsetrep)(testsetrs)(testcitizen)(testresident)(testvisitor)(testremove)(testsetcbs)
 (testreward)(requestvouch)(vouch)(unvouch)(pnishvouched)
-(rankreps)(rankorgreps)(rankrep)(rankcbss)(rankorgcbss)(rankcbs)
-(flag)(removeflag)(punish)(pnshvouchers)(evaldemote)
+(rankreps)(rankorgreps)(rankrep)(rankcbss)(rankorgcbss)(rankcbs)(setprofile)
+(flag)(removeflag)(punish)(pnshvouchers)(evaldemote)(rankof)
 (testmvouch)(migratevouch)
-(migorgs)(delcbsreporg)(testmigscope)
+(migorgs)(delcbsreporg)(testmigscope)(initranks)(initrefstats)(initcore)
 );
@@ -5,6 +5,8 @@
 #include <contracts.hpp>
 #include <tables.hpp>
 #include <tables/price_history_table.hpp>
+#include <tables/epoch_table.hpp>
+#include <epoch_counter.hpp>
 
 using namespace eosio;
 using std::string;
@@ -21,7 +23,8 @@ CONTRACT exchange : public contract {
         rounds(receiver, receiver.value),
         dailystats(receiver, receiver.value),
         payhistory(receiver, receiver.value),
-        flags(receiver, receiver.value)
+        flags(receiver, receiver.value),
+        epochs(receiver, receiver.value)
         {}
       
     ACTION onperiod();
@@ -110,6 +113,7 @@ CONTRACT exchange : public contract {
     TABLE stattable {
       name buyer_account;
       uint64_t seeds_purchased;
+      eosio::binary_extension<uint64_t> epoch;
       
       uint64_t primary_key()const { return buyer_account.value; }
     };
@@ -151,6 +155,10 @@ CONTRACT exchange : public contract {
     typedef eosio::multi_index<"price"_n, price_table> dump_for_price;
     
     typedef multi_index<"dailystats"_n, stattable> stattables;
+
+    DEFINE_EPOCH_TABLE
+
+    DEFINE_EPOCH_TABLE_MULTI_INDEX
     
     typedef multi_index<"rounds"_n, round_table> round_tables;
 
@@ -174,6 +182,11 @@ CONTRACT exchange : public contract {
 
     flags_tables flags;
 
+    // dailystats rows from an older epoch were bought before the last onperiod
+    epoch_tables epochs;
+
+    const name dailystats_counter = "dailystats"_n;
+
 };
 
 extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
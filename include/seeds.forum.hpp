@@ -2,10 +2,18 @@
 #include <eosio/system.hpp>
 #include <contracts.hpp>
 #include <string>
-#include <tables/user_table.hpp>
+#include <tables/user_core_table.hpp>
+#include <user_core.hpp>
 #include <tables/config_table.hpp>
 #include <tables/size_table.hpp>
+#include <tables/rank_cursor_table.hpp>
+#include <tables/rank_shadow_table.hpp>
+#include <tables/job_state_table.hpp>
+#include <tables/epoch_table.hpp>
 #include <utils.hpp>
+#include <ranking.hpp>
+#include <jobs.hpp>
+#include <epoch_counter.hpp>
 
 using namespace eosio;
 using std::string;
@@ -19,10 +27,10 @@ CONTRACT forum : public contract {
               forumreps(receiver, receiver.value),
               actives(receiver, receiver.value),
               sizes(receiver, receiver.value),
-              users(contracts::accounts, contracts::accounts.value),
               config(contracts::settings, contracts::settings.value),
               votespower(receiver, receiver.value),
-              operations(contracts::scheduler, contracts::scheduler.value)
+              operations(contracts::scheduler, contracts::scheduler.value),
+              epochs(receiver, receiver.value)
               {}
         
         ACTION reset();
@@ -45,7 +53,7 @@ CONTRACT forum : public contract {
 
         ACTION rankforums();
 
-        ACTION rankforum(uint64_t start, uint64_t chunksize, uint64_t chunk);
+        ACTION rankforum(uint64_t budget);
 
         ACTION givereps();
 
@@ -104,19 +112,36 @@ CONTRACT forum : public contract {
 
         DEFINE_SIZE_TABLE_MULTI_INDEX
 
-        DEFINE_USER_TABLE
+        DEFINE_RANK_CURSOR_TABLE
 
-        DEFINE_USER_TABLE_MULTI_INDEX
+        DEFINE_RANK_CURSOR_TABLE_MULTI_INDEX
+
+        DEFINE_RANK_SHADOW_TABLE
+
+        DEFINE_RANK_SHADOW_TABLE_MULTI_INDEX
+
+        DEFINE_JOB_STATE_TABLE
+
+        DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
+        DEFINE_USER_CORE_TABLE
+
+        DEFINE_USER_CORE_TABLE_MULTI_INDEX
 
         TABLE vote_power_table {
             name account;
             uint32_t num_votes;
             int64_t points_left;
             int64_t max_points;
+            eosio::binary_extension<uint64_t> epoch;
 
             uint64_t primary_key() const { return account.value; }
         };
 
+        DEFINE_EPOCH_TABLE
+
+        DEFINE_EPOCH_TABLE_MULTI_INDEX
+
         DEFINE_CONFIG_TABLE
         
         DEFINE_CONFIG_TABLE_MULTI_INDEX
@@ -158,12 +183,15 @@ CONTRACT forum : public contract {
 
         postcomment_tables postcomments;
         forum_rep_tables forumreps;
-        user_tables users;
         vote_power_tables votespower;
         config_tables config;
         operations_tables operations;
         active_tables actives;
         size_tables sizes;
+
+        // votepower rows from an older epoch were spent before the last newday
+        epoch_tables epochs;
+        const name votepower_counter = "votepower"_n;
         
 
         // all these values are expected to be configured in settings
@@ -5,7 +5,8 @@
 #include <seeds.token.hpp>
 #include <contracts.hpp>
 #include <utils.hpp>
-#include <tables/user_table.hpp>
+#include <tables/user_core_table.hpp>
+#include <user_core.hpp>
 #include <tables/config_table.hpp>
 #include <tables/size_table.hpp>
 
@@ -23,7 +24,6 @@ CONTRACT gratitude : public contract {
         balances(receiver, receiver.value),
         stats(receiver, receiver.value),
         sizes(receiver, receiver.value),
-        users(contracts::accounts, contracts::accounts.value),
         config(contracts::settings, contracts::settings.value)
         {}
 
@@ -43,7 +43,6 @@ CONTRACT gratitude : public contract {
     void sub_gratitude(name account, asset quantity);
     uint64_t get_current_volume();
     void update_stats(name from, name to, asset quantity);
-    void _transfer(name beneficiary, asset quantity, string memo);
     uint64_t config_get(name key);
     void size_change(name id, int delta);
     void size_set(name id, uint64_t newsize);
@@ -55,9 +54,9 @@ CONTRACT gratitude : public contract {
       check(quantity.symbol == gratitude_symbol, "invalid asset");
     }
 
-    DEFINE_USER_TABLE
+    DEFINE_USER_CORE_TABLE
 
-    DEFINE_USER_TABLE_MULTI_INDEX
+    DEFINE_USER_CORE_TABLE_MULTI_INDEX
 
     DEFINE_CONFIG_TABLE
 
@@ -95,7 +94,6 @@ CONTRACT gratitude : public contract {
     stats_tables stats;
 
     // External tables
-    user_tables users;
     config_tables config;
     size_tables sizes;
 
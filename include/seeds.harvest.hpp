@@ -10,13 +10,30 @@
 #include <utils.hpp>
 #include <tables/rep_table.hpp>
 #include <tables/size_table.hpp>
-#include <tables/user_table.hpp>
+#include <tables/user_core_table.hpp>
+#include <user_core.hpp>
 #include <tables/config_table.hpp>
 #include <tables/config_float_table.hpp>
 #include <tables/cbs_table.hpp>
 #include <tables/cspoints_table.hpp>
+#include <tables/rank_cursor_table.hpp>
+#include <tables/rank_shadow_table.hpp>
+#include <tables/rank_tree_table.hpp>
+#include <tables/tx_window_table.hpp>
+#include <tables/qev_window_table.hpp>
+#include <tables/action_stats_table.hpp>
+#include <tables/job_state_table.hpp>
+#include <instrument.hpp>
+#include <jobs.hpp>
+#include <ranking.hpp>
+#include <rank_tree.hpp>
+#include <score_vector.hpp>
+#include <transfer_profile.hpp>
+#include <config_snapshot.hpp>
 #include <eosio/singleton.hpp>
 #include <cmath> 
+#include <map>
+#include <tuple>
 
 using namespace eosio;
 using namespace utils;
@@ -35,10 +52,10 @@ CONTRACT harvest : public contract {
         total(receiver, receiver.value),
         harveststat(receiver, receiver.value),
         monthlyqevs(receiver, receiver.value),
+        claimable(receiver, receiver.value),
         mintrate(receiver, receiver.value),
         regioncstemp(receiver, receiver.value),
-        config(contracts::settings, contracts::settings.value),
-        configfloat(contracts::settings, contracts::settings.value),
+        scores(receiver, receiver.value),
         users(contracts::accounts, contracts::accounts.value),
         rep(contracts::accounts, contracts::accounts.value),
         cbs(contracts::accounts, contracts::accounts.value),
@@ -62,14 +79,14 @@ CONTRACT harvest : public contract {
     ACTION runharvest();
 
     ACTION rankplanteds();
-    ACTION rankplanted(uint128_t start_val, uint64_t chunk, uint64_t chunksize);
+    ACTION rankplanted(uint64_t budget);
 
     ACTION calctrxpts(); // calculate transaction points // 24h interval
     ACTION calctrxpt(uint64_t start_val, uint64_t chunk, uint64_t chunksize);
 
     ACTION ranktxs(); // rank transaction score // 1h interval
     ACTION rankorgtxs(); // rank org transaction score
-    ACTION ranktx(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name table);
+    ACTION ranktx(uint64_t budget, name table);
 
     ACTION calccss(); // calculate contribution points // 1h inteval
     ACTION updatecs(name account); 
@@ -77,7 +94,7 @@ CONTRACT harvest : public contract {
 
     ACTION rankcss(); // rank contribution score //
     ACTION rankorgcss();
-    ACTION rankcs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name cs_scope);
+    ACTION rankcs(uint64_t budget, name cs_scope);
 
     ACTION rankrgncss();
     ACTION rankrgncs(uint64_t start, uint64_t chunk, uint64_t chunksize);
@@ -102,8 +119,20 @@ CONTRACT harvest : public contract {
 
     ACTION disthvstusrs(uint64_t start, uint64_t chunksize, asset total_amount);
     ACTION disthvstorgs(uint64_t start, uint64_t chunksize, asset total_amount);
+
+    ACTION claim(name account);
+    ACTION settle(uint64_t start);
     ACTION disthvstrgns(uint64_t start, uint64_t chunksize, asset total_amount);
 
+    ACTION rankof(name tree, name account);
+
+    ACTION initranks(name tree, uint64_t start); // MIGRATION ACTION
+    ACTION initscores(uint64_t start); // MIGRATION ACTION
+    ACTION initrgncs(uint64_t start); // MIGRATION ACTION
+
+    ACTION setranks(name field, std::vector<score_vector::rank_update> updates);
+    ACTION setregion(name account, name region);
+
     ACTION migorgs(uint64_t start);
     ACTION delcsorg(uint64_t start);
     ACTION testmigscope(name account, uint64_t amount);
@@ -123,6 +152,14 @@ CONTRACT harvest : public contract {
     name cs_rgn_size = "rgn.cs.sz"_n;
     name cs_org_size = "org.cs.sz"_n;
 
+    name planted_tree = "planted"_n;
+    name tx_points_tree = "txpt"_n;
+    name org_tx_points_tree = "org.txpt"_n;
+
+    const uint64_t payout_transfer = 0;
+    const uint64_t payout_claim = 1;
+    const uint64_t payout_settle = 2;
+
     const name individual_scope_accounts = contracts::accounts;
     const name individual_scope_harvest = get_self();
     const name organization_scope = "org"_n;
@@ -133,13 +170,18 @@ CONTRACT harvest : public contract {
     void check_asset(asset quantity);
     void _deposit(asset quantity);
     void _withdraw(name account, asset quantity);
+    void claim_legacy_refund(name from, uint64_t request_id);
+    void cancel_legacy_refund(name from, uint64_t request_id);
     uint32_t calc_transaction_points(name account, name type);
     double get_rep_multiplier(name account);
     void add_planted(name account, asset quantity);
     void sub_planted(name account, asset quantity);
     void change_total(bool add, asset quantity);
     void calc_contribution_score(name account, name type);
-    void add_cs_to_region(name account, uint32_t points);
+    uint64_t published_rank(name contract, name job, name scope, uint64_t pk, uint64_t live_rank);
+    void change_region_cs(name region, int64_t delta);
+    void set_score_rank(name field, name account, uint64_t rank);
+    void set_score_region(name account, name region);
 
     void size_change(name id, int delta);
     void size_set(name id, uint64_t newsize);
@@ -147,8 +189,11 @@ CONTRACT harvest : public contract {
 
     uint64_t config_get(name key);
     double config_float_get(name key);
+    uint64_t payout_mode();
     void send_distribute_harvest (name key, asset amount);
     void withdraw_aux(name sender, name beneficiary, asset quantity, string memo);
+    void pay_harvest(name account, asset quantity, uint64_t payout);
+    void send_settle();
 
     // Contract Tables
 
@@ -173,6 +218,27 @@ CONTRACT harvest : public contract {
       uint64_t primary_key()const { return refund_id; }
     };
 
+    // one row per unplant, paid out in equal weekly parts over weeks, the remainder with the last one
+    TABLE refund_schedule_table {
+      uint64_t request_id;
+      name account;
+      asset total;
+      asset claimed;
+      uint32_t weeks;
+      uint32_t request_time;
+
+      uint64_t primary_key()const { return request_id; }
+    };
+
+    TABLE claimable_table {
+      name account;
+      asset amount;
+
+      uint64_t primary_key()const { return account.value; }
+    };
+
+    typedef eosio::multi_index<"claimable"_n, claimable_table> claimable_tables;
+
     TABLE planted_table {
       name account;
       asset planted;
@@ -205,6 +271,20 @@ CONTRACT harvest : public contract {
       indexed_by<"byrank"_n,const_mem_fun<tx_points_table, uint64_t, &tx_points_table::by_rank>>
     > tx_points_tables;
 
+    // copies of the ranks and region calc_contribution_score reads, kept by score_vector
+    TABLE score_vector_table {
+      name account;
+      uint8_t planted_rank;
+      uint8_t tx_rank;
+      uint8_t rep_rank;
+      uint8_t cbs_rank;
+      name region;
+
+      uint64_t primary_key()const { return account.value; }
+    };
+
+    typedef eosio::multi_index<"scorevector"_n, score_vector_table> score_vector_tables;
+
     DEFINE_CS_POINTS_TABLE
 
     DEFINE_CS_POINTS_TABLE_MULTI_INDEX
@@ -213,6 +293,34 @@ CONTRACT harvest : public contract {
 
     DEFINE_SIZE_TABLE_MULTI_INDEX
 
+    DEFINE_RANK_CURSOR_TABLE
+
+    DEFINE_RANK_CURSOR_TABLE_MULTI_INDEX
+
+    DEFINE_RANK_SHADOW_TABLE
+
+    DEFINE_RANK_SHADOW_TABLE_MULTI_INDEX
+
+    DEFINE_RANK_TREE_TABLE
+
+    DEFINE_RANK_TREE_TABLE_MULTI_INDEX
+
+    DEFINE_TX_WINDOW_TABLE
+
+    DEFINE_TX_WINDOW_TABLE_MULTI_INDEX
+
+    DEFINE_QEV_WINDOW_TABLE
+
+    DEFINE_QEV_WINDOW_SINGLETON
+
+    DEFINE_ACTION_STATS_TABLE
+
+    DEFINE_ACTION_STATS_TABLE_MULTI_INDEX
+
+    DEFINE_JOB_STATE_TABLE
+
+    DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
     // DEPRECATED - REMOVE ONCE APPS ARE UPDATED // 
     DEFINE_HARVEST_TABLE
     
@@ -226,6 +334,8 @@ CONTRACT harvest : public contract {
 
     DEFINE_USER_TABLE_MULTI_INDEX
 
+    DEFINE_USER_CORE_TABLE
+
     DEFINE_CONFIG_TABLE
 
     DEFINE_CONFIG_TABLE_MULTI_INDEX
@@ -273,6 +383,11 @@ CONTRACT harvest : public contract {
 
     typedef eosio::multi_index<"refunds"_n, refund_table> refund_tables;
 
+    typedef eosio::multi_index<"refundsched"_n, refund_schedule_table> refund_schedule_tables;
+
+    uint32_t refund_weeks_passed(const refund_schedule_table & schedule);
+    int64_t refund_vested(const refund_schedule_table & schedule, uint32_t weeks_passed);
+
     typedef eosio::multi_index<"balances"_n, balance_table,
         indexed_by<"byplanted"_n,
         const_mem_fun<balance_table, uint64_t, &balance_table::by_planted>>
@@ -314,6 +429,8 @@ CONTRACT harvest : public contract {
       uint64_t primary_key()const { return id; }
     };
 
+    // running total of the contribution points of each region's members, kept up to date by
+    // calc_contribution_score and region membership changes, ranked by rankrgncs
     TABLE region_cs_temporal_table {
       name region;
       uint32_t points;
@@ -377,17 +494,24 @@ CONTRACT harvest : public contract {
     cs_points_tables cspoints;
     size_tables sizes;
     monthly_qev_tables monthlyqevs;
+    claimable_tables claimable;
     mint_rate_tables mintrate;
     region_cs_temporal_tables regioncstemp;
+    score_vector_tables scores;
+
+    // ranks as of the last published pass, one view per ranked table read in this action
+    std::map<std::tuple<uint64_t, uint64_t, uint64_t>, ranking::published> rank_views;
 
     // DEPRECATED - remove
     typedef eosio::multi_index<"harvest"_n, harvest_table> harvest_tables;
     harvest_tables harveststat;
 
 
+    // config parameters, read from the settings snapshot on first use
+    config_snapshot::reader conf;
+
     // External Tables
-    config_tables config;
-    config_float_tables configfloat;
+    // walked by the batch jobs, single accounts are read through user_core::find
     user_tables users;
     cbs_tables cbs;
     rep_tables rep;
@@ -411,8 +535,9 @@ extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
           (setorgtxpt)
           (testclaim)(testupdatecs)(testcalcmqev)(testcspoints)
           (calcmqevs)(calcmintrate)
-          (runharvest)(disthvstusrs)(disthvstorgs)(disthvstrgns)
-          (delcsorg)(migorgs)(testmigscope)
+          (runharvest)(disthvstusrs)(disthvstorgs)(disthvstrgns)(claim)(settle)
+          (delcsorg)(migorgs)(testmigscope)(initranks)(initscores)(initrgncs)(rankof)
+          (setranks)(setregion)
         )
       }
   }
@@ -5,9 +5,16 @@
 #include <tables/config_table.hpp>
 #include <tables/config_float_table.hpp>
 #include <tables/size_table.hpp>
+#include <tables/tx_window_table.hpp>
+#include <tables/qev_window_table.hpp>
+#include <tables/job_state_table.hpp>
 
 #include <contracts.hpp>
-#include <tables/user_table.hpp>
+#include <tables/user_core_table.hpp>
+#include <user_core.hpp>
+#include <jobs.hpp>
+#include <ranking.hpp>
+#include <config_snapshot.hpp>
 
 #include <cmath>
 
@@ -20,15 +27,15 @@ CONTRACT history : public contract {
         using contract::contract;
         history(name receiver, name code, datastream<const char*> ds)
         : contract(receiver, code, ds),
-          users(contracts::accounts, contracts::accounts.value),
           sizes(receiver, receiver.value),
           residents(receiver, receiver.value),
           citizens(receiver, receiver.value),
           reputables(receiver, receiver.value),
           regens(receiver, receiver.value),
           totals(receiver, receiver.value),
-          organizations(contracts::organization, contracts::organization.value),
-          members(contracts::region, contracts::region.value)
+          txwindows(receiver, receiver.value),
+          txexpiry(receiver, receiver.value),
+          pending(receiver, receiver.value)
         {}
 
         ACTION reset(name account);
@@ -51,6 +58,12 @@ CONTRACT history : public contract {
 
         ACTION savepoints(uint64_t id, uint64_t timestamp);
 
+        ACTION drainpoints();
+
+        ACTION requeuepts(uint64_t id);
+
+        ACTION expiretxpts();
+
         ACTION testtotalqev(uint64_t numdays, uint64_t volume);
         ACTION migrate();
         ACTION migrateusers();
@@ -60,6 +73,14 @@ CONTRACT history : public contract {
     private:
       const uint64_t regenerative_org = 2;
 
+      // a drainpoints not sent again within this time failed, the next trxentry sends a new one
+      const uint64_t drain_timeout_sec = 60;
+      const name parked_scope = "parked"_n;
+
+      // scopes of accounts' rep rankings
+      const name individual_scope_accounts = contracts::accounts;
+      const name organization_scope = "org"_n;
+
       void check_user(name account);
       uint32_t num_transactions(name account, uint32_t limit);
       uint64_t config_get(name key);
@@ -69,9 +90,14 @@ CONTRACT history : public contract {
       void fire_orgtx_calc(name organization, uint128_t start_val, uint64_t chunksize, uint64_t running_total);
       bool clean_old_tx(name org, uint64_t chunksize);
       void save_from_metrics (name from, int64_t & from_points, int64_t & qualifying_volume, uint64_t & day);
+      void add_trx_points (name account, int64_t points, uint64_t day);
+      void queue_points (name from, name to, uint64_t day, uint64_t from_points, uint64_t to_points, uint64_t qualifying_volume);
+      void send_drain_points (uint64_t retries);
+      void init_tx_window (name account);
+      uint64_t tx_points_cutoff ();
+      void change_total_qev (uint64_t day, int64_t qualifying_volume);
       void send_update_txpoints (name from);
       double config_float_get(name key);
-      double get_transaction_multiplier (name account, name other);
       
       // migration functions
       void save_migration_user_transaction(name from, name to, asset quantity, uint64_t timestamp);
@@ -191,6 +217,35 @@ CONTRACT history : public contract {
         uint64_t by_points() const { return points; }
       };
 
+      TABLE pending_points_table { // transfers waiting for drainpoints, one row per day, from and to
+        uint64_t id;
+        uint64_t day;
+        name from;
+        name to;
+        uint64_t from_points;
+        uint64_t to_points;
+        uint64_t qualifying_volume;
+        uint64_t count;
+
+        uint64_t primary_key() const { return id; }
+        uint128_t by_from_to() const { return (uint128_t(from.value) << 64) + to.value; }
+      };
+
+      TABLE drain_state_table { // when the last drainpoints was sent, and how often it had to be sent again
+        uint64_t scheduled_at;
+        uint64_t retries;
+      };
+
+      TABLE tx_expiry_table { // one row per account and day counted in a txwindow
+        uint64_t id;
+        name account;
+        uint64_t day;
+
+        uint64_t primary_key() const { return id; }
+        uint128_t by_day() const { return (uint128_t(day) << 64) + account.value; }
+        uint64_t by_account() const { return account.value; }
+      };
+
       TABLE qev_table { // scoped by account
         uint64_t timestamp;
         uint64_t qualifying_volume;
@@ -209,27 +264,6 @@ CONTRACT history : public contract {
         uint64_t primary_key() const { return account.value; }
       };
 
-      TABLE organization_table { // from organization contract
-          name org_name;
-          name owner;
-          uint64_t status;
-          int64_t regen;
-          uint64_t reputation;
-          uint64_t voice;
-          asset planted;
-
-          uint64_t primary_key() const { return org_name.value; }
-      };
-
-      TABLE members_table {
-          name region;
-          name account;
-          time_point joined_date = current_block_time().to_time_point();
-
-          uint64_t primary_key() const { return account.value; }
-          uint64_t by_region() const { return region.value; }
-      };
-
       typedef eosio::multi_index<"citizens"_n, citizen_table,
         indexed_by<"byaccount"_n,
         const_mem_fun<citizen_table, uint64_t, &citizen_table::by_account>>
@@ -268,6 +302,20 @@ CONTRACT history : public contract {
         const_mem_fun<transaction_points_table, uint64_t, &transaction_points_table::by_points>>
       > transaction_points_tables;
 
+      typedef eosio::multi_index<"pendingpts"_n, pending_points_table,
+        indexed_by<"byfromto"_n,
+        const_mem_fun<pending_points_table, uint128_t, &pending_points_table::by_from_to>>
+      > pending_points_tables;
+
+      typedef eosio::singleton<"drainstate"_n, drain_state_table> drain_state_tables;
+
+      typedef eosio::multi_index<"txexpiry"_n, tx_expiry_table,
+        indexed_by<"byday"_n,
+        const_mem_fun<tx_expiry_table, uint128_t, &tx_expiry_table::by_day>>,
+        indexed_by<"byaccount"_n,
+        const_mem_fun<tx_expiry_table, uint64_t, &tx_expiry_table::by_account>>
+      > tx_expiry_tables;
+
       typedef eosio::multi_index<"qevs"_n, qev_table,
         indexed_by<"byvolume"_n,
         const_mem_fun<qev_table, uint64_t, &qev_table::by_volume>>
@@ -275,29 +323,41 @@ CONTRACT history : public contract {
 
       typedef eosio::multi_index<"totals"_n, totals_table> totals_tables;
 
-      typedef eosio::multi_index <"organization"_n, organization_table> organization_tables;
-
-      typedef eosio::multi_index <"members"_n, members_table,
-        indexed_by<"byregion"_n,const_mem_fun<members_table, uint64_t, &members_table::by_region>>
-      > members_tables;
-      
-      DEFINE_USER_TABLE
+      DEFINE_USER_CORE_TABLE
       
-      DEFINE_USER_TABLE_MULTI_INDEX
+      DEFINE_USER_CORE_TABLE_MULTI_INDEX
+
+      double get_transaction_multiplier (const user_core_table & account, const user_core_table & other);
+      uint64_t published_rep_rank (const user_core_table & account);
 
       DEFINE_SIZE_TABLE
 
       DEFINE_SIZE_TABLE_MULTI_INDEX
 
-      user_tables users;
+      DEFINE_TX_WINDOW_TABLE
+
+      DEFINE_TX_WINDOW_TABLE_MULTI_INDEX
+
+      DEFINE_QEV_WINDOW_TABLE
+
+      DEFINE_QEV_WINDOW_SINGLETON
+
+      DEFINE_JOB_STATE_TABLE
+
+      DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
       resident_tables residents;
       citizen_tables citizens;
       reputable_tables reputables;
       regenerative_tables regens;
       totals_tables totals;
+      tx_window_tables txwindows;
+      tx_expiry_tables txexpiry;
+      pending_points_tables pending;
       size_tables sizes;
-      organization_tables organizations;
-      members_tables members;
+
+      // config parameters, read from the settings snapshot on first use
+      config_snapshot::reader conf;
 };
 
 EOSIO_DISPATCH(history, 
@@ -306,7 +366,7 @@ EOSIO_DISPATCH(history,
   (addcitizen)(addresident)
   (addreputable)(addregen)
   (numtrx)
-  (deldailytrx)(savepoints)
+  (deldailytrx)(savepoints)(drainpoints)(requeuepts)(expiretxpts)
   (testtotalqev)
   (migrateusers)(migrateuser)
   (migrate)
@@ -5,6 +5,10 @@
 #include <utils.hpp>
 #include <tables.hpp>
 #include <tables/config_table.hpp>
+#include <tables/job_state_table.hpp>
+#include <tables/referral_stats_table.hpp>
+#include <jobs.hpp>
+#include <transfer_profile.hpp>
 #include <cmath> 
 
 using namespace eosio;
@@ -24,6 +28,8 @@ CONTRACT organization : public contract {
               sizes(receiver, receiver.value),
               avgvotes(receiver, receiver.value),
               refs(contracts::accounts, contracts::accounts.value),
+              refstats(contracts::accounts, contracts::accounts.value),
+              refstatsst(contracts::accounts, contracts::accounts.value),
               users(contracts::accounts, contracts::accounts.value),
               balances(contracts::harvest, contracts::harvest.value),
               config(contracts::settings, contracts::settings.value),
@@ -203,6 +209,17 @@ CONTRACT organization : public contract {
 
         DEFINE_SIZE_TABLE_MULTI_INDEX
 
+        DEFINE_JOB_STATE_TABLE
+
+        DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
+        DEFINE_REFERRAL_STATS_TABLE
+
+        DEFINE_REFERRAL_STATS_TABLE_MULTI_INDEX
+
+        DEFINE_REFERRAL_STATS_STATE_TABLE
+
+        DEFINE_REFERRAL_STATS_STATE_SINGLETON
 
         TABLE totals_table {
             name account;
@@ -308,6 +325,8 @@ CONTRACT organization : public contract {
         size_tables sizes;
         balance_tables balances;
         ref_tables refs;
+        referral_stats_tables refstats;
+        referral_stats_state_tables refstatsst;
         avg_vote_tables avgvotes;
         totals_tables totals;
 
@@ -315,6 +334,7 @@ CONTRACT organization : public contract {
         const name regen_score_size = "rs.sz"_n;
         const name cb_score_size = "cbs.sz"_n;
         const name tx_score_size = "txs.sz"_n;
+        const name daus_pending = "dau.pending"_n;
         const name regen_avg = "org.rgnavg"_n;
         const uint64_t regular_org = 0;
         const uint64_t reputable_org = 1;
@@ -333,6 +353,8 @@ CONTRACT organization : public contract {
         uint64_t get_size(name id);
         void increase_size_by_one(name id);
         void decrease_size_by_one(name id);
+        void set_size(name id, uint64_t size);
+        void clean_dau_done();
         uint32_t calc_transaction_points(name organization);
         void check_can_make_regen(name organization);
         void check_can_make_reputable(name organization);
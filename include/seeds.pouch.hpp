@@ -5,7 +5,8 @@
 #include <seeds.token.hpp>
 #include <contracts.hpp>
 #include <utils.hpp>
-#include <tables/user_table.hpp>
+#include <tables/user_core_table.hpp>
+#include <user_core.hpp>
 #include <tables/config_table.hpp>
 
 using namespace eosio;
@@ -19,8 +20,7 @@ CONTRACT pouch : public contract {
     using contract::contract;
     pouch(name receiver, name code, datastream<const char*> ds)
       : contract(receiver, code, ds),
-        balances(receiver, receiver.value),
-        users(contracts::accounts, contracts::accounts.value)
+        balances(receiver, receiver.value)
         {}
 
     ACTION reset();
@@ -46,9 +46,9 @@ CONTRACT pouch : public contract {
     void _transfer(name beneficiary, asset quantity, string memo);
     void check_freeze(name account);
 
-    DEFINE_USER_TABLE
+    DEFINE_USER_CORE_TABLE
 
-    DEFINE_USER_TABLE_MULTI_INDEX
+    DEFINE_USER_CORE_TABLE_MULTI_INDEX
 
     TABLE balance_table {
       name account;
@@ -61,7 +61,6 @@ CONTRACT pouch : public contract {
     typedef eosio::multi_index<"balances"_n, balance_table> balance_tables;
 
     balance_tables balances;
-    user_tables users;
 
 };
 
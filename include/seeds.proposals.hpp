@@ -8,6 +8,12 @@
 #include <tables/cspoints_table.hpp>
 #include <tables/user_table.hpp>
 #include <tables/config_table.hpp>
+#include <tables/action_stats_table.hpp>
+#include <instrument.hpp>
+#include <tables/job_state_table.hpp>
+#include <jobs.hpp>
+#include <ranking.hpp>
+#include <config_snapshot.hpp>
 #include <vector>
 #include <cmath>
 
@@ -28,6 +34,7 @@ CONTRACT proposals : public contract {
           minstake(receiver, receiver.value),
           actives(receiver, receiver.value),
           cyclestats(receiver, receiver.value),
+          liveprops(receiver, receiver.value),
           users(contracts::accounts, contracts::accounts.value)
           {}
 
@@ -55,12 +62,14 @@ CONTRACT proposals : public contract {
 
       ACTION neutral(name user, uint64_t id);
 
-      ACTION voteonbehalf(name voter, uint64_t id, uint64_t amount, name option);
-
       ACTION erasepartpts(uint64_t active_proposals);
 
+      ACTION creditdelegs(name scope, uint64_t start, uint64_t active_proposals);
+
       ACTION onperiod();
 
+      ACTION evalprops(uint64_t start, uint64_t active_proposals);
+
       ACTION updatevoices();
 
       ACTION updatevoice(uint64_t start);
@@ -88,8 +97,6 @@ CONTRACT proposals : public contract {
 
       ACTION delegate(name delegator, name delegatee, name scope);
 
-      ACTION mimicvote(name delegatee, name delegator, name scope, uint64_t proposal_id, double percentage_used, name option, uint64_t chunksize);
-
       ACTION undelegate(name delegator, name scope);
 
 
@@ -102,6 +109,10 @@ CONTRACT proposals : public contract {
 
       ACTION testperiod ();
 
+      ACTION initlive(uint64_t start); // MIGRATION ACTION
+
+      ACTION initdelvoice(name scope, uint64_t start); // MIGRATION ACTION
+
   private:
       symbol seeds_symbol = symbol("SEEDS", 4);
       name trust = "trust"_n;
@@ -151,7 +162,7 @@ CONTRACT proposals : public contract {
       void send_to_escrow(name fromfund, name recipient, asset quantity, string memo);
       void burn(asset quantity);
       void update_voice_table();
-      void vote_aux(name voter, uint64_t id, uint64_t amount, name option, bool is_new, bool is_delegated);
+      void vote_aux(name voter, uint64_t id, uint64_t amount, name option, bool is_new);
       bool revert_vote (name voter, uint64_t id);
       void change_rep(name beneficiary, bool passed);
       uint64_t get_size(name id);
@@ -170,27 +181,27 @@ CONTRACT proposals : public contract {
       asset get_payout_amount(std::vector<uint64_t> pay_percentages, uint64_t age, asset total_amount, asset current_payout);
       void check_voice_scope(name scope);
       bool is_trust_delegated(name account, name scope);
-      void send_mimic_delegatee_vote(name delegatee, name scope, uint64_t proposal_id, double percentage_used, name option);
+      void change_delegated(name delegator, name scope, int64_t delta);
+      void change_delegated_voice(name user, name scope, uint64_t old_balance, uint64_t new_balance);
+      uint64_t spend_delegated(name delegatee, name scope, double percentage_used, uint64_t id);
+      name chain_top(name account, name scope);
+      double delegated_used(name account, name scope);
+      void charge_delegated(name delegator, name scope);
+      void leave_delegatee(name delegator, name scope);
+      void override_delegatee(name delegator, name scope, uint64_t id, uint64_t amount);
+      void credit_delegator(name delegator, name top, uint64_t rep);
+      void set_active(name account);
       uint64_t active_cutoff_date();
       bool is_active(name account, uint64_t cutoff_date);
-      void send_vote_on_behalf(name voter, uint64_t id, uint64_t amount, name option);
 
       void increase_voice_cast(name voter, uint64_t amount, name option);
       uint64_t calc_quorum_base(uint64_t propcycle);
       void update_cycle_stats(std::vector<uint64_t>active_props, std::vector<uint64_t> eval_props);
+      void finish_period(uint64_t active_proposals);
       void add_voted_proposal(uint64_t proposal_id);
 
       uint64_t config_get(name key) {
-        DEFINE_CONFIG_TABLE
-        DEFINE_CONFIG_TABLE_MULTI_INDEX
-        config_tables config(contracts::settings, contracts::settings.value);
-        
-        auto citr = config.find(key.value);
-          if (citr == config.end()) { 
-          // only create the error message string in error case for efficiency
-          eosio::check(false, ("settings: the "+key.to_string()+" parameter has not been initialized").c_str());
-        }
-        return citr->value;
+        return conf.get(key);
       }
 
       TABLE proposal_table {
@@ -281,6 +292,32 @@ CONTRACT proposals : public contract {
         uint128_t by_delegatee_delegator() const { return (uint128_t(delegatee.value) << 64) + delegator.value; }
       };
 
+      TABLE delegated_voice_table { // scoped like voice, the voice of everyone delegating to delegatee directly or through others
+        name delegatee;
+        uint64_t voice; // sum of the delegators' voice balances
+        double used; // share of that voice the delegatee's votes spent in cycle
+        uint64_t cycle;
+        double joined_used; // share its chain had spent in joined_cycle when delegatee delegated itself
+        uint64_t joined_cycle;
+
+        uint64_t primary_key()const { return delegatee.value; }
+      };
+
+      TABLE delegated_vote_table { // scoped by proposal id, the delegated voice in an account's vote
+        name account;
+        uint64_t voice; // delegated voice the vote counted, less what delegators took back since
+        uint64_t amount; // weight the delegated voice added to the vote
+        uint64_t overridden; // voice of the delegators below the account that voted themselves
+
+        uint64_t primary_key()const { return account.value; }
+      };
+
+      TABLE vote_override_table { // scoped by proposal id, delegators that voted themselves
+        name account; // its own voice and the voice delegated to it are kept out of its delegatees' votes
+
+        uint64_t primary_key()const { return account.value; }
+      };
+
       TABLE cycle_stats_table {
         uint64_t propcycle; 
         
@@ -302,6 +339,12 @@ CONTRACT proposals : public contract {
         uint64_t primary_key()const { return propcycle; }
       };
 
+      TABLE live_proposal_table { // proposals in the staged or active stage, the only ones onperiod visits
+        uint64_t id;
+
+        uint64_t primary_key()const { return id; }
+      };
+
       TABLE voted_proposals_table { // scoped by cycle
         uint64_t proposal_id;
 
@@ -327,12 +370,22 @@ CONTRACT proposals : public contract {
       indexed_by<"byddelegator"_n,
       const_mem_fun<delegate_trust_table, uint128_t, &delegate_trust_table::by_delegatee_delegator>>
     > delegate_trust_tables;
+    typedef eosio::multi_index<"delvoice"_n, delegated_voice_table> delegated_voice_tables;
+    typedef eosio::multi_index<"delvotes"_n, delegated_vote_table> delegated_vote_tables;
+    typedef eosio::multi_index<"overrides"_n, vote_override_table> vote_override_tables;
     typedef eosio::multi_index<"cyclestats"_n, cycle_stats_table> cycle_stats_tables;
     typedef eosio::multi_index<"cycvotedprps"_n, voted_proposals_table> voted_proposals_tables;
+    typedef eosio::multi_index<"liveprops"_n, live_proposal_table> live_proposal_tables;
  
     DEFINE_SIZE_TABLE
     DEFINE_SIZE_TABLE_MULTI_INDEX
 
+    DEFINE_ACTION_STATS_TABLE
+    DEFINE_ACTION_STATS_TABLE_MULTI_INDEX
+
+    DEFINE_JOB_STATE_TABLE
+    DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
     proposal_tables props;
     participant_tables participants;
     user_tables users;
@@ -342,6 +395,10 @@ CONTRACT proposals : public contract {
     min_stake_tables minstake;
     active_tables actives;
     cycle_stats_tables cyclestats;
+    live_proposal_tables liveprops;
+
+    // config parameters, read from the settings snapshot on first use
+    config_snapshot::reader conf;
 
 };
 
@@ -351,11 +408,11 @@ extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
   } else if (code == receiver) {
       switch (action) {
         EOSIO_DISPATCH_HELPER(proposals, (reset)(create)(createx)(update)(updatex)(addvoice)(changetrust)(favour)(against)
-        (neutral)(erasepartpts)(checkstake)(onperiod)(decayvoice)(cancel)(updatevoices)(updatevoice)(decayvoices)
+        (neutral)(erasepartpts)(creditdelegs)(checkstake)(onperiod)(evalprops)(decayvoice)(cancel)(updatevoices)(updatevoice)(decayvoices)
         (addactive)(testvdecay)(initsz)(testquorum)(initnumprop)
-        (migratevoice)(testsetvoice)(delegate)(mimicvote)(undelegate)(voteonbehalf)
+        (migratevoice)(testsetvoice)(delegate)(undelegate)
         (calcvotepow)
-        (migrtevotedp)(migrpass)(testperiod)(migstats)(migcycstat)(testpropquor)
+        (migrtevotedp)(migrpass)(testperiod)(migstats)(migcycstat)(testpropquor)(initlive)(initdelvoice)
         )
       }
   }
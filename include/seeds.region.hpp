@@ -3,6 +3,8 @@
 #include <eosio/system.hpp>
 #include <contracts.hpp>
 #include <utils.hpp>
+#include <score_vector.hpp>
+#include <transfer_profile.hpp>
 #include <tables/user_table.hpp>
 #include <tables/config_table.hpp>
 #include <tables/config_float_table.hpp>
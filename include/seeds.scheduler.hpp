@@ -3,6 +3,8 @@
 #include <contracts.hpp>
 #include <utils.hpp>
 #include <tables/config_table.hpp>
+#include <tables/action_stats_table.hpp>
+#include <instrument.hpp>
 
 using namespace eosio;
 using std::string;
@@ -17,6 +19,7 @@ CONTRACT scheduler : public contract {
         operations(receiver, receiver.value),
         moonphases(receiver, receiver.value),
         test(receiver, receiver.value),
+        opstate(receiver, receiver.value),
         config(contracts::settings, contracts::settings.value)
         {}
 
@@ -34,6 +37,12 @@ CONTRACT scheduler : public contract {
         ACTION pauseop(name id, uint8_t pause);
 
         ACTION confirm(name operation);
+
+        // operation id only starts once every op in after has finished. With signals the op is only
+        // finished when its contract calls opdone, otherwise as soon as it has been sent.
+        ACTION configdeps(name id, std::vector<name> after, bool signals);
+
+        ACTION opdone(name contract, name operation);
         
         ACTION stop();
         
@@ -51,6 +60,9 @@ CONTRACT scheduler : public contract {
         void exec_op(name id, name contract, name action);
         void cancel_exec();
         void reset_aux(bool destructive);
+        void reset_deps();
+        bool dependencies_done(name operation);
+        void mark_started(name operation);
         bool should_preserve_op(name op_id) {
             return 
                 op_id == "exch.period"_n || 
@@ -78,6 +90,17 @@ CONTRACT scheduler : public contract {
             uint64_t primary_key() const { return timestamp; }
         };
 
+        TABLE op_state_table {
+            name id;
+            std::vector<name> after;
+            bool signals;
+            bool running;
+            uint64_t started_at;
+            uint64_t completed_at;
+
+            uint64_t primary_key() const { return id.value; }
+        };
+
         TABLE test_table {
             name param;
             uint64_t value;
@@ -88,6 +111,10 @@ CONTRACT scheduler : public contract {
         
         DEFINE_CONFIG_TABLE_MULTI_INDEX
 
+        DEFINE_ACTION_STATS_TABLE
+
+        DEFINE_ACTION_STATS_TABLE_MULTI_INDEX
+
         typedef eosio::multi_index < "operations"_n, operations_table,
             indexed_by<"bytimestamp"_n, const_mem_fun<operations_table, uint64_t, &operations_table::by_timestamp>>
         > operations_tables;
@@ -96,11 +123,15 @@ CONTRACT scheduler : public contract {
 
         typedef eosio::multi_index <"test"_n, test_table> test_tables;
 
+        typedef eosio::multi_index <"opstate"_n, op_state_table> op_state_tables;
+
         name seconds_to_execute = "secndstoexec"_n;
+        name ops_per_tick = "sched.ops"_n;
 
         operations_tables operations;
         config_tables config;
         test_tables test;
+        op_state_tables opstate;
         moon_phases_tables moonphases;
 
         bool is_ready_to_execute(name operation);
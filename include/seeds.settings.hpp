@@ -5,6 +5,8 @@
 #include <utils.hpp>
 #include <tables/config_table.hpp>
 #include <tables/config_float_table.hpp>
+#include <tables/config_snapshot_table.hpp>
+#include <config_snapshot.hpp>
 
 using namespace eosio;
 using std::string;
@@ -31,6 +33,8 @@ CONTRACT settings : public contract {
 
       ACTION setcontract(name contract, name account);
 
+      ACTION publishconf(); // MIGRATION ACTION
+
   private:
       const name high_impact = "high"_n;
       const name medium_impact = "med"_n;
@@ -44,6 +48,10 @@ CONTRACT settings : public contract {
 
       DEFINE_CONFIG_FLOAT_TABLE_MULTI_INDEX
 
+      DEFINE_CONFIG_SNAPSHOT_TABLE
+
+      DEFINE_CONFIG_SNAPSHOT_SINGLETON
+
       config_tables config;
       config_float_tables configfloat;
 
@@ -69,4 +77,4 @@ CONTRACT settings : public contract {
 
 };
 
-EOSIO_DISPATCH(settings, (reset)(configure)(setcontract)(confwithdesc)(conffloat)(conffloatdsc));
+EOSIO_DISPATCH(settings, (reset)(configure)(setcontract)(confwithdesc)(conffloat)(conffloatdsc)(publishconf));
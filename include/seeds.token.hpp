@@ -10,6 +10,12 @@
 #include <contracts.hpp>
 #include <tables.hpp>
 #include <tables/config_table.hpp>
+#include <tables/user_core_table.hpp>
+#include <user_core.hpp>
+#include <tables/job_state_table.hpp>
+#include <tables/epoch_table.hpp>
+#include <jobs.hpp>
+#include <epoch_counter.hpp>
 #include <eosio/singleton.hpp>
 
 #include <string>
@@ -37,7 +43,9 @@ namespace eosio {
          using contract::contract;
          token(name receiver, name code, datastream<const char*> ds)
             :  contract(receiver, code, ds),
-               circulating(receiver, receiver.value)
+               circulating(receiver, receiver.value),
+               sysaccts(receiver, receiver.value),
+               epochs(receiver, receiver.value)
                {}
          
          /**
@@ -109,6 +117,23 @@ namespace eosio {
                         const asset&   quantity,
                         const string&  memo );
 
+         /**
+          * Transfer many action.
+          *
+          * @details Pays many accounts from a system payout account in one action. `from` is debited once
+          * and each recipient is credited and notified. Transaction stats and history are not updated
+          * for these payouts. The payout is counted once in the payer's row of the payers
+          * table instead.
+          *
+          * @param from - the paying account, it has to be whitelisted with addpayer,
+          * @param payouts - the accounts to credit and the quantity each one gets,
+          * @param memo - the memo string to accompany the payouts.
+          */
+         [[eosio::action]]
+         void transfermany( const name&    from,
+                            const std::vector<std::pair<name, asset>>& payouts,
+                            const string&  memo );
+
          /**
           * Open action.
           *
@@ -175,11 +200,39 @@ namespace eosio {
          [[eosio::action]]
          void resetweekly();
 
-         [[eosio::action]]
-         void resetwhelper(uint64_t begin);
-
+         /**
+          * Recomputes the circulating supply from the total supply and the balances of the system accounts.
+          *
+          * @details Transfers, issue, retire and burn keep the circulating table up to date as they move
+          * tokens, this sets the baseline they adjust and reconciles it.
+          */
          ACTION updatecirc();
 
+         /**
+          * Adds `account` to the system accounts, whose balances do not count as circulating supply.
+          */
+         ACTION addsysacct(name account);
+
+         /**
+          * Removes `account` from the system accounts, its balance counts as circulating supply again.
+          */
+         ACTION delsysacct(name account);
+
+         /**
+          * Adds the system accounts the circulating supply used to be computed from and reconciles it.
+          */
+         ACTION initsysaccts();
+
+         /**
+          * Allows `sender` to pay out with transfermany. Does nothing if it already may.
+          */
+         ACTION addpayer(name sender);
+
+         /**
+          * Stops `sender` from paying out with transfermany and drops its payout counters.
+          */
+         ACTION delpayer(name sender);
+
          ACTION minttst(const name& to, const asset& quantity, const string& memo);
 
          using create_action = eosio::action_wrapper<"create"_n, &token::create>;
@@ -187,6 +240,7 @@ namespace eosio {
          using retire_action = eosio::action_wrapper<"retire"_n, &token::retire>;
          using burn_action = eosio::action_wrapper<"burn"_n, &token::burn>;
          using transfer_action = eosio::action_wrapper<"transfer"_n, &token::transfer>;
+         using transfermany_action = eosio::action_wrapper<"transfermany"_n, &token::transfermany>;
          using open_action = eosio::action_wrapper<"open"_n, &token::open>;
          using close_action = eosio::action_wrapper<"close"_n, &token::close>;
          using issue_action_test = eosio::action_wrapper<"minttst"_n, &token::minttst>;
@@ -197,6 +251,10 @@ namespace eosio {
 
          DEFINE_CONFIG_TABLE
 
+         DEFINE_JOB_STATE_TABLE
+
+         DEFINE_JOB_STATE_TABLE_MULTI_INDEX
+
          struct [[eosio::table]] account {
             asset    balance;
 
@@ -217,6 +275,7 @@ namespace eosio {
             uint64_t total_transactions;
             uint64_t incoming_transactions;
             uint64_t outgoing_transactions;
+            eosio::binary_extension<uint64_t> epoch;
 
             uint64_t primary_key()const { return account.value; }
             uint64_t by_transaction_volume()const { return transactions_volume.amount; }
@@ -229,10 +288,13 @@ namespace eosio {
             const_mem_fun<transaction_stats, uint64_t, &transaction_stats::by_transaction_volume>>
          > transaction_tables;
 
-          typedef eosio::multi_index<"users"_n, tables::user_table,
-            indexed_by<"byreputation"_n,
-            const_mem_fun<tables::user_table, uint64_t, &tables::user_table::by_reputation>>
-          > user_tables;
+          DEFINE_USER_CORE_TABLE
+
+          DEFINE_USER_CORE_TABLE_MULTI_INDEX
+
+          DEFINE_EPOCH_TABLE
+
+          DEFINE_EPOCH_TABLE_MULTI_INDEX
 
          void sub_balance( const name& owner, const asset& value );
          void add_balance( const name& owner, const asset& value, const name& ram_payer );
@@ -241,7 +303,7 @@ namespace eosio {
          void check_limit( const name& from );
          uint64_t balance_for( const name& owner );
          void check_limit_transactions(name from);
-         void reset_weekly_aux(uint64_t begin);
+         uint64_t outgoing_this_week(const name& from);
 
          TABLE circulating_supply_table {
             uint64_t id;
@@ -255,6 +317,37 @@ namespace eosio {
 
          circulating_supply_tables circulating;
 
+         TABLE system_account_table {
+            name account;
+            uint64_t primary_key()const { return account.value; }
+         };
+
+         typedef eosio::multi_index<"sysaccts"_n, system_account_table> system_account_tables;
+
+         // balances of these accounts are not circulating
+         system_account_tables sysaccts;
+
+         // senders allowed to use transfermany, with one aggregated entry for all their payouts
+         TABLE payer_table {
+            name sender;
+            uint64_t payouts;
+            uint64_t recipients;
+            asset volume;
+            uint64_t last_payout_at;
+
+            uint64_t primary_key()const { return sender.value; }
+         };
+
+         typedef eosio::multi_index<"payers"_n, payer_table> payer_tables;
+
+         bool is_system_account( const name& account );
+         void change_circulating( int64_t total_delta, int64_t circulating_delta );
+         void reconcile_circulating();
+
+         // trxstat rows from an older epoch are last week's counts
+         epoch_tables epochs;
+         const name trxstat_counter = "trxstat"_n;
+
          typedef eosio::multi_index<"config"_n, config_table> config_tables;
          typedef eosio::multi_index<"balances"_n, tables::balance_table,
          indexed_by<"byplanted"_n,
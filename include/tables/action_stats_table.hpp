@@ -0,0 +1,33 @@
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// SCOPE by the contract recording the stats
+// reads, writes, sent and elapsed_ms are ring buffers of the last instrument::ring_size calls, next is the slot
+// written next. The p50/p99 fields are recomputed from the rings on every call.
+#define DEFINE_ACTION_STATS_TABLE TABLE action_stats_table { \
+        name action; \
+        uint64_t calls; \
+        uint64_t rows_read; \
+        uint64_t rows_modified; \
+        uint64_t rows_emplaced; \
+        uint64_t rows_erased; \
+        uint64_t inline_sent; \
+        uint64_t deferred_sent; \
+        uint64_t last_at; \
+        uint32_t next; \
+        std::vector<uint32_t> reads; \
+        std::vector<uint32_t> writes; \
+        std::vector<uint32_t> sent; \
+        std::vector<uint32_t> elapsed_ms; \
+        uint32_t p50_reads; \
+        uint32_t p99_reads; \
+        uint32_t p50_writes; \
+        uint32_t p99_writes; \
+        uint32_t p50_elapsed_ms; \
+        uint32_t p99_elapsed_ms; \
+\
+        uint64_t primary_key()const { return action.value; } \
+      };
+
+#define DEFINE_ACTION_STATS_TABLE_MULTI_INDEX typedef eosio::multi_index<"actstats"_n, action_stats_table> action_stats_tables;
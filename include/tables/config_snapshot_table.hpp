@@ -0,0 +1,17 @@
+#include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
+
+using eosio::name;
+
+// SCOPE settings contract
+// values and float_values hold the parameters in the slot order of config_snapshot.hpp, a slot's bit in
+// present / float_present is set once that parameter has been configured. version goes up on every change.
+#define DEFINE_CONFIG_SNAPSHOT_TABLE TABLE config_snapshot_table { \
+        uint64_t version; \
+        std::vector<uint64_t> values; \
+        std::vector<double> float_values; \
+        uint64_t present; \
+        uint64_t float_present; \
+      };
+
+#define DEFINE_CONFIG_SNAPSHOT_SINGLETON typedef eosio::singleton<"confsnap"_n, config_snapshot_table> config_snapshot_tables;
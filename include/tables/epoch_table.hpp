@@ -0,0 +1,15 @@
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// SCOPE the contract itself
+// current epoch of each counter table the contract resets with epoch_counter::advance
+#define DEFINE_EPOCH_TABLE TABLE epoch_table { \
+        name counter; \
+        uint64_t epoch; \
+        uint64_t started_at; \
+\
+        uint64_t primary_key()const { return counter.value; } \
+      };
+
+#define DEFINE_EPOCH_TABLE_MULTI_INDEX typedef eosio::multi_index<"epochs"_n, epoch_table> epoch_tables;
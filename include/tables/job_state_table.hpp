@@ -0,0 +1,20 @@
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// SCOPE by the contract running the job
+// job is the action that starts a pass (e.g. ranktxs, rankorgtxs), status is running or done. The counters
+// belong to the current pass, or to the last one once it is done, so rows / (finished_at - started_at) is
+// the throughput of the last full pass.
+#define DEFINE_JOB_STATE_TABLE TABLE job_state_table { \
+        name job; \
+        name status; \
+        uint64_t started_at; \
+        uint64_t finished_at; \
+        uint64_t chunks; \
+        uint64_t rows; \
+\
+        uint64_t primary_key()const { return job.value; } \
+      };
+
+#define DEFINE_JOB_STATE_TABLE_MULTI_INDEX typedef eosio::multi_index<"jobstate"_n, job_state_table> job_state_tables;
@@ -0,0 +1,13 @@
+#include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
+
+using eosio::name;
+
+// SCOPE history contract
+// qualifying_volume is the sum of the total qevs rows from start on
+#define DEFINE_QEV_WINDOW_TABLE TABLE qev_window_table { \
+        uint64_t qualifying_volume; \
+        uint64_t start; \
+      };
+
+#define DEFINE_QEV_WINDOW_SINGLETON typedef eosio::singleton<"qevwindow"_n, qev_window_table> qev_window_tables;
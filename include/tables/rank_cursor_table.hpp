@@ -0,0 +1,23 @@
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// SCOPE by the scope of the table being ranked
+// generation counts the passes started, published is the last one that completed
+#define DEFINE_RANK_CURSOR_TABLE TABLE rank_cursor_table { \
+        name job; \
+        uint128_t key; \
+        uint64_t pk; \
+        uint64_t current; \
+        uint64_t total; \
+        uint64_t sum_rank; \
+        uint64_t chunks; \
+        uint64_t started_at; \
+        uint64_t finished_at; \
+        uint64_t generation; \
+        uint64_t published; \
+\
+        uint64_t primary_key()const { return job.value; } \
+      };
+
+#define DEFINE_RANK_CURSOR_TABLE_MULTI_INDEX typedef eosio::multi_index<"rankcursors"_n, rank_cursor_table> rank_cursor_tables;
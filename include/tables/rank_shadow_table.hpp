@@ -0,0 +1,18 @@
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// SCOPE by ranking::shadow_scope(job, scope of the ranked table)
+// rank is what the row showed before an unpublished pass changed it, generation is that pass
+#define DEFINE_RANK_SHADOW_TABLE TABLE rank_shadow_table { \
+        uint64_t pk; \
+        uint64_t rank; \
+        uint64_t generation; \
+\
+        uint64_t primary_key()const { return pk; } \
+        uint64_t by_generation()const { return generation; } \
+      };
+
+#define DEFINE_RANK_SHADOW_TABLE_MULTI_INDEX typedef eosio::multi_index<"rankshadows"_n, rank_shadow_table, \
+        indexed_by<"bygeneration"_n, const_mem_fun<rank_shadow_table, uint64_t, &rank_shadow_table::by_generation>> \
+      > rank_shadow_tables;
@@ -0,0 +1,13 @@
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// SCOPE by the name of the ranked value, see rank_tree.hpp
+#define DEFINE_RANK_TREE_TABLE TABLE rank_tree_table { \
+        uint64_t id; \
+        std::vector<uint64_t> counts; \
+\
+        uint64_t primary_key()const { return id; } \
+      };
+
+#define DEFINE_RANK_TREE_TABLE_MULTI_INDEX typedef eosio::multi_index<"ranktree"_n, rank_tree_table> rank_tree_tables;
@@ -0,0 +1,29 @@
+#include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
+
+using eosio::name;
+
+// SCOPE accounts
+// referrals counts every account the referrer invited, residents and citizens those that currently have
+// that status. Kept by accounts::addref and accounts::updatestatus.
+#define DEFINE_REFERRAL_STATS_TABLE TABLE referral_stats_table { \
+        name referrer; \
+        uint64_t referrals; \
+        uint64_t residents; \
+        uint64_t citizens; \
+\
+        uint64_t primary_key()const { return referrer.value; } \
+      };
+
+#define DEFINE_REFERRAL_STATS_TABLE_MULTI_INDEX typedef eosio::multi_index<"refstats"_n, referral_stats_table> referral_stats_tables;
+
+// SCOPE accounts
+// How far initrefstats has got. Referrals of invited accounts below next are already counted in refstats and
+// kept up to date, the rest are counted when initrefstats reaches them. Once built, refstats holds every
+// referral. Readers fall back to counting refs until then.
+#define DEFINE_REFERRAL_STATS_STATE_TABLE TABLE referral_stats_state_table { \
+        uint64_t next; \
+        bool built; \
+      };
+
+#define DEFINE_REFERRAL_STATS_STATE_SINGLETON typedef eosio::singleton<"refstatsst"_n, referral_stats_state_table> referral_stats_state_tables;
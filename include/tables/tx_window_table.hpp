@@ -0,0 +1,15 @@
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// SCOPE history contract
+// points is the sum of the account's trxpoints rows from start on
+#define DEFINE_TX_WINDOW_TABLE TABLE tx_window_table { \
+        name account; \
+        uint64_t points; \
+        uint64_t start; \
+\
+        uint64_t primary_key()const { return account.value; } \
+      };
+
+#define DEFINE_TX_WINDOW_TABLE_MULTI_INDEX typedef eosio::multi_index<"txwindow"_n, tx_window_table> tx_window_tables;
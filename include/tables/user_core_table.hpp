@@ -0,0 +1,23 @@
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// SCOPE accounts contract
+// The fixed size part of a users row, without the profile strings, plus what a transfer needs to know
+// about each party: reputation rank, planted amount, region and organization status. accounts writes it
+// next to every change of status, type or reputation, the other fields arrive through transfer_profile.
+#define DEFINE_USER_CORE_TABLE TABLE user_core_table { \
+        name account; \
+        name status; \
+        name type; \
+        uint64_t reputation; \
+        uint64_t timestamp; \
+        uint64_t rep_rank; \
+        uint64_t planted; \
+        name region; \
+        uint64_t org_status; \
+\
+        uint64_t primary_key()const { return account.value; } \
+      };
+
+#define DEFINE_USER_CORE_TABLE_MULTI_INDEX typedef eosio::multi_index<"usercore"_n, user_core_table> user_core_tables;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <contracts.hpp>
+#include <instrument.hpp>
+
+using namespace eosio;
+
+/**
+ * Keeps the transfer profile part of accounts' usercore table, so token and history resolve each party of
+ * a transfer with one read instead of looking through users, rep, balances, organizations and members.
+ *
+ * accounts writes status, type and the reputation rank itself. harvest sends the planted amount, region
+ * the member's region and organization the organization status, each right after writing its own table.
+ * Rows only exist for users, a value sent for any other account is dropped.
+ */
+namespace transfer_profile {
+
+  const name planted = "planted"_n;
+  const name region = "region"_n;
+  const name org_status = "orgstatus"_n;
+
+  inline void send(name field, name account, uint64_t value) {
+    if (!is_account(contracts::accounts)) {
+      return;
+    }
+
+    action(
+      permission_level{contracts::accounts, "active"_n},
+      contracts::accounts,
+      "setprofile"_n,
+      std::make_tuple(field, account, value)
+    ).send();
+    instrument::sent_inline();
+  }
+
+}
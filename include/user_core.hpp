@@ -0,0 +1,116 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <contracts.hpp>
+#include <instrument.hpp>
+#include <tables/user_table.hpp>
+#include <tables/rep_table.hpp>
+
+#include <string>
+
+using namespace eosio;
+using std::string;
+
+/**
+ * Reads accounts' usercore table for the contracts that look up users on every transfer.
+ *
+ * usercore is filled by accounts::initcore, which has to run once after accounts is deployed with it and
+ * before token, history, harvest, gratitude, pouch and forum are deployed reading it. Until initcore has
+ * reached an account, its row is missing. find() then builds it from users and the tables initcore copies
+ * from, so readers see the same user either way. A lookup of an account that is not a user costs the one
+ * extra users read.
+ *
+ * Row is the caller's user_core_table, from DEFINE_USER_CORE_TABLE.
+ */
+namespace user_core {
+
+  // Fills the transfer profile of row, whose account and type are set, from the tables it is kept from.
+  template<typename Row>
+  void read_profile(Row & row) {
+    DEFINE_REP_TABLE
+    DEFINE_REP_TABLE_MULTI_INDEX
+
+    TABLE balance_table {
+      name account;
+      asset planted;
+      asset reward;
+
+      uint64_t primary_key()const { return account.value; }
+    };
+
+    TABLE organization_table {
+      name org_name;
+      name owner;
+      uint64_t status;
+      int64_t regen;
+      uint64_t reputation;
+      uint64_t voice;
+      asset planted;
+
+      uint64_t primary_key() const { return org_name.value; }
+    };
+
+    TABLE members_table {
+      name region;
+      name account;
+      time_point joined_date;
+
+      uint64_t primary_key() const { return account.value; }
+    };
+
+    typedef eosio::multi_index<"balances"_n, balance_table> balance_tables;
+    typedef eosio::multi_index<"organization"_n, organization_table> organization_tables;
+    typedef eosio::multi_index<"members"_n, members_table> members_tables;
+
+    name scope = row.type == "organisation"_n ? "org"_n : contracts::accounts;
+    rep_tables rep(contracts::accounts, scope.value);
+    balance_tables balances(contracts::harvest, contracts::harvest.value);
+    organization_tables organizations(contracts::organization, contracts::organization.value);
+    members_tables members(contracts::region, contracts::region.value);
+
+    auto ritr = rep.find(row.account.value);
+    auto bitr = balances.find(row.account.value);
+    auto oitr = organizations.find(row.account.value);
+    auto mitr = members.find(row.account.value);
+    instrument::read(4);
+
+    row.rep_rank = ritr != rep.end() ? ritr->rank : 0;
+    row.planted = bitr != balances.end() ? bitr->planted.amount : 0;
+    row.region = mitr != members.end() ? mitr->region : name();
+    row.org_status = oitr != organizations.end() ? oitr->status : 0;
+  }
+
+  // Copies account's usercore row into row, false when the account is not a user.
+  template<typename Row>
+  bool find(name account, Row & row) {
+    typedef eosio::multi_index<"usercore"_n, Row> user_core_tables;
+    user_core_tables usercore(contracts::accounts, contracts::accounts.value);
+
+    auto citr = usercore.find(account.value);
+    instrument::read();
+    if (citr != usercore.end()) {
+      row = *citr;
+      return true;
+    }
+
+    DEFINE_USER_TABLE
+    DEFINE_USER_TABLE_MULTI_INDEX
+    user_tables users(contracts::accounts, contracts::accounts.value);
+
+    auto uitr = users.find(account.value);
+    instrument::read();
+    if (uitr == users.end()) {
+      return false;
+    }
+
+    row.account = uitr->account;
+    row.status = uitr->status;
+    row.type = uitr->type;
+    row.reputation = uitr->reputation;
+    row.timestamp = uitr->timestamp;
+    read_profile(row);
+    return true;
+  }
+
+}
@@ -1,9 +1,13 @@
+#pragma once
+
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/system.hpp>
 #include <tables/rep_table.hpp>
 #include <tables/size_table.hpp>
 #include <tables/user_table.hpp>
+#include <tables/user_core_table.hpp>
+#include <user_core.hpp>
 
 using namespace eosio;
 using std::string;
@@ -15,7 +19,7 @@ namespace utils {
   const uint64_t moon_cycle = seconds_per_day * 29 + seconds_per_day / 2;
   const uint64_t proposal_cycle = moon_cycle;
 
-  symbol seeds_symbol = symbol("SEEDS", 4);
+  inline symbol seeds_symbol = symbol("SEEDS", 4);
 
   inline uint64_t rank(uint64_t current, uint64_t total) { 
     /**
@@ -36,6 +40,9 @@ namespace utils {
      * 
      * The count rebalances the next time we go over it, it's a dynamic system. 
      * 
+     * Ranks written at the moment a value changes come from rank_tree.hpp, which counts from a single consistent
+     * snapshot, so this only affects the catch up passes.
+     * 
      * The cheap way to fix it is to limit rank to 99
     */
 
@@ -66,23 +73,21 @@ namespace utils {
     return rep_score * 2.0 / 99.0; 
   }
 
-  double get_rep_multiplier(name account) {
+  inline double get_rep_multiplier(name account) {
 
     DEFINE_REP_TABLE
     DEFINE_REP_TABLE_MULTI_INDEX
 
-    DEFINE_USER_TABLE
-    DEFINE_USER_TABLE_MULTI_INDEX
+    DEFINE_USER_CORE_TABLE
 
-    user_tables users(contracts::accounts, contracts::accounts.value);
-    auto uitr = users.find(account.value);
+    user_core_table user;
     name scope;
 
-    if (uitr == users.end()) { return 0; }
+    if (!user_core::find(account, user)) { return 0; }
 
-    if (uitr->type == "individual"_n) {
+    if (user.type == "individual"_n) {
       scope = contracts::accounts;
-    } else if (uitr->type == "organisation"_n) {
+    } else if (user.type == "organisation"_n) {
       scope = "org"_n;
     }
     
@@ -98,7 +103,7 @@ namespace utils {
 
   }
 
-  uint64_t get_users_size() {
+  inline uint64_t get_users_size() {
 
     DEFINE_SIZE_TABLE
     DEFINE_SIZE_TABLE_MULTI_INDEX
@@ -109,7 +114,7 @@ namespace utils {
 
   }
 
-  uint64_t get_beginning_of_day_in_seconds() {
+  inline uint64_t get_beginning_of_day_in_seconds() {
     auto sec = eosio::current_time_point().sec_since_epoch();
     auto date = eosio::time_point_sec(sec / 86400 * 86400);
     return date.utc_seconds;
@@ -0,0 +1,393 @@
+// Runs the harvest scoring pipeline natively on synthetic populations and reports
+// the database work and estimated CPU of every chunk.
+//
+//   harvest_bench [--users 1000,10000,100000] [--batchsize 200] [--budget 2000]
+//                 [--payout 0] [--payout-unset] [--seed 1] [--check] [--instrument]
+//                 [--action-us 50] [--read-us 3] [--write-us 15] [--cpu-limit-us 30000]
+//
+// The CPU figures are an estimate: every action costs --action-us, every row read
+// --read-us and every row written --write-us. Calibrate them against a nodeos
+// replay before sizing batchsize from them. Native ms is host wall clock and
+// only useful to compare two runs on the same machine.
+//
+// --payout-unset removes hrvst.payout from settings, like a chain that was not
+// reset after the parameter was added.
+//
+// --instrument turns on instr.on and prints what the contracts recorded in their
+// actstats tables next to the stages, to check the on-chain counters against
+// the exact ones.
+
+#include <eosio/eosio.hpp>
+#include <contracts.hpp>
+#include <tables/action_stats_table.hpp>
+#include <tables/rank_tree_table.hpp>
+#include <rank_tree.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+  void apply_settings(uint64_t receiver, uint64_t code, uint64_t action);
+  void apply_accounts(uint64_t receiver, uint64_t code, uint64_t action);
+  void apply_history(uint64_t receiver, uint64_t code, uint64_t action);
+  void apply_harvest(uint64_t receiver, uint64_t code, uint64_t action);
+  void apply_token(uint64_t receiver, uint64_t code, uint64_t action);
+}
+
+using namespace eosio;
+
+namespace {
+
+  struct options {
+    std::vector<uint64_t> users = { 1000, 10000, 100000 };
+    uint64_t batchsize = 200;
+    uint64_t budget = 2000;
+    uint64_t payout = 0;
+    bool payout_unset = false;
+    uint64_t seed = 1;
+    bool check = false;
+    bool instrument = false;
+    double action_us = 50;
+    double read_us = 3;
+    double write_us = 15;
+    double cpu_limit_us = 30000;
+  };
+
+  struct stage_result {
+    std::string label;
+    uint64_t chunks = 0;
+    sim::usage work;
+    double cpu_us = 0;
+    double max_cpu_us = 0;
+    uint64_t over_limit = 0;
+    uint64_t chain_sec = 0;
+    double native_ms = 0;
+  };
+
+  const name issuer = bankaccts::campaigns;
+  const symbol seeds = symbol("SEEDS", 4);
+  // harvest distributions are paid in the test token minted by runharvest
+  const symbol harvest_symbol = symbol("TESTS", 4);
+
+  sim::chain & chain() { return sim::chain::instance(); }
+
+  // Names sort in the order they are generated, like accounts created one after another.
+  name user_name(uint64_t i) {
+    static const char * charset = "12345abcdefghijklmnopqrstuvwxyz";
+    std::string s(7, '1');
+    for (int p = 6; p >= 0; p--) {
+      s[p] = charset[i % 31];
+      i /= 31;
+    }
+    return name("bench" + s);
+  }
+
+  template<typename... Args>
+  void push(name actor, name contract, name act, Args... args) {
+    chain().push_action(action(permission_level{actor, "active"_n}, contract, act, std::make_tuple(args...)));
+  }
+
+  void configure(name param, uint64_t value) {
+    push(contracts::settings, contracts::settings, "configure"_n, param, value);
+  }
+
+  double cpu_of(const sim::usage & u, const options & opt) {
+    uint64_t written = u.rows_modified + u.rows_emplaced + u.rows_erased;
+    return u.actions * opt.action_us + u.rows_read * opt.read_us + written * opt.write_us;
+  }
+
+  void deploy() {
+    chain().deploy(contracts::settings, apply_settings);
+    chain().deploy(contracts::accounts, apply_accounts);
+    chain().deploy(contracts::history, apply_history);
+    chain().deploy(contracts::harvest, apply_harvest);
+    chain().deploy(contracts::token, apply_token);
+    chain().create_account(issuer);
+    chain().create_account(contracts::bank);
+  }
+
+  // Every user gets a reputation and community building score, plants part of
+  // what they are sent and makes one or two transfers to other users.
+  void populate(uint64_t count, const options & opt) {
+    std::mt19937_64 rng(opt.seed);
+
+    push(contracts::settings, contracts::settings, "reset"_n);
+    configure("batchsize"_n, opt.batchsize);
+    configure("rank.budget"_n, opt.budget);
+    configure("hrvst.payout"_n, opt.payout);
+    configure("instr.on"_n, opt.instrument ? 1 : 0);
+
+    if (opt.payout_unset) {
+      chain().find_table(sim::table_id{ contracts::settings.value, contracts::settings.value, "config"_n.value })->rows.erase("hrvst.payout"_n.value);
+      push(contracts::settings, contracts::settings, "publishconf"_n);
+    }
+
+    push(contracts::token, contracts::token, "create"_n, issuer, asset(int64_t(1) << 60, seeds));
+    push(issuer, contracts::token, "issue"_n, issuer, asset(int64_t(1) << 59, seeds), std::string(""));
+    push(contracts::token, contracts::token, "create"_n, contracts::token, asset(int64_t(1) << 60, harvest_symbol));
+    push(contracts::token, contracts::token, "addpayer"_n, contracts::harvest);
+
+    // initranks over the empty tables marks the rank trees built, as on a fresh deployment
+    for (name tree : { "rep"_n, "org.rep"_n, "cbs"_n, "org.cbs"_n }) {
+      push(contracts::accounts, contracts::accounts, "initranks"_n, tree, uint64_t(0));
+    }
+    for (name tree : { "planted"_n, "txpt"_n, "org.txpt"_n }) {
+      push(contracts::harvest, contracts::harvest, "initranks"_n, tree, uint64_t(0));
+    }
+
+    for (uint64_t i = 0; i < count; i++) {
+      name user = user_name(i);
+      chain().create_account(user);
+      push(contracts::accounts, contracts::accounts, "adduser"_n, user, std::string(""), "individual"_n);
+      push(contracts::accounts, contracts::accounts, "testsetrs"_n, user, uint64_t(rng() % 100));
+      push(contracts::accounts, contracts::accounts, "testsetcbs"_n, user, uint64_t(rng() % 50));
+
+      int64_t funds = int64_t(10000) * int64_t(1000 + rng() % 10000);
+      push(issuer, contracts::token, "transfer"_n, issuer, user, asset(funds, seeds), std::string(""));
+      push(user, contracts::token, "transfer"_n, user, contracts::harvest, asset(funds / 2, seeds), std::string(""));
+    }
+
+    for (uint64_t i = 0; i < count && count > 1; i++) {
+      name from = user_name(i);
+      uint64_t transfers = 1 + rng() % 2;
+      for (uint64_t t = 0; t < transfers; t++) {
+        uint64_t j = rng() % count;
+        if (j == i) continue;
+        int64_t amount = int64_t(10000) * int64_t(1 + rng() % 200);
+        push(from, contracts::token, "transfer"_n, from, user_name(j), asset(amount, seeds), std::string(""));
+      }
+    }
+
+    chain().drain_deferred();
+  }
+
+  // Pushes the stage's entry action, then delivers its deferred continuations one
+  // transaction at a time. Each transaction is one chunk.
+  template<typename... Args>
+  stage_result run_stage(const options & opt, const std::string & label, name act, Args... args) {
+    stage_result r;
+    r.label = label;
+
+    uint64_t started = chain().now().sec_since_epoch();
+    auto wall = std::chrono::steady_clock::now();
+
+    auto record = [&](const sim::usage & before, std::chrono::steady_clock::time_point t0) {
+      sim::usage chunk = chain().stats() - before;
+      double cpu = cpu_of(chunk, opt);
+      r.chunks++;
+      r.work += chunk;
+      r.cpu_us += cpu;
+      r.max_cpu_us = std::max(r.max_cpu_us, cpu);
+      if (cpu > opt.cpu_limit_us) r.over_limit++;
+      r.native_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    sim::usage before = chain().stats();
+    auto t0 = std::chrono::steady_clock::now();
+    try {
+      push(contracts::harvest, contracts::harvest, act, args...);
+    } catch (const check_failure & e) {
+      std::fprintf(stderr, "%s failed: %s\n", label.c_str(), e.what());
+    }
+    record(before, t0);
+
+    while (chain().deferred_count() > 0) {
+      before = chain().stats();
+      t0 = std::chrono::steady_clock::now();
+      chain().drain_deferred(1);
+      record(before, t0);
+    }
+
+    r.chain_sec = chain().now().sec_since_epoch() - started;
+    r.native_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall).count();
+    return r;
+  }
+
+  void print_row(const stage_result & r) {
+    uint64_t written = r.work.rows_modified + r.work.rows_emplaced + r.work.rows_erased;
+    std::printf("  %-14s %8llu %12llu %12llu %10.2f %10.2f %6llu %8llu %10.1f\n",
+      r.label.c_str(),
+      (unsigned long long)r.chunks,
+      (unsigned long long)r.work.rows_read,
+      (unsigned long long)written,
+      r.chunks ? r.cpu_us / r.chunks / 1000.0 : 0.0,
+      r.max_cpu_us / 1000.0,
+      (unsigned long long)r.over_limit,
+      (unsigned long long)r.chain_sec,
+      r.native_ms);
+  }
+
+  DEFINE_ACTION_STATS_TABLE
+  DEFINE_ACTION_STATS_TABLE_MULTI_INDEX
+
+  void print_action_stats(name contract) {
+    action_stats_tables stats(contract, contract.value);
+    for (const auto & s : stats) {
+      std::printf("  %-26s calls %6llu  rows read %10llu  written %10llu  reads p50 %u p99 %u, writes p50 %u p99 %u\n",
+        (contract.to_string() + "::" + s.action.to_string()).c_str(),
+        (unsigned long long)s.calls,
+        (unsigned long long)s.rows_read,
+        (unsigned long long)(s.rows_modified + s.rows_emplaced + s.rows_erased),
+        s.p50_reads, s.p99_reads, s.p50_writes, s.p99_writes);
+    }
+  }
+
+  uint64_t count_rows(name code, name scope, name table) {
+    auto t = chain().find_table(sim::table_id{ code.value, scope.value, table.value });
+    return t ? t->rows.size() : 0;
+  }
+
+  DEFINE_RANK_TREE_TABLE
+  DEFINE_RANK_TREE_TABLE_MULTI_INDEX
+
+  // The incrementally kept rank tree has to hold exactly one value per row of its table.
+  bool check_tree(name code, name tree, name scope, name table) {
+    rank_tree_tables ranktree(code, tree.value);
+    uint64_t in_tree = rank_tree::total(ranktree);
+    uint64_t rows = count_rows(code, scope, table);
+    if (!rank_tree::ready(ranktree) || in_tree != rows) {
+      std::fprintf(stderr, "check: rank tree %s holds %llu values for %llu %s rows\n", tree.to_string().c_str(),
+        (unsigned long long)in_tree, (unsigned long long)rows, table.to_string().c_str());
+      return false;
+    }
+    return true;
+  }
+
+  bool run(uint64_t count, const options & opt) {
+    chain().clear_tables();
+    chain().reset_stats();
+
+    auto wall = std::chrono::steady_clock::now();
+    populate(count, opt);
+    double setup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall).count();
+
+    std::printf("users %llu  batchsize %llu  rank.budget %llu  hrvst.payout %llu  (setup %.0f ms, %llu transactions)\n",
+      (unsigned long long)count, (unsigned long long)opt.batchsize, (unsigned long long)opt.budget,
+      (unsigned long long)opt.payout, setup_ms, (unsigned long long)chain().stats().transactions);
+    std::printf("  %-14s %8s %12s %12s %10s %10s %6s %8s %10s\n",
+      "stage", "chunks", "rows read", "rows written", "avg cpu ms", "max cpu ms", "> lim", "chain s", "native ms");
+
+    asset payout_total = asset(int64_t(10000) * int64_t(count), harvest_symbol);
+    uint64_t chunksize = opt.payout == 0 ? 10 : opt.batchsize;
+    push(contracts::token, contracts::token, "minttst"_n, contracts::harvest, payout_total, std::string("harvest"));
+
+    std::vector<stage_result> results;
+    results.push_back(run_stage(opt, "calctrxpt", "calctrxpts"_n));
+    results.push_back(run_stage(opt, "ranktx", "ranktxs"_n));
+    results.push_back(run_stage(opt, "rankplanted", "rankplanteds"_n));
+    results.push_back(run_stage(opt, "calccs", "calccss"_n));
+    results.push_back(run_stage(opt, "rankcs", "rankcss"_n));
+    results.push_back(run_stage(opt, "disthvstusrs", "disthvstusrs"_n, uint64_t(0), chunksize, payout_total));
+
+    stage_result total;
+    total.label = "total";
+    for (const auto & r : results) {
+      print_row(r);
+      total.chunks += r.chunks;
+      total.work += r.work;
+      total.cpu_us += r.cpu_us;
+      total.max_cpu_us = std::max(total.max_cpu_us, r.max_cpu_us);
+      total.over_limit += r.over_limit;
+      total.chain_sec += r.chain_sec;
+      total.native_ms += r.native_ms;
+    }
+    print_row(total);
+    std::printf("\n");
+
+    if (opt.instrument) {
+      std::printf("  actstats\n");
+      print_action_stats(contracts::harvest);
+      print_action_stats(contracts::accounts);
+      std::printf("\n");
+    }
+
+    if (!opt.check) return true;
+
+    bool ok = total.work.failed_transactions == 0;
+    if (!ok) std::fprintf(stderr, "check: %llu transactions failed, last error: %s\n",
+      (unsigned long long)total.work.failed_transactions, chain().last_deferred_error().c_str());
+
+    uint64_t scored = count_rows(contracts::harvest, contracts::harvest, "cspoints"_n);
+    if (scored == 0 || scored > count) {
+      std::fprintf(stderr, "check: %llu contribution scores for %llu users\n", (unsigned long long)scored, (unsigned long long)count);
+      ok = false;
+    }
+
+    // claim leaves the harvest in the ledger, transfer and settle pay it all out
+    uint64_t unpaid = count_rows(contracts::harvest, contracts::harvest, "claimable"_n);
+    if ((opt.payout == 1) != (unpaid > 0)) {
+      std::fprintf(stderr, "check: %llu claimable balances left with hrvst.payout %llu\n", (unsigned long long)unpaid, (unsigned long long)opt.payout);
+      ok = false;
+    }
+
+    ok = check_tree(contracts::accounts, "rep"_n, contracts::accounts, "rep"_n) && ok;
+    ok = check_tree(contracts::accounts, "cbs"_n, contracts::accounts, "cbs"_n) && ok;
+    ok = check_tree(contracts::harvest, "planted"_n, contracts::harvest, "planted"_n) && ok;
+    ok = check_tree(contracts::harvest, "txpt"_n, contracts::harvest, "txpoints"_n) && ok;
+
+    return ok;
+  }
+
+  std::vector<uint64_t> parse_list(const std::string & s) {
+    std::vector<uint64_t> values;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+      if (!item.empty()) values.push_back(std::strtoull(item.c_str(), nullptr, 10));
+    }
+    return values;
+  }
+
+}
+
+int main(int argc, char ** argv) {
+  options opt;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto value = [&]() -> std::string {
+      if (i + 1 >= argc) {
+        std::fprintf(stderr, "missing value for %s\n", arg.c_str());
+        std::exit(2);
+      }
+      return argv[++i];
+    };
+
+    if (arg == "--users") opt.users = parse_list(value());
+    else if (arg == "--batchsize") opt.batchsize = std::strtoull(value().c_str(), nullptr, 10);
+    else if (arg == "--budget") opt.budget = std::strtoull(value().c_str(), nullptr, 10);
+    else if (arg == "--payout") opt.payout = std::strtoull(value().c_str(), nullptr, 10);
+    else if (arg == "--seed") opt.seed = std::strtoull(value().c_str(), nullptr, 10);
+    else if (arg == "--action-us") opt.action_us = std::atof(value().c_str());
+    else if (arg == "--read-us") opt.read_us = std::atof(value().c_str());
+    else if (arg == "--write-us") opt.write_us = std::atof(value().c_str());
+    else if (arg == "--cpu-limit-us") opt.cpu_limit_us = std::atof(value().c_str());
+    else if (arg == "--payout-unset") opt.payout_unset = true;
+    else if (arg == "--check") opt.check = true;
+    else if (arg == "--instrument") opt.instrument = true;
+    else {
+      std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+      return 2;
+    }
+  }
+
+  deploy();
+
+  bool ok = true;
+  for (uint64_t count : opt.users) {
+    try {
+      ok = run(count, opt) && ok;
+    } catch (const check_failure & e) {
+      std::fprintf(stderr, "users %llu: setup failed: %s\n", (unsigned long long)count, e.what());
+      ok = false;
+    }
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <eosio/serialize.hpp>
+
+#include <tuple>
+#include <vector>
+
+namespace eosio {
+
+  struct permission_level {
+    permission_level(name a, name p) : actor(a), permission(p) {}
+    permission_level() {}
+    name actor;
+    name permission;
+    friend bool operator==(const permission_level& a, const permission_level& b) {
+      return a.actor == b.actor && a.permission == b.permission;
+    }
+    friend bool operator<(const permission_level& a, const permission_level& b) {
+      return std::tie(a.actor, a.permission) < std::tie(b.actor, b.permission);
+    }
+  };
+
+  struct action {
+    eosio::name account;
+    eosio::name name;
+    std::vector<permission_level> authorization;
+    std::vector<char> data;
+
+    action() = default;
+
+    template<typename T>
+    action(const permission_level& auth, eosio::name a, eosio::name n, T&& value)
+      : account(a), name(n), authorization(1, auth), data(pack(std::forward<T>(value))) {}
+
+    template<typename T>
+    action(std::vector<permission_level> auths, eosio::name a, eosio::name n, T&& value)
+      : account(a), name(n), authorization(std::move(auths)), data(pack(std::forward<T>(value))) {}
+
+    void send() const;
+    void send_context_free() const { send(); }
+
+    template<typename T>
+    T data_as() const { return unpack<T>(&data[0], data.size()); }
+  };
+
+  namespace detail {
+    template<typename T> struct member_args;
+    template<typename C, typename R, typename... Args>
+    struct member_args<R (C::*)(Args...)> {
+      using contract_type = C;
+      using type = std::tuple<std::decay_t<Args>...>;
+    };
+    template<typename C, typename R, typename... Args>
+    struct member_args<R (C::*)(Args...) const> : member_args<R (C::*)(Args...)> {};
+  }
+
+  template<eosio::name::raw Name, auto Action>
+  struct action_wrapper {
+    using args_type = typename detail::member_args<decltype(Action)>::type;
+    static constexpr eosio::name action_name = eosio::name(Name);
+
+    action_wrapper(eosio::name code, const std::vector<permission_level>& perms) : code_name(code), permissions(perms) {}
+    action_wrapper(eosio::name code, const permission_level& perm) : code_name(code), permissions(1, perm) {}
+    action_wrapper(eosio::name code) : code_name(code) {}
+
+    template<typename... Args>
+    action to_action(Args&&... args) const {
+      static_assert(sizeof...(Args) == std::tuple_size<args_type>::value);
+      return action(permissions, code_name, action_name, args_type(std::forward<Args>(args)...));
+    }
+
+    template<typename... Args>
+    void send(Args&&... args) const { to_action(std::forward<Args>(args)...).send(); }
+
+    template<typename... Args>
+    void send_context_free(Args&&... args) const { send(std::forward<Args>(args)...); }
+
+    eosio::name code_name;
+    std::vector<permission_level> permissions;
+  };
+
+  class transaction {
+    public:
+      transaction(time_point_sec exp = time_point_sec()) : expiration(exp) {}
+      void send(const __uint128_t& sender_id, name payer, bool replace_existing = false) const;
+
+      time_point_sec expiration;
+      uint16_t ref_block_num = 0;
+      uint32_t ref_block_prefix = 0;
+      uint32_t max_net_usage_words = 0;
+      uint8_t max_cpu_usage_ms = 0;
+      uint32_t delay_sec = 0;
+      std::vector<action> context_free_actions;
+      std::vector<action> actions;
+  };
+
+  int cancel_deferred(const __uint128_t& sender_id);
+
+} // namespace eosio
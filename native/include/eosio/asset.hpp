@@ -0,0 +1,89 @@
+#pragma once
+
+#include <eosio/symbol.hpp>
+#include <string>
+
+namespace eosio {
+
+  struct asset {
+    static constexpr int64_t max_amount = (1LL << 62) - 1;
+
+    int64_t amount = 0;
+    eosio::symbol symbol;
+
+    asset() {}
+    asset(int64_t a, class symbol s) : amount(a), symbol{s} {
+      eosio::check(is_amount_within_range(), "magnitude of asset amount must be less than 2^62");
+      eosio::check(symbol.is_valid(), "invalid symbol name");
+    }
+
+    bool is_amount_within_range() const { return -max_amount <= amount && amount <= max_amount; }
+    bool is_valid() const { return is_amount_within_range() && symbol.is_valid(); }
+    void set_amount(int64_t a) { amount = a; }
+
+    asset operator-() const { asset r = *this; r.amount = -r.amount; return r; }
+
+    asset& operator-=(const asset& a) {
+      eosio::check(a.symbol == symbol, "attempt to subtract asset with different symbol");
+      amount -= a.amount;
+      eosio::check(-max_amount <= amount, "subtraction underflow");
+      eosio::check(amount <= max_amount, "subtraction overflow");
+      return *this;
+    }
+    asset& operator+=(const asset& a) {
+      eosio::check(a.symbol == symbol, "attempt to add asset with different symbol");
+      amount += a.amount;
+      eosio::check(-max_amount <= amount, "addition underflow");
+      eosio::check(amount <= max_amount, "addition overflow");
+      return *this;
+    }
+    friend asset operator+(const asset& a, const asset& b) { asset r = a; r += b; return r; }
+    friend asset operator-(const asset& a, const asset& b) { asset r = a; r -= b; return r; }
+    asset& operator*=(int64_t a) { amount *= a; return *this; }
+    friend asset operator*(const asset& a, int64_t b) { asset r = a; r *= b; return r; }
+    friend asset operator*(int64_t b, const asset& a) { asset r = a; r *= b; return r; }
+    asset& operator/=(int64_t a) {
+      eosio::check(a != 0, "divide by zero");
+      amount /= a;
+      return *this;
+    }
+    friend asset operator/(const asset& a, int64_t b) { asset r = a; r /= b; return r; }
+    friend int64_t operator/(const asset& a, const asset& b) {
+      eosio::check(b.amount != 0, "divide by zero");
+      eosio::check(a.symbol == b.symbol, "comparison of assets with different symbols is not allowed");
+      return a.amount / b.amount;
+    }
+    friend bool operator==(const asset& a, const asset& b) {
+      eosio::check(a.symbol == b.symbol, "comparison of assets with different symbols is not allowed");
+      return a.amount == b.amount;
+    }
+    friend bool operator!=(const asset& a, const asset& b) { return !(a == b); }
+    friend bool operator<(const asset& a, const asset& b) {
+      eosio::check(a.symbol == b.symbol, "comparison of assets with different symbols is not allowed");
+      return a.amount < b.amount;
+    }
+    friend bool operator<=(const asset& a, const asset& b) { return a < b || a == b; }
+    friend bool operator>(const asset& a, const asset& b) { return b < a; }
+    friend bool operator>=(const asset& a, const asset& b) { return b <= a; }
+
+    std::string to_string() const {
+      int64_t p = symbol.precision();
+      int64_t div = 1;
+      for (int64_t i = 0; i < p; i++) div *= 10;
+      bool neg = amount < 0;
+      uint64_t a = neg ? uint64_t(-amount) : uint64_t(amount);
+      std::string s = std::to_string(a / div);
+      if (p > 0) {
+        std::string frac = std::to_string(a % div);
+        s += "." + std::string(p - frac.size(), '0') + frac;
+      }
+      return (neg ? "-" : "") + s + " " + symbol.code().to_string();
+    }
+  };
+
+  struct extended_asset {
+    asset quantity;
+    name contract;
+  };
+
+} // namespace eosio
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <eosio/name.hpp>
+
+namespace eosio {
+
+  // Fixed-size digest; ordered like the chain's two 128-bit words so it can
+  // serve as a secondary key.
+  template<size_t Size>
+  class fixed_bytes {
+    public:
+      fixed_bytes() { _data.fill(0); }
+      explicit fixed_bytes(const std::array<uint8_t, Size>& a) : _data(a) {}
+      const uint8_t* data() const { return _data.data(); }
+      uint8_t* data() { return _data.data(); }
+      static constexpr size_t size() { return Size; }
+      std::array<uint8_t, Size> extract_as_byte_array() const { return _data; }
+      friend bool operator==(const fixed_bytes& a, const fixed_bytes& b) { return a._data == b._data; }
+      friend bool operator!=(const fixed_bytes& a, const fixed_bytes& b) { return a._data != b._data; }
+      friend bool operator<(const fixed_bytes& a, const fixed_bytes& b) { return a._data < b._data; }
+      friend bool operator>(const fixed_bytes& a, const fixed_bytes& b) { return b._data < a._data; }
+      friend bool operator<=(const fixed_bytes& a, const fixed_bytes& b) { return !(b._data < a._data); }
+      friend bool operator>=(const fixed_bytes& a, const fixed_bytes& b) { return !(a._data < b._data); }
+      std::array<uint8_t, Size> _data;
+  };
+
+  using checksum160 = fixed_bytes<20>;
+  using checksum256 = fixed_bytes<32>;
+  using checksum512 = fixed_bytes<64>;
+
+  // Not a cryptographic digest: the host build only needs a stable,
+  // well-spread value to key rows with.
+  inline checksum256 sha256(const char* data, uint32_t length) {
+    checksum256 out;
+    uint64_t h[4] = { 0xcbf29ce484222325ull, 0x84222325cbf29ce4ull, 0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full };
+    for (int lane = 0; lane < 4; lane++) {
+      for (uint32_t i = 0; i < length; i++) {
+        h[lane] ^= uint8_t(data[i]);
+        h[lane] *= 0x100000001b3ull + 2 * lane;
+      }
+      for (int b = 0; b < 8; b++) out._data[lane * 8 + b] = uint8_t(h[lane] >> (56 - 8 * b));
+    }
+    return out;
+  }
+
+  inline void assert_sha256(const char* data, uint32_t length, const checksum256& hash) {
+    check(sha256(data, length) == hash, "hash mismatch");
+  }
+
+} // namespace eosio
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+namespace eosio { namespace detail {
+// generated: structured-binding based field visitation for aggregates
+template<std::size_t N, typename T, typename F> void visit_fields_n(T& obj, F&& f) {
+  if constexpr (N == 0) { (void)obj; (void)f; }
+  else if constexpr (N == 1) { auto& [m0] = obj; f(m0); }
+  else if constexpr (N == 2) { auto& [m0,m1] = obj; f(m0);f(m1); }
+  else if constexpr (N == 3) { auto& [m0,m1,m2] = obj; f(m0);f(m1);f(m2); }
+  else if constexpr (N == 4) { auto& [m0,m1,m2,m3] = obj; f(m0);f(m1);f(m2);f(m3); }
+  else if constexpr (N == 5) { auto& [m0,m1,m2,m3,m4] = obj; f(m0);f(m1);f(m2);f(m3);f(m4); }
+  else if constexpr (N == 6) { auto& [m0,m1,m2,m3,m4,m5] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5); }
+  else if constexpr (N == 7) { auto& [m0,m1,m2,m3,m4,m5,m6] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6); }
+  else if constexpr (N == 8) { auto& [m0,m1,m2,m3,m4,m5,m6,m7] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7); }
+  else if constexpr (N == 9) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8); }
+  else if constexpr (N == 10) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9); }
+  else if constexpr (N == 11) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10); }
+  else if constexpr (N == 12) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11); }
+  else if constexpr (N == 13) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12); }
+  else if constexpr (N == 14) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13); }
+  else if constexpr (N == 15) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14); }
+  else if constexpr (N == 16) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15); }
+  else if constexpr (N == 17) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16); }
+  else if constexpr (N == 18) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17); }
+  else if constexpr (N == 19) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18); }
+  else if constexpr (N == 20) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19); }
+  else if constexpr (N == 21) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20); }
+  else if constexpr (N == 22) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21); }
+  else if constexpr (N == 23) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22); }
+  else if constexpr (N == 24) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23); }
+  else if constexpr (N == 25) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24); }
+  else if constexpr (N == 26) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25); }
+  else if constexpr (N == 27) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26); }
+  else if constexpr (N == 28) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27); }
+  else if constexpr (N == 29) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28); }
+  else if constexpr (N == 30) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29); }
+  else if constexpr (N == 31) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30); }
+  else if constexpr (N == 32) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31); }
+  else if constexpr (N == 33) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32); }
+  else if constexpr (N == 34) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33); }
+  else if constexpr (N == 35) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34); }
+  else if constexpr (N == 36) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35); }
+  else if constexpr (N == 37) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36); }
+  else if constexpr (N == 38) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37); }
+  else if constexpr (N == 39) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38); }
+  else if constexpr (N == 40) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38,m39] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38);f(m39); }
+  else if constexpr (N == 41) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38,m39,m40] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38);f(m39);f(m40); }
+  else if constexpr (N == 42) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38,m39,m40,m41] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38);f(m39);f(m40);f(m41); }
+  else if constexpr (N == 43) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38,m39,m40,m41,m42] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38);f(m39);f(m40);f(m41);f(m42); }
+  else if constexpr (N == 44) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38,m39,m40,m41,m42,m43] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38);f(m39);f(m40);f(m41);f(m42);f(m43); }
+  else if constexpr (N == 45) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38,m39,m40,m41,m42,m43,m44] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38);f(m39);f(m40);f(m41);f(m42);f(m43);f(m44); }
+  else if constexpr (N == 46) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38,m39,m40,m41,m42,m43,m44,m45] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38);f(m39);f(m40);f(m41);f(m42);f(m43);f(m44);f(m45); }
+  else if constexpr (N == 47) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38,m39,m40,m41,m42,m43,m44,m45,m46] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38);f(m39);f(m40);f(m41);f(m42);f(m43);f(m44);f(m45);f(m46); }
+  else if constexpr (N == 48) { auto& [m0,m1,m2,m3,m4,m5,m6,m7,m8,m9,m10,m11,m12,m13,m14,m15,m16,m17,m18,m19,m20,m21,m22,m23,m24,m25,m26,m27,m28,m29,m30,m31,m32,m33,m34,m35,m36,m37,m38,m39,m40,m41,m42,m43,m44,m45,m46,m47] = obj; f(m0);f(m1);f(m2);f(m3);f(m4);f(m5);f(m6);f(m7);f(m8);f(m9);f(m10);f(m11);f(m12);f(m13);f(m14);f(m15);f(m16);f(m17);f(m18);f(m19);f(m20);f(m21);f(m22);f(m23);f(m24);f(m25);f(m26);f(m27);f(m28);f(m29);f(m30);f(m31);f(m32);f(m33);f(m34);f(m35);f(m36);f(m37);f(m38);f(m39);f(m40);f(m41);f(m42);f(m43);f(m44);f(m45);f(m46);f(m47); }
+  else { static_assert(N <= 48, "too many fields"); }
+}
+} }
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <eosio/contract.hpp>
+
+namespace eosio {
+
+  template<typename T, typename... Args>
+  bool execute_action(name self, name code, void (T::*func)(Args...)) {
+    const auto& data = sim::chain::instance().action_data();
+    datastream<const char*> ds(data.data(), data.size());
+    std::tuple<std::decay_t<Args>...> args;
+    unpack_value(ds, args);
+    T inst(self, code, ds);
+    std::apply([&](auto&&... a) { (inst.*func)(a...); }, args);
+    return true;
+  }
+
+} // namespace eosio
+
+#define SIM_DISPATCH_CAT(a, b) SIM_DISPATCH_CAT_I(a, b)
+#define SIM_DISPATCH_CAT_I(a, b) a##b
+#define SIM_DISPATCH_CASE(member) \
+  case eosio::name(#member).value: \
+    eosio::execute_action(eosio::name(receiver), eosio::name(code), &sim_dispatch_type::member); \
+    break;
+#define SIM_DISPATCH_A(member) SIM_DISPATCH_CASE(member) SIM_DISPATCH_B
+#define SIM_DISPATCH_B(member) SIM_DISPATCH_CASE(member) SIM_DISPATCH_A
+#define SIM_DISPATCH_A_END
+#define SIM_DISPATCH_B_END
+
+#define EOSIO_DISPATCH_HELPER(TYPE, MEMBERS) \
+  using sim_dispatch_type = TYPE; \
+  SIM_DISPATCH_CAT(SIM_DISPATCH_A MEMBERS, _END)
+
+#define EOSIO_DISPATCH(TYPE, MEMBERS) \
+  extern "C" { \
+    void apply(uint64_t receiver, uint64_t code, uint64_t action) { \
+      if (code == receiver) { \
+        switch (action) { \
+          EOSIO_DISPATCH_HELPER(TYPE, MEMBERS) \
+        } \
+      } \
+    } \
+  }
@@ -0,0 +1,426 @@
+#pragma once
+
+// In-memory chain used when the contracts are compiled natively. It keeps
+// serialized rows per (code, scope, table) so that contracts reading each
+// other's tables see the same bytes they would on chain, runs inline actions
+// depth-first after the sending action, queues deferred transactions with
+// their sender_id/replace semantics, and rolls back a failed transaction.
+
+#include <eosio/action.hpp>
+#include <eosio/print.hpp>
+
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace eosio {
+
+  struct check_failure : std::runtime_error {
+    using std::runtime_error::runtime_error;
+  };
+
+  inline void check(bool pred, const char* msg) {
+    if (!pred) throw check_failure(msg);
+  }
+
+  inline void check(bool pred, const std::string& msg) {
+    if (!pred) throw check_failure(msg);
+  }
+
+  inline void check(bool pred, uint64_t code) {
+    if (!pred) throw check_failure("error code " + std::to_string(code));
+  }
+
+  namespace sim {
+
+    static constexpr size_t max_secondary_indices = 16;
+
+    struct table_id {
+      uint64_t code;
+      uint64_t scope;
+      uint64_t table;
+      friend bool operator<(const table_id& a, const table_id& b) {
+        return std::tie(a.code, a.scope, a.table) < std::tie(b.code, b.scope, b.table);
+      }
+    };
+
+    struct stored_row {
+      std::vector<char> bytes;
+      name payer;
+      std::array<std::string, max_secondary_indices> keys;
+    };
+
+    struct table_data {
+      std::map<uint64_t, stored_row> rows;
+      std::array<std::set<std::pair<std::string, uint64_t>>, max_secondary_indices> secondary;
+      uint8_t index_count = 0;
+    };
+
+    // Database work done on behalf of contracts. rows_read counts every row a
+    // lookup or iterator step lands on, the way the chain bills db_*_i64 calls.
+    struct usage {
+      uint64_t rows_read = 0;
+      uint64_t rows_modified = 0;
+      uint64_t rows_emplaced = 0;
+      uint64_t rows_erased = 0;
+      uint64_t bytes_written = 0;
+      uint64_t actions = 0;
+      uint64_t inline_sent = 0;
+      uint64_t deferred_sent = 0;
+      uint64_t deferred_cancelled = 0;
+      uint64_t transactions = 0;
+      uint64_t failed_transactions = 0;
+
+      usage& operator+=(const usage& o) {
+        rows_read += o.rows_read; rows_modified += o.rows_modified;
+        rows_emplaced += o.rows_emplaced; rows_erased += o.rows_erased;
+        bytes_written += o.bytes_written; actions += o.actions;
+        inline_sent += o.inline_sent; deferred_sent += o.deferred_sent;
+        deferred_cancelled += o.deferred_cancelled; transactions += o.transactions;
+        failed_transactions += o.failed_transactions;
+        return *this;
+      }
+      friend usage operator-(usage a, const usage& b) {
+        a.rows_read -= b.rows_read; a.rows_modified -= b.rows_modified;
+        a.rows_emplaced -= b.rows_emplaced; a.rows_erased -= b.rows_erased;
+        a.bytes_written -= b.bytes_written; a.actions -= b.actions;
+        a.inline_sent -= b.inline_sent; a.deferred_sent -= b.deferred_sent;
+        a.deferred_cancelled -= b.deferred_cancelled; a.transactions -= b.transactions;
+        a.failed_transactions -= b.failed_transactions;
+        return a;
+      }
+    };
+
+    struct deferred_entry {
+      name sender;
+      __uint128_t sender_id;
+      name payer;
+      time_point deliver_at;
+      uint64_t sequence;
+      std::vector<action> actions;
+    };
+
+    using apply_handler = void (*)(uint64_t receiver, uint64_t code, uint64_t action);
+
+    class chain {
+      public:
+        static chain& instance() {
+          static chain c;
+          return c;
+        }
+
+        // --- accounts and code -------------------------------------------------
+
+        void create_account(name account) { _accounts.insert(account.value); }
+        bool is_account(name account) const { return _accounts.count(account.value) > 0; }
+
+        void deploy(name account, apply_handler handler) {
+          create_account(account);
+          _contracts[account.value] = handler;
+        }
+
+        // --- clock -------------------------------------------------------------
+
+        time_point now() const { return _now; }
+        void set_time(time_point t) { _now = t; }
+
+        // --- transactions ------------------------------------------------------
+
+        // Runs the actions as one transaction. On a failed check() every row
+        // and deferred change made by the transaction is undone and the
+        // failure is rethrown.
+        void push_transaction(const std::vector<action>& actions) {
+          check(_undo == nullptr, "nested transaction");
+          std::vector<undo_entry> undo;
+          _deferred_saved = false;
+          _undo = &undo;
+          _usage.transactions++;
+          try {
+            for (const auto& a : actions) dispatch(a, a.account, 0);
+          } catch (...) {
+            rollback(undo);
+            if (_deferred_saved) {
+              _deferred = std::move(_deferred_before);
+              _deferred_order = std::move(_deferred_order_before);
+            }
+            _undo = nullptr;
+            _contexts.clear();
+            _usage.failed_transactions++;
+            throw;
+          }
+          _undo = nullptr;
+        }
+
+        void push_action(const action& a) { push_transaction({a}); }
+
+        // Delivers deferred transactions due at or before `until`, moving the
+        // clock to each one's delivery time. Failed deferred transactions are
+        // dropped, as the chain would after sending onerror. Returns the number
+        // of transactions delivered.
+        uint64_t run_deferred(time_point until, uint64_t max_transactions = UINT64_MAX) {
+          uint64_t delivered = 0;
+          while (delivered < max_transactions) {
+            auto next = next_deferred();
+            if (next == _deferred.end() || next->second.deliver_at > until) break;
+            deferred_entry entry = std::move(next->second);
+            unlink_order(entry);
+            _deferred.erase(next);
+            if (entry.deliver_at > _now) _now = entry.deliver_at;
+            try {
+              push_transaction(entry.actions);
+            } catch (const check_failure& e) {
+              _last_deferred_error = e.what();
+            }
+            delivered++;
+          }
+          if (until > _now && until != time_point(microseconds(INT64_MAX))) _now = until;
+          return delivered;
+        }
+
+        // Delivers deferred transactions until none are left or the limit is
+        // reached, without bounding the clock.
+        uint64_t drain_deferred(uint64_t max_transactions = UINT64_MAX) {
+          return run_deferred(time_point(microseconds(INT64_MAX)), max_transactions);
+        }
+
+        size_t deferred_count() const { return _deferred.size(); }
+        const std::string& last_deferred_error() const { return _last_deferred_error; }
+
+        // --- statistics --------------------------------------------------------
+
+        usage& stats() { return _usage; }
+        void reset_stats() { _usage = usage(); }
+
+        // --- interface used by the eosio stand-in headers -----------------------
+
+        struct action_context {
+          name receiver;
+          const action* act;
+          std::vector<name> notified;
+          std::vector<action> inlines;
+        };
+
+        action_context& context() {
+          check(!_contexts.empty(), "no action is executing");
+          return *_contexts.back();
+        }
+        bool in_action() const { return !_contexts.empty(); }
+
+        void send_inline(const action& a) {
+          context().inlines.push_back(a);
+          _usage.inline_sent++;
+        }
+
+        void send_deferred(const __uint128_t& sender_id, name payer, const transaction& trx, bool replace) {
+          save_deferred();
+          name sender = context().receiver;
+          auto key = std::make_pair(sender.value, sender_id);
+          auto itr = _deferred.find(key);
+          check(itr == _deferred.end() || replace,
+                "deferred transaction with the same sender_id and payer already exists");
+          if (itr != _deferred.end()) unlink_order(itr->second);
+          deferred_entry entry{ sender, sender_id, payer, _now + seconds(trx.delay_sec), _deferred_sequence++, trx.actions };
+          _deferred_order[order_key(entry.deliver_at.elapsed.count(), entry.sequence)] = key;
+          _deferred[key] = std::move(entry);
+          _usage.deferred_sent++;
+        }
+
+        bool cancel_deferred(const __uint128_t& sender_id) {
+          auto key = std::make_pair(context().receiver.value, sender_id);
+          auto itr = _deferred.find(key);
+          if (itr == _deferred.end()) return false;
+          save_deferred();
+          itr = _deferred.find(key);
+          unlink_order(itr->second);
+          _deferred.erase(itr);
+          _usage.deferred_cancelled++;
+          return true;
+        }
+
+        bool has_auth(name account) const {
+          if (_contexts.empty()) return false;
+          for (const auto& p : _contexts.back()->act->authorization) {
+            if (p.actor == account) return true;
+          }
+          return false;
+        }
+
+        void require_recipient(name account) {
+          auto& n = context().notified;
+          if (std::find(n.begin(), n.end(), account) == n.end()) n.push_back(account);
+        }
+
+        table_data* find_table(const table_id& id) {
+          auto itr = _tables.find(id);
+          return itr == _tables.end() ? nullptr : &itr->second;
+        }
+
+        table_data& get_table(const table_id& id) { return _tables[id]; }
+
+        void store_row(const table_id& id, uint64_t pk, stored_row&& row) {
+          auto& t = get_table(id);
+          auto itr = t.rows.find(pk);
+          if (_undo) {
+            _undo->push_back(undo_entry{ id, pk, itr == t.rows.end() ? std::optional<stored_row>() : std::optional<stored_row>(itr->second) });
+          }
+          _usage.bytes_written += row.bytes.size();
+          if (itr != t.rows.end()) {
+            unlink_keys(t, pk, itr->second);
+            itr->second = std::move(row);
+            link_keys(t, pk, itr->second);
+            _usage.rows_modified++;
+          } else {
+            auto& stored = t.rows[pk];
+            stored = std::move(row);
+            link_keys(t, pk, stored);
+            _usage.rows_emplaced++;
+          }
+        }
+
+        void erase_row(const table_id& id, uint64_t pk) {
+          auto& t = get_table(id);
+          auto itr = t.rows.find(pk);
+          check(itr != t.rows.end(), "db_remove: row does not exist");
+          if (_undo) _undo->push_back(undo_entry{ id, pk, itr->second });
+          unlink_keys(t, pk, itr->second);
+          t.rows.erase(itr);
+          _usage.rows_erased++;
+        }
+
+        void count_read() { _usage.rows_read++; }
+
+        // Removes every row in every table; used between benchmark runs.
+        void clear_tables() { _tables.clear(); }
+
+        const std::vector<char>& action_data() { return context().act->data; }
+
+      private:
+        struct undo_entry {
+          table_id id;
+          uint64_t pk;
+          std::optional<stored_row> previous;
+        };
+
+        static void link_keys(table_data& t, uint64_t pk, const stored_row& row) {
+          for (size_t i = 0; i < t.index_count; i++) t.secondary[i].emplace(row.keys[i], pk);
+        }
+        static void unlink_keys(table_data& t, uint64_t pk, const stored_row& row) {
+          for (size_t i = 0; i < t.index_count; i++) t.secondary[i].erase({ row.keys[i], pk });
+        }
+
+        void rollback(std::vector<undo_entry>& undo) {
+          for (auto it = undo.rbegin(); it != undo.rend(); ++it) {
+            auto& t = get_table(it->id);
+            auto row = t.rows.find(it->pk);
+            if (row != t.rows.end()) {
+              unlink_keys(t, it->pk, row->second);
+              t.rows.erase(row);
+            }
+            if (it->previous) {
+              auto& stored = t.rows[it->pk];
+              stored = std::move(*it->previous);
+              link_keys(t, it->pk, stored);
+            }
+          }
+        }
+
+        using deferred_map = std::map<std::pair<uint64_t, __uint128_t>, deferred_entry>;
+
+        using order_key = std::pair<int64_t, uint64_t>;
+
+        deferred_map::iterator next_deferred() {
+          if (_deferred_order.empty()) return _deferred.end();
+          return _deferred.find(_deferred_order.begin()->second);
+        }
+
+        // Copies the deferred queue the first time a transaction touches it so
+        // that a failure can restore it.
+        void save_deferred() {
+          if (_undo && !_deferred_saved) {
+            _deferred_before = _deferred;
+            _deferred_order_before = _deferred_order;
+            _deferred_saved = true;
+          }
+        }
+
+        void unlink_order(const deferred_entry& e) {
+          _deferred_order.erase(order_key(e.deliver_at.elapsed.count(), e.sequence));
+        }
+
+        void dispatch(const action& a, name receiver, int depth) {
+          check(depth < 64, "max inline action depth per transaction reached");
+          auto handler = _contracts.find(receiver.value);
+          if (handler == _contracts.end()) {
+            check(receiver != a.account, "contract is not deployed: " + receiver.to_string());
+            return;
+          }
+          action_context ctx{ receiver, &a, {}, {} };
+          _contexts.push_back(&ctx);
+          _usage.actions++;
+          handler->second(receiver.value, a.account.value, a.name.value);
+          _contexts.pop_back();
+          for (auto n : ctx.notified) {
+            if (n != receiver) dispatch(a, n, depth + 1);
+          }
+          for (const auto& i : ctx.inlines) dispatch(i, i.account, depth + 1);
+        }
+
+        std::map<table_id, table_data> _tables;
+        std::set<uint64_t> _accounts;
+        std::unordered_map<uint64_t, apply_handler> _contracts;
+        deferred_map _deferred;
+        std::map<order_key, std::pair<uint64_t, __uint128_t>> _deferred_order;
+        deferred_map _deferred_before;
+        std::map<order_key, std::pair<uint64_t, __uint128_t>> _deferred_order_before;
+        bool _deferred_saved = false;
+        uint64_t _deferred_sequence = 0;
+        std::vector<action_context*> _contexts;
+        std::vector<undo_entry>* _undo = nullptr;
+        time_point _now = time_point(seconds(1577836800));
+        usage _usage;
+        std::string _last_deferred_error;
+    };
+
+  } // namespace sim
+
+  inline void action::send() const { sim::chain::instance().send_inline(*this); }
+
+  inline void transaction::send(const __uint128_t& sender_id, name payer, bool replace_existing) const {
+    sim::chain::instance().send_deferred(sender_id, payer, *this, replace_existing);
+  }
+
+  inline int cancel_deferred(const __uint128_t& sender_id) {
+    return sim::chain::instance().cancel_deferred(sender_id) ? 1 : 0;
+  }
+
+  inline time_point current_time_point() { return sim::chain::instance().now(); }
+  inline block_timestamp current_block_time() { return block_timestamp(current_time_point()); }
+
+  inline void require_auth(name n) {
+    check(sim::chain::instance().has_auth(n), "missing authority of " + n.to_string());
+  }
+  inline void require_auth(const permission_level& level) { require_auth(level.actor); }
+  inline bool has_auth(name n) { return sim::chain::instance().has_auth(n); }
+  inline bool is_account(name n) { return sim::chain::instance().is_account(n); }
+  inline void require_recipient(name n) { sim::chain::instance().require_recipient(n); }
+  template<typename... Names>
+  void require_recipient(name n, Names... more) { require_recipient(n); require_recipient(more...); }
+
+  inline name current_receiver() { return sim::chain::instance().context().receiver; }
+
+  inline uint32_t action_data_size() { return uint32_t(sim::chain::instance().action_data().size()); }
+  inline uint32_t read_action_data(void* msg, uint32_t len) {
+    const auto& d = sim::chain::instance().action_data();
+    uint32_t n = std::min<uint32_t>(len, uint32_t(d.size()));
+    if (n) std::memcpy(msg, d.data(), n);
+    return n;
+  }
+
+} // namespace eosio
@@ -0,0 +1,471 @@
+#pragma once
+
+#include <eosio/host.hpp>
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+namespace eosio {
+
+  template<eosio::name::raw IndexName, typename Extractor>
+  struct indexed_by {
+    enum constants { index_name = static_cast<uint64_t>(IndexName) };
+    typedef Extractor secondary_extractor_type;
+  };
+
+  template<class Class, class Type, Type (Class::*PtrToMemberFunction)() const>
+  struct const_mem_fun {
+    typedef typename std::remove_reference<Type>::type result_type;
+    template<typename ChainedPtr>
+    auto operator()(const ChainedPtr& x) const -> std::enable_if_t<!std::is_convertible<const ChainedPtr&, const Class&>::value, Type> {
+      return operator()(*x);
+    }
+    Type operator()(const Class& x) const { return (x.*PtrToMemberFunction)(); }
+  };
+
+  namespace sim {
+
+    // Byte strings that sort like the secondary key types the chain supports.
+    inline void put_be(std::string& s, uint64_t v) {
+      for (int i = 7; i >= 0; i--) s.push_back(char(uint8_t(v >> (8 * i))));
+    }
+
+    template<typename K>
+    std::string encode_key(const K& key) {
+      std::string s;
+      if constexpr (std::is_same_v<K, __uint128_t>) {
+        put_be(s, uint64_t(key >> 64));
+        put_be(s, uint64_t(key));
+      } else if constexpr (std::is_same_v<K, double>) {
+        uint64_t bits;
+        std::memcpy(&bits, &key, 8);
+        bits = (bits & 0x8000000000000000ull) ? ~bits : (bits | 0x8000000000000000ull);
+        put_be(s, bits);
+      } else if constexpr (std::is_same_v<K, long double>) {
+        double d = double(key);
+        return encode_key(d);
+      } else if constexpr (std::is_integral_v<K> && std::is_signed_v<K>) {
+        put_be(s, uint64_t(int64_t(key)) ^ 0x8000000000000000ull);
+      } else if constexpr (std::is_integral_v<K>) {
+        put_be(s, uint64_t(key));
+      } else if constexpr (detail::is_fixed_bytes<K>::value) {
+        s.assign((const char*)key.data(), key.size());
+      } else {
+        static_assert(sizeof(K) == 0, "unsupported secondary key type");
+      }
+      return s;
+    }
+
+  } // namespace sim
+
+  template<eosio::name::raw TableName, typename T, typename... Indices>
+  class multi_index {
+    public:
+      struct const_iterator;
+
+    private:
+      static constexpr size_t index_count = sizeof...(Indices);
+      static_assert(index_count <= sim::max_secondary_indices, "too many secondary indices");
+
+      using index_tuple = std::tuple<Indices...>;
+
+      template<size_t I>
+      using extractor_at = typename std::tuple_element_t<I, index_tuple>::secondary_extractor_type;
+
+      name _code;
+      uint64_t _scope;
+      mutable std::map<uint64_t, std::unique_ptr<T>> _items;
+
+      sim::table_id id() const { return sim::table_id{ _code.value, _scope, static_cast<uint64_t>(TableName) }; }
+
+      sim::table_data* data() const { return sim::chain::instance().find_table(id()); }
+
+      const T& load(uint64_t pk) const {
+        auto cached = _items.find(pk);
+        if (cached != _items.end()) return *cached->second;
+        auto* t = data();
+        auto row = t->rows.find(pk);
+        auto obj = std::make_unique<T>();
+        datastream<const char*> ds(row->second.bytes.data(), row->second.bytes.size());
+        unpack_value(ds, *obj);
+        auto& ref = *obj;
+        _items[pk] = std::move(obj);
+        return ref;
+      }
+
+      bool exists(uint64_t pk) const {
+        auto* t = data();
+        return t && t->rows.count(pk);
+      }
+
+      template<size_t... I>
+      void fill_keys(const T& obj, sim::stored_row& row, std::index_sequence<I...>) const {
+        ((row.keys[I] = sim::encode_key(static_cast<typename extractor_at<I>::result_type>(extractor_at<I>()(obj)))), ...);
+      }
+
+      sim::stored_row make_row(const T& obj, name payer) const {
+        sim::stored_row row;
+        row.bytes = pack(obj);
+        row.payer = payer;
+        fill_keys(obj, row, std::make_index_sequence<index_count>());
+        return row;
+      }
+
+      void write(const T& obj, name payer) const {
+        auto& t = sim::chain::instance().get_table(id());
+        t.index_count = uint8_t(index_count);
+        sim::chain::instance().store_row(id(), obj.primary_key(), make_row(obj, payer));
+      }
+
+      const_iterator at(uint64_t pk) const {
+        sim::chain::instance().count_read();
+        return const_iterator(this, pk);
+      }
+
+    public:
+      struct const_iterator : public std::iterator<std::bidirectional_iterator_tag, const T> {
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = const T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+
+        const T& operator*() const {
+          check(!_end, "cannot dereference end iterator");
+          return _idx->load(_pk);
+        }
+        const T* operator->() const { return &**this; }
+
+        const_iterator& operator++() {
+          check(!_end, "cannot increment end iterator");
+          auto* t = _idx->data();
+          auto next = t->rows.upper_bound(_pk);
+          if (next == t->rows.end()) {
+            _end = true;
+          } else {
+            _pk = next->first;
+            sim::chain::instance().count_read();
+          }
+          return *this;
+        }
+        const_iterator operator++(int) { auto r = *this; ++*this; return r; }
+
+        const_iterator& operator--() {
+          auto* t = _idx->data();
+          check(t && !t->rows.empty(), "cannot decrement end iterator when the table is empty");
+          if (_end) {
+            _pk = t->rows.rbegin()->first;
+            _end = false;
+          } else {
+            auto cur = t->rows.lower_bound(_pk);
+            check(cur != t->rows.begin(), "cannot decrement iterator at beginning of table");
+            _pk = std::prev(cur)->first;
+          }
+          sim::chain::instance().count_read();
+          return *this;
+        }
+        const_iterator operator--(int) { auto r = *this; --*this; return r; }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) {
+          return a._end == b._end && (a._end || a._pk == b._pk);
+        }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) { return !(a == b); }
+
+      private:
+        friend class multi_index;
+        const_iterator(const multi_index* idx, uint64_t pk) : _idx(idx), _pk(pk), _end(false) {}
+        explicit const_iterator(const multi_index* idx) : _idx(idx), _pk(0), _end(true) {}
+
+        const multi_index* _idx = nullptr;
+        uint64_t _pk = 0;
+        bool _end = true;
+      };
+
+      using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+      template<size_t I>
+      class index {
+        public:
+          using extractor = extractor_at<I>;
+          using secondary_key_type = std::decay_t<typename extractor::result_type>;
+
+          struct const_iterator : public std::iterator<std::bidirectional_iterator_tag, const T> {
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = const T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            const_iterator() = default;
+
+            const T& operator*() const {
+              check(!_end, "cannot dereference end iterator");
+              return _mi->load(_pk);
+            }
+            const T* operator->() const { return &**this; }
+
+            // Steps from the row's current key, so an iterator whose row was
+            // just modified continues from the row's new position.
+            const_iterator& operator++() {
+              check(!_end, "cannot increment end iterator");
+              auto* t = _mi->data();
+              auto& set = t->secondary[I];
+              auto next = set.upper_bound({ t->rows.at(_pk).keys[I], _pk });
+              if (next == set.end()) {
+                _end = true;
+              } else {
+                _pk = next->second;
+                sim::chain::instance().count_read();
+              }
+              return *this;
+            }
+            const_iterator operator++(int) { auto r = *this; ++*this; return r; }
+
+            const_iterator& operator--() {
+              auto* t = _mi->data();
+              check(t && !t->secondary[I].empty(), "cannot decrement end iterator when the index is empty");
+              auto& set = t->secondary[I];
+              if (_end) {
+                _pk = set.rbegin()->second;
+                _end = false;
+              } else {
+                auto cur = set.lower_bound({ t->rows.at(_pk).keys[I], _pk });
+                check(cur != set.begin(), "cannot decrement iterator at beginning of index");
+                _pk = std::prev(cur)->second;
+              }
+              sim::chain::instance().count_read();
+              return *this;
+            }
+            const_iterator operator--(int) { auto r = *this; --*this; return r; }
+
+            friend bool operator==(const const_iterator& a, const const_iterator& b) {
+              return a._end == b._end && (a._end || a._pk == b._pk);
+            }
+            friend bool operator!=(const const_iterator& a, const const_iterator& b) { return !(a == b); }
+
+          private:
+            friend class index;
+            const_iterator(const multi_index* mi, uint64_t pk) : _mi(mi), _pk(pk), _end(false) {}
+            explicit const_iterator(const multi_index* mi) : _mi(mi), _pk(0), _end(true) {}
+
+            const multi_index* _mi = nullptr;
+            uint64_t _pk = 0;
+            bool _end = true;
+          };
+
+          using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+          explicit index(const multi_index* mi) : _mi(mi) {}
+
+          static constexpr uint64_t index_name = std::tuple_element_t<I, index_tuple>::index_name;
+          constexpr uint64_t name() const { return index_name; }
+          eosio::name get_code() const { return _mi->get_code(); }
+          uint64_t get_scope() const { return _mi->get_scope(); }
+
+          static auto extract_secondary_key(const T& obj) { return secondary_key_type(extractor()(obj)); }
+
+          const_iterator cbegin() const { return lower_bound_encoded(std::string()); }
+          const_iterator begin() const { return cbegin(); }
+          const_iterator cend() const { return const_iterator(_mi); }
+          const_iterator end() const { return cend(); }
+          const_reverse_iterator crbegin() const { return std::make_reverse_iterator(cend()); }
+          const_reverse_iterator rbegin() const { return crbegin(); }
+          const_reverse_iterator crend() const { return std::make_reverse_iterator(cbegin()); }
+          const_reverse_iterator rend() const { return crend(); }
+
+          const_iterator lower_bound(const secondary_key_type& key) const {
+            return lower_bound_encoded(sim::encode_key(key));
+          }
+
+          const_iterator upper_bound(const secondary_key_type& key) const {
+            auto* t = _mi->data();
+            if (!t) return cend();
+            auto& set = t->secondary[I];
+            auto itr = set.upper_bound({ sim::encode_key(key), UINT64_MAX });
+            if (itr == set.end()) return cend();
+            sim::chain::instance().count_read();
+            return const_iterator(_mi, itr->second);
+          }
+
+          const_iterator find(const secondary_key_type& key) const {
+            auto lb = lower_bound(key);
+            if (lb == cend()) return lb;
+            if (extract_secondary_key(*lb) != key) return cend();
+            return lb;
+          }
+
+          const T& get(const secondary_key_type& key, const char* msg = "unable to find secondary key") const {
+            auto result = find(key);
+            check(result != cend(), msg);
+            return *result;
+          }
+
+          const_iterator require_find(const secondary_key_type& key, const char* msg = "unable to find secondary key") const {
+            auto result = find(key);
+            check(result != cend(), msg);
+            return result;
+          }
+
+          const_iterator iterator_to(const T& obj) const { return const_iterator(_mi, obj.primary_key()); }
+
+          template<typename Lambda>
+          void modify(const_iterator itr, eosio::name payer, Lambda&& updater) const {
+            check(itr != cend(), "cannot pass end iterator to modify");
+            _mi->modify(*itr, payer, std::forward<Lambda>(updater));
+          }
+
+          const_iterator erase(const_iterator itr) const {
+            check(itr != cend(), "cannot pass end iterator to erase");
+            const auto& obj = *itr;
+            ++itr;
+            _mi->erase(obj);
+            return itr;
+          }
+
+        private:
+          const_iterator lower_bound_encoded(const std::string& key) const {
+            auto* t = _mi->data();
+            if (!t) return cend();
+            auto& set = t->secondary[I];
+            auto itr = set.lower_bound({ key, 0 });
+            if (itr == set.end()) return cend();
+            sim::chain::instance().count_read();
+            return const_iterator(_mi, itr->second);
+          }
+
+          const multi_index* _mi;
+      };
+
+      multi_index(name code, uint64_t scope) : _code(code), _scope(scope) {}
+
+      multi_index(const multi_index&) = delete;
+      multi_index& operator=(const multi_index&) = delete;
+      multi_index(multi_index&&) = default;
+      multi_index& operator=(multi_index&&) = default;
+
+      name get_code() const { return _code; }
+      uint64_t get_scope() const { return _scope; }
+
+      const_iterator cbegin() const {
+        auto* t = data();
+        if (!t || t->rows.empty()) return cend();
+        return at(t->rows.begin()->first);
+      }
+      const_iterator begin() const { return cbegin(); }
+      const_iterator cend() const { return const_iterator(this); }
+      const_iterator end() const { return cend(); }
+      const_reverse_iterator crbegin() const { return std::make_reverse_iterator(cend()); }
+      const_reverse_iterator rbegin() const { return crbegin(); }
+      const_reverse_iterator crend() const { return std::make_reverse_iterator(cbegin()); }
+      const_reverse_iterator rend() const { return crend(); }
+
+      const_iterator lower_bound(uint64_t pk) const {
+        auto* t = data();
+        if (!t) return cend();
+        auto itr = t->rows.lower_bound(pk);
+        if (itr == t->rows.end()) return cend();
+        return at(itr->first);
+      }
+
+      const_iterator upper_bound(uint64_t pk) const {
+        auto* t = data();
+        if (!t) return cend();
+        auto itr = t->rows.upper_bound(pk);
+        if (itr == t->rows.end()) return cend();
+        return at(itr->first);
+      }
+
+      uint64_t available_primary_key() const {
+        auto* t = data();
+        if (!t || t->rows.empty()) return 0;
+        return t->rows.rbegin()->first + 1;
+      }
+
+      template<eosio::name::raw IndexName, size_t I = 0>
+      static constexpr size_t index_position() {
+        static_assert(I < index_count, "name provided is not the name of any secondary index within multi_index");
+        if constexpr (std::tuple_element_t<I, index_tuple>::index_name == static_cast<uint64_t>(IndexName)) {
+          return I;
+        } else {
+          return index_position<IndexName, I + 1>();
+        }
+      }
+
+      template<eosio::name::raw IndexName>
+      auto get_index() const { return index<index_position<IndexName>()>(this); }
+
+      const_iterator iterator_to(const T& obj) const { return const_iterator(this, obj.primary_key()); }
+
+      template<typename Lambda>
+      const_iterator emplace(name payer, Lambda&& constructor) const {
+        auto obj = std::make_unique<T>();
+        constructor(*obj);
+        uint64_t pk = obj->primary_key();
+        check(!exists(pk), "could not insert object, most likely a uniqueness constraint was violated");
+        write(*obj, payer);
+        _items[pk] = std::move(obj);
+        return const_iterator(this, pk);
+      }
+
+      template<typename Lambda>
+      void modify(const_iterator itr, name payer, Lambda&& updater) const {
+        check(itr != cend(), "cannot pass end iterator to modify");
+        modify(*itr, payer, std::forward<Lambda>(updater));
+      }
+
+      template<typename Lambda>
+      void modify(const T& obj, name payer, Lambda&& updater) const {
+        auto pk = obj.primary_key();
+        check(exists(pk), "object passed to modify is not in multi_index");
+        T& mutable_obj = const_cast<T&>(obj);
+        updater(mutable_obj);
+        check(pk == mutable_obj.primary_key(), "updater cannot change primary key when modifying an object");
+        auto* t = data();
+        if (!payer) payer = t->rows.at(pk).payer;
+        write(mutable_obj, payer);
+      }
+
+      const T& get(uint64_t pk, const char* msg = "unable to find key") const {
+        auto result = find(pk);
+        check(result != cend(), msg);
+        return *result;
+      }
+
+      const_iterator find(uint64_t pk) const {
+        if (!exists(pk)) {
+          _items.erase(pk);
+          return cend();
+        }
+        return at(pk);
+      }
+
+      const_iterator require_find(uint64_t pk, const char* msg = "unable to find key") const {
+        auto result = find(pk);
+        check(result != cend(), msg);
+        return result;
+      }
+
+      const_iterator erase(const_iterator itr) const {
+        check(itr != cend(), "cannot pass end iterator to erase");
+        const auto& obj = *itr;
+        ++itr;
+        erase(obj);
+        return itr;
+      }
+
+      void erase(const T& obj) const {
+        uint64_t pk = obj.primary_key();
+        sim::chain::instance().erase_row(id(), pk);
+        _items.erase(pk);
+      }
+  };
+
+} // namespace eosio
+
+#pragma GCC diagnostic pop
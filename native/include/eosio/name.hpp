@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <algorithm>
+
+namespace eosio {
+
+  inline void check(bool pred, const char* msg);
+  inline void check(bool pred, const std::string& msg);
+
+  struct name {
+    enum class raw : uint64_t {};
+
+    uint64_t value = 0;
+
+    constexpr name() = default;
+    constexpr explicit name(uint64_t v) : value(v) {}
+    constexpr explicit name(raw r) : value(static_cast<uint64_t>(r)) {}
+    constexpr explicit name(std::string_view str) : value(0) {
+      if (str.size() > 13) {
+        throw std::invalid_argument("string is too long to be a valid name");
+      }
+      if (str.empty()) {
+        return;
+      }
+      auto n = std::min(str.size(), size_t(12));
+      for (size_t i = 0; i < n; ++i) {
+        value <<= 5;
+        value |= char_to_value(str[i]);
+      }
+      value <<= (4 + 5 * (12 - n));
+      if (str.size() == 13) {
+        uint64_t v = char_to_value(str[12]);
+        if (v > 0x0Full) {
+          throw std::invalid_argument("thirteenth character in name cannot be a letter that comes after j");
+        }
+        value |= v;
+      }
+    }
+
+    static constexpr uint8_t char_to_value(char c) {
+      if (c == '.') return 0;
+      else if (c >= '1' && c <= '5') return (c - '1') + 1;
+      else if (c >= 'a' && c <= 'z') return (c - 'a') + 6;
+      throw std::invalid_argument("character is not in allowed character set for names");
+    }
+
+    constexpr uint8_t length() const {
+      constexpr uint64_t mask = 0xF800000000000000ull;
+      if (value == 0) return 0;
+      uint8_t l = 0;
+      uint8_t i = 0;
+      for (auto v = value; i < 13; ++i, v <<= 5) {
+        if ((v & mask) > 0) l = i;
+      }
+      return l + 1;
+    }
+
+    constexpr name suffix() const {
+      uint32_t remaining_bits_after_last_actual_dot = 0;
+      uint32_t tmp = 0;
+      for (int32_t remaining_bits = 59; remaining_bits >= 4; remaining_bits -= 5) {
+        auto c = (value >> remaining_bits) & 0x1Full;
+        if (!c) {
+          tmp = static_cast<uint32_t>(remaining_bits);
+        } else {
+          remaining_bits_after_last_actual_dot = tmp;
+        }
+      }
+      uint64_t thirteenth_character = value & 0x0Full;
+      if (thirteenth_character) remaining_bits_after_last_actual_dot = tmp;
+      if (remaining_bits_after_last_actual_dot == 0) return name{value};
+      uint64_t mask = (1ull << remaining_bits_after_last_actual_dot) - 16;
+      uint32_t shift = 64 - remaining_bits_after_last_actual_dot;
+      return name{((value & mask) << shift) + (thirteenth_character << (shift - 1))};
+    }
+
+    constexpr operator raw() const { return raw(value); }
+    constexpr explicit operator bool() const { return value != 0; }
+
+    std::string to_string() const {
+      static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+      std::string str(13, '.');
+      uint64_t tmp = value;
+      for (uint32_t i = 0; i <= 12; ++i) {
+        char c = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+        str[12 - i] = c;
+        tmp >>= (i == 0 ? 4 : 5);
+      }
+      auto last = str.find_last_not_of('.');
+      return str.substr(0, last == std::string::npos ? 0 : last + 1);
+    }
+
+    friend constexpr bool operator==(const name& a, const name& b) { return a.value == b.value; }
+    friend constexpr bool operator!=(const name& a, const name& b) { return a.value != b.value; }
+    friend constexpr bool operator<(const name& a, const name& b) { return a.value < b.value; }
+    friend constexpr bool operator<=(const name& a, const name& b) { return a.value <= b.value; }
+    friend constexpr bool operator>(const name& a, const name& b) { return a.value > b.value; }
+    friend constexpr bool operator>=(const name& a, const name& b) { return a.value >= b.value; }
+  };
+
+  static constexpr name same_payer{};
+
+} // namespace eosio
+
+typedef unsigned __int128 uint128_t;
+typedef __int128 int128_t;
+
+inline constexpr eosio::name operator""_n(const char* s, std::size_t n) {
+  return eosio::name(std::string_view(s, n));
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <eosio/asset.hpp>
+#include <eosio/time.hpp>
+#include <sstream>
+#include <string>
+
+namespace eosio {
+
+  namespace sim {
+    // Console output of the currently executing action, kept for debugging.
+    inline std::string& console() { static std::string c; return c; }
+    inline bool& console_enabled() { static bool e = false; return e; }
+  }
+
+  namespace detail {
+    inline void print_one(std::ostringstream& os, const name& n) { os << n.to_string(); }
+    inline void print_one(std::ostringstream& os, const asset& a) { os << a.to_string(); }
+    inline void print_one(std::ostringstream& os, const symbol& s) { os << s.code().to_string(); }
+    inline void print_one(std::ostringstream& os, const std::string& s) { os << s; }
+    inline void print_one(std::ostringstream& os, const char* s) { os << s; }
+    inline void print_one(std::ostringstream& os, bool b) { os << (b ? "true" : "false"); }
+    inline void print_one(std::ostringstream& os, const __uint128_t& v) { os << uint64_t(v >> 64) << ":" << uint64_t(v); }
+    template<typename T>
+    inline void print_one(std::ostringstream& os, const T& v) { os << v; }
+  }
+
+  template<typename... Args>
+  inline void print(Args&&... args) {
+    if (!sim::console_enabled()) return;
+    std::ostringstream os;
+    (detail::print_one(os, args), ...);
+    sim::console() += os.str();
+  }
+
+  template<typename... Args>
+  inline void print_f(const char*, Args&&...) {}
+
+  inline void printhex(const void*, uint32_t) {}
+
+} // namespace eosio
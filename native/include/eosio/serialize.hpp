@@ -0,0 +1,292 @@
+#pragma once
+
+#include <eosio/asset.hpp>
+#include <eosio/crypto.hpp>
+#include <eosio/detail_fields.hpp>
+#include <eosio/time.hpp>
+
+#include <cstring>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eosio {
+
+  template<typename T>
+  class binary_extension {
+    public:
+      binary_extension() = default;
+      binary_extension(const T& v) : _v(v) {}
+      binary_extension(T&& v) : _v(std::move(v)) {}
+      bool has_value() const { return _v.has_value(); }
+      explicit operator bool() const { return has_value(); }
+      T& value() { check(has_value(), "cannot get value of empty binary_extension"); return *_v; }
+      const T& value() const { check(has_value(), "cannot get value of empty binary_extension"); return *_v; }
+      T value_or(const T& d = T()) const { return _v ? *_v : d; }
+      T* operator->() { return &value(); }
+      const T* operator->() const { return &value(); }
+      T& operator*() { return value(); }
+      const T& operator*() const { return value(); }
+      template<typename... Args>
+      T& emplace(Args&&... args) { _v.emplace(std::forward<Args>(args)...); return *_v; }
+      void reset() { _v.reset(); }
+      std::optional<T> _v;
+  };
+
+  template<typename T>
+  class datastream {
+    public:
+      datastream(T start, size_t s) : _start(start), _pos(start), _end(start + s) {}
+      void skip(size_t s) { _pos += s; }
+      bool read(char* d, size_t s) {
+        check(size_t(_end - _pos) >= s, "datastream attempted to read past the end");
+        std::memcpy(d, _pos, s);
+        _pos += s;
+        return true;
+      }
+      bool write(const char* d, size_t s) {
+        check(_end - _pos >= (int32_t)s, "datastream attempted to write past the end");
+        std::memcpy((void*)_pos, d, s);
+        _pos += s;
+        return true;
+      }
+      T pos() const { return _pos; }
+      bool valid() const { return _pos <= _end && _pos >= _start; }
+      size_t tellp() const { return size_t(_pos - _start); }
+      size_t remaining() const { return size_t(_end - _pos); }
+    private:
+      T _start;
+      T _pos;
+      T _end;
+  };
+
+  // Growable sink used by the host build in place of the size-then-write
+  // double pass the wasm runtime does.
+  struct buffer_sink {
+    std::vector<char>& out;
+    void write(const char* d, size_t s) { out.insert(out.end(), d, d + s); }
+  };
+
+  namespace detail {
+
+    // Aggregate field counting: the largest N for which T{any, ...} is valid.
+    struct any_field {
+      template<typename U, typename = std::enable_if_t<!std::is_lvalue_reference_v<U>>>
+      operator U() const;
+    };
+
+    template<typename T, typename Seq, typename = void>
+    struct braces_ok : std::false_type {};
+    template<typename T, size_t... I>
+    struct braces_ok<T, std::index_sequence<I...>,
+                     std::void_t<decltype(T{ (void(I), any_field{})... })>> : std::true_type {};
+
+    template<typename T, size_t N>
+    constexpr size_t count_fields() {
+      if constexpr (N > 48) {
+        return 48;
+      } else if constexpr (braces_ok<T, std::make_index_sequence<N + 1>>::value) {
+        return count_fields<T, N + 1>();
+      } else {
+        return N;
+      }
+    }
+
+    template<typename T>
+    constexpr size_t field_count = count_fields<T, 0>();
+
+    template<typename T> struct is_vector : std::false_type {};
+    template<typename T, typename A> struct is_vector<std::vector<T, A>> : std::true_type {};
+    template<typename T> struct is_map : std::false_type {};
+    template<typename K, typename V, typename C, typename A> struct is_map<std::map<K, V, C, A>> : std::true_type {};
+    template<typename T> struct is_set : std::false_type {};
+    template<typename K, typename C, typename A> struct is_set<std::set<K, C, A>> : std::true_type {};
+    template<typename T> struct is_pair : std::false_type {};
+    template<typename A, typename B> struct is_pair<std::pair<A, B>> : std::true_type {};
+    template<typename T> struct is_tuple : std::false_type {};
+    template<typename... A> struct is_tuple<std::tuple<A...>> : std::true_type {};
+    template<typename T> struct is_optional : std::false_type {};
+    template<typename T> struct is_optional<std::optional<T>> : std::true_type {};
+    template<typename T> struct is_binext : std::false_type {};
+    template<typename T> struct is_binext<binary_extension<T>> : std::true_type {};
+    template<typename T> struct is_fixed_bytes : std::false_type {};
+    template<size_t S> struct is_fixed_bytes<fixed_bytes<S>> : std::true_type {};
+    template<typename T> struct is_std_array : std::false_type {};
+    template<typename T, size_t S> struct is_std_array<std::array<T, S>> : std::true_type {};
+
+    template<typename Stream>
+    void write_varuint32(Stream& ds, uint32_t v) {
+      do {
+        uint8_t b = uint8_t(v & 0x7f);
+        v >>= 7;
+        b |= uint8_t((v > 0) << 7);
+        ds.write((const char*)&b, 1);
+      } while (v);
+    }
+
+    template<typename Stream>
+    uint32_t read_varuint32(Stream& ds) {
+      uint64_t v = 0;
+      uint8_t b = 0, by = 0;
+      do {
+        ds.read((char*)&b, 1);
+        v |= uint32_t(uint8_t(b) & 0x7f) << by;
+        by += 7;
+      } while ((b & 0x80) && by < 32);
+      return uint32_t(v);
+    }
+
+  } // namespace detail
+
+  template<typename Stream, typename T>
+  void pack_value(Stream& ds, const T& v);
+  template<typename Stream, typename T>
+  void unpack_value(Stream& ds, T& v);
+
+  template<typename Stream, typename T>
+  void pack_value(Stream& ds, const T& v) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_arithmetic_v<U> || std::is_enum_v<U> || std::is_same_v<U, __uint128_t> || std::is_same_v<U, __int128_t>) {
+      ds.write((const char*)&v, sizeof(U));
+    } else if constexpr (std::is_same_v<U, name>) {
+      ds.write((const char*)&v.value, 8);
+    } else if constexpr (std::is_same_v<U, symbol_code>) {
+      uint64_t r = v.raw(); ds.write((const char*)&r, 8);
+    } else if constexpr (std::is_same_v<U, symbol>) {
+      uint64_t r = v.raw(); ds.write((const char*)&r, 8);
+    } else if constexpr (std::is_same_v<U, asset>) {
+      pack_value(ds, v.amount); pack_value(ds, v.symbol);
+    } else if constexpr (std::is_same_v<U, extended_asset>) {
+      pack_value(ds, v.quantity); pack_value(ds, v.contract);
+    } else if constexpr (std::is_same_v<U, microseconds>) {
+      pack_value(ds, v._count);
+    } else if constexpr (std::is_same_v<U, time_point>) {
+      pack_value(ds, v.elapsed._count);
+    } else if constexpr (std::is_same_v<U, time_point_sec>) {
+      pack_value(ds, v.utc_seconds);
+    } else if constexpr (std::is_same_v<U, block_timestamp>) {
+      pack_value(ds, v.slot);
+    } else if constexpr (std::is_same_v<U, std::string>) {
+      detail::write_varuint32(ds, uint32_t(v.size()));
+      if (v.size()) ds.write(v.data(), v.size());
+    } else if constexpr (detail::is_fixed_bytes<U>::value) {
+      ds.write((const char*)v.data(), v.size());
+    } else if constexpr (detail::is_std_array<U>::value) {
+      for (const auto& e : v) pack_value(ds, e);
+    } else if constexpr (detail::is_vector<U>::value || detail::is_set<U>::value || detail::is_map<U>::value) {
+      detail::write_varuint32(ds, uint32_t(v.size()));
+      for (const auto& e : v) pack_value(ds, e);
+    } else if constexpr (detail::is_pair<U>::value) {
+      pack_value(ds, v.first); pack_value(ds, v.second);
+    } else if constexpr (detail::is_tuple<U>::value) {
+      std::apply([&](const auto&... e) { (pack_value(ds, e), ...); }, v);
+    } else if constexpr (detail::is_optional<U>::value) {
+      bool h = v.has_value(); pack_value(ds, h);
+      if (h) pack_value(ds, *v);
+    } else if constexpr (detail::is_binext<U>::value) {
+      if (v.has_value()) pack_value(ds, *v);
+    } else {
+      static_assert(std::is_aggregate_v<U>, "type is not serializable");
+      detail::visit_fields_n<detail::field_count<U>>(const_cast<U&>(v), [&](auto& f) { pack_value(ds, f); });
+    }
+  }
+
+  template<typename Stream, typename T>
+  void unpack_value(Stream& ds, T& v) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_arithmetic_v<U> || std::is_enum_v<U> || std::is_same_v<U, __uint128_t> || std::is_same_v<U, __int128_t>) {
+      ds.read((char*)&v, sizeof(U));
+    } else if constexpr (std::is_same_v<U, name>) {
+      ds.read((char*)&v.value, 8);
+    } else if constexpr (std::is_same_v<U, symbol_code>) {
+      uint64_t r; ds.read((char*)&r, 8); v = symbol_code(r);
+    } else if constexpr (std::is_same_v<U, symbol>) {
+      uint64_t r; ds.read((char*)&r, 8); v = symbol(r);
+    } else if constexpr (std::is_same_v<U, asset>) {
+      unpack_value(ds, v.amount); unpack_value(ds, v.symbol);
+    } else if constexpr (std::is_same_v<U, extended_asset>) {
+      unpack_value(ds, v.quantity); unpack_value(ds, v.contract);
+    } else if constexpr (std::is_same_v<U, microseconds>) {
+      unpack_value(ds, v._count);
+    } else if constexpr (std::is_same_v<U, time_point>) {
+      unpack_value(ds, v.elapsed._count);
+    } else if constexpr (std::is_same_v<U, time_point_sec>) {
+      unpack_value(ds, v.utc_seconds);
+    } else if constexpr (std::is_same_v<U, block_timestamp>) {
+      unpack_value(ds, v.slot);
+    } else if constexpr (std::is_same_v<U, std::string>) {
+      uint32_t n = detail::read_varuint32(ds);
+      v.resize(n);
+      if (n) ds.read(v.data(), n);
+    } else if constexpr (detail::is_fixed_bytes<U>::value) {
+      ds.read((char*)v.data(), v.size());
+    } else if constexpr (detail::is_std_array<U>::value) {
+      for (auto& e : v) unpack_value(ds, e);
+    } else if constexpr (detail::is_vector<U>::value) {
+      uint32_t n = detail::read_varuint32(ds);
+      v.clear(); v.resize(n);
+      for (auto& e : v) unpack_value(ds, e);
+    } else if constexpr (detail::is_set<U>::value) {
+      uint32_t n = detail::read_varuint32(ds);
+      v.clear();
+      for (uint32_t i = 0; i < n; i++) { typename U::value_type e; unpack_value(ds, e); v.insert(std::move(e)); }
+    } else if constexpr (detail::is_map<U>::value) {
+      uint32_t n = detail::read_varuint32(ds);
+      v.clear();
+      for (uint32_t i = 0; i < n; i++) {
+        typename U::key_type k; typename U::mapped_type m;
+        unpack_value(ds, k); unpack_value(ds, m);
+        v.emplace(std::move(k), std::move(m));
+      }
+    } else if constexpr (detail::is_pair<U>::value) {
+      unpack_value(ds, v.first); unpack_value(ds, v.second);
+    } else if constexpr (detail::is_tuple<U>::value) {
+      std::apply([&](auto&... e) { (unpack_value(ds, e), ...); }, v);
+    } else if constexpr (detail::is_optional<U>::value) {
+      bool h = false; unpack_value(ds, h);
+      if (h) { typename U::value_type e; unpack_value(ds, e); v = std::move(e); } else { v.reset(); }
+    } else if constexpr (detail::is_binext<U>::value) {
+      if (ds.remaining()) { typename std::decay_t<decltype(*v._v)> e; unpack_value(ds, e); v = std::move(e); } else { v.reset(); }
+    } else {
+      static_assert(std::is_aggregate_v<U>, "type is not serializable");
+      detail::visit_fields_n<detail::field_count<U>>(v, [&](auto& f) { unpack_value(ds, f); });
+    }
+  }
+
+  template<typename Stream, typename T>
+  datastream<Stream>& operator<<(datastream<Stream>& ds, const T& v) { pack_value(ds, v); return ds; }
+
+  template<typename T>
+  buffer_sink& operator<<(buffer_sink& ds, const T& v) { pack_value(ds, v); return ds; }
+
+  template<typename T, typename Stream>
+  datastream<Stream>& operator>>(datastream<Stream>& ds, T& v) { unpack_value(ds, v); return ds; }
+
+  template<typename T>
+  std::vector<char> pack(const T& v) {
+    std::vector<char> out;
+    buffer_sink sink{out};
+    pack_value(sink, v);
+    return out;
+  }
+
+  template<typename T>
+  T unpack(const char* buffer, size_t len) {
+    T result{};
+    datastream<const char*> ds(buffer, len);
+    unpack_value(ds, result);
+    return result;
+  }
+
+  template<typename T>
+  T unpack(const std::vector<char>& bytes) { return unpack<T>(bytes.data(), bytes.size()); }
+
+  template<typename T>
+  size_t pack_size(const T& v) { return pack(v).size(); }
+
+} // namespace eosio
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <eosio/name.hpp>
+
+namespace eosio {
+
+  class symbol_code {
+    public:
+      constexpr symbol_code() : value(0) {}
+      constexpr explicit symbol_code(uint64_t raw) : value(raw) {}
+      constexpr explicit symbol_code(std::string_view str) : value(0) {
+        for (auto itr = str.rbegin(); itr != str.rend(); ++itr) {
+          value <<= 8;
+          value |= uint64_t(*itr);
+        }
+      }
+      constexpr uint64_t raw() const { return value; }
+      constexpr bool is_valid() const {
+        auto sym = value;
+        for (int i = 0; i < 7; i++) {
+          char c = (char)(sym & 0xFF);
+          if (!('A' <= c && c <= 'Z')) return false;
+          sym >>= 8;
+          if (!(sym & 0xFF)) {
+            do {
+              sym >>= 8;
+              if ((sym & 0xFF)) return false;
+              i++;
+            } while (i < 7);
+          }
+        }
+        return true;
+      }
+      std::string to_string() const {
+        std::string s;
+        auto v = value;
+        while (v) { s.push_back(char(v & 0xFF)); v >>= 8; }
+        return s;
+      }
+      friend constexpr bool operator==(const symbol_code& a, const symbol_code& b) { return a.value == b.value; }
+      friend constexpr bool operator!=(const symbol_code& a, const symbol_code& b) { return a.value != b.value; }
+      friend constexpr bool operator<(const symbol_code& a, const symbol_code& b) { return a.value < b.value; }
+    private:
+      uint64_t value;
+  };
+
+  class symbol {
+    public:
+      constexpr symbol() : value(0) {}
+      constexpr explicit symbol(uint64_t raw) : value(raw) {}
+      constexpr symbol(symbol_code sc, uint8_t precision) : value((sc.raw() << 8) | precision) {}
+      constexpr symbol(std::string_view ss, uint8_t precision) : value((symbol_code(ss).raw() << 8) | precision) {}
+      constexpr bool is_valid() const { return code().is_valid(); }
+      constexpr uint8_t precision() const { return value & 0xFFull; }
+      constexpr symbol_code code() const { return symbol_code{value >> 8}; }
+      constexpr uint64_t raw() const { return value; }
+      constexpr explicit operator bool() const { return value != 0; }
+      friend constexpr bool operator==(const symbol& a, const symbol& b) { return a.value == b.value; }
+      friend constexpr bool operator!=(const symbol& a, const symbol& b) { return a.value != b.value; }
+      friend constexpr bool operator<(const symbol& a, const symbol& b) { return a.value < b.value; }
+    private:
+      uint64_t value;
+  };
+
+} // namespace eosio
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+namespace eosio {
+
+  class microseconds {
+    public:
+      constexpr explicit microseconds(int64_t c = 0) : _count(c) {}
+      constexpr int64_t count() const { return _count; }
+      constexpr int64_t to_seconds() const { return _count / 1000000; }
+      constexpr microseconds operator+(const microseconds& m) const { return microseconds(_count + m._count); }
+      constexpr microseconds operator-(const microseconds& m) const { return microseconds(_count - m._count); }
+      microseconds& operator+=(const microseconds& m) { _count += m._count; return *this; }
+      microseconds& operator-=(const microseconds& m) { _count -= m._count; return *this; }
+      constexpr bool operator==(const microseconds& m) const { return _count == m._count; }
+      constexpr bool operator!=(const microseconds& m) const { return _count != m._count; }
+      constexpr bool operator<(const microseconds& m) const { return _count < m._count; }
+      constexpr bool operator<=(const microseconds& m) const { return _count <= m._count; }
+      constexpr bool operator>(const microseconds& m) const { return _count > m._count; }
+      constexpr bool operator>=(const microseconds& m) const { return _count >= m._count; }
+      int64_t _count;
+  };
+
+  inline constexpr microseconds seconds(int64_t s) { return microseconds(s * 1000000); }
+  inline constexpr microseconds milliseconds(int64_t s) { return microseconds(s * 1000); }
+  inline constexpr microseconds minutes(int64_t m) { return seconds(60 * m); }
+  inline constexpr microseconds hours(int64_t h) { return minutes(60 * h); }
+  inline constexpr microseconds days(int64_t d) { return hours(24 * d); }
+
+  class time_point {
+    public:
+      constexpr explicit time_point(microseconds e = microseconds()) : elapsed(e) {}
+      constexpr const microseconds& time_since_epoch() const { return elapsed; }
+      constexpr uint32_t sec_since_epoch() const { return uint32_t(elapsed.count() / 1000000); }
+      constexpr bool operator>(const time_point& t) const { return elapsed._count > t.elapsed._count; }
+      constexpr bool operator>=(const time_point& t) const { return elapsed._count >= t.elapsed._count; }
+      constexpr bool operator<(const time_point& t) const { return elapsed._count < t.elapsed._count; }
+      constexpr bool operator<=(const time_point& t) const { return elapsed._count <= t.elapsed._count; }
+      constexpr bool operator==(const time_point& t) const { return elapsed._count == t.elapsed._count; }
+      constexpr bool operator!=(const time_point& t) const { return elapsed._count != t.elapsed._count; }
+      time_point& operator+=(const microseconds& m) { elapsed += m; return *this; }
+      time_point& operator-=(const microseconds& m) { elapsed -= m; return *this; }
+      constexpr time_point operator+(const microseconds& m) const { return time_point(elapsed + m); }
+      constexpr time_point operator+(const time_point& m) const { return time_point(elapsed + m.elapsed); }
+      constexpr time_point operator-(const microseconds& m) const { return time_point(elapsed - m); }
+      constexpr microseconds operator-(const time_point& m) const { return microseconds(elapsed.count() - m.elapsed.count()); }
+      microseconds elapsed;
+  };
+
+  class time_point_sec {
+    public:
+      constexpr time_point_sec() : utc_seconds(0) {}
+      constexpr explicit time_point_sec(uint32_t seconds) : utc_seconds(seconds) {}
+      constexpr time_point_sec(const time_point& t) : utc_seconds(uint32_t(t.time_since_epoch().count() / 1000000ll)) {}
+      static constexpr time_point_sec maximum() { return time_point_sec(0xffffffff); }
+      static constexpr time_point_sec min() { return time_point_sec(0); }
+      constexpr operator time_point() const { return time_point(eosio::seconds(utc_seconds)); }
+      constexpr uint32_t sec_since_epoch() const { return utc_seconds; }
+      constexpr bool operator<(const time_point_sec& t) const { return utc_seconds < t.utc_seconds; }
+      constexpr bool operator<=(const time_point_sec& t) const { return utc_seconds <= t.utc_seconds; }
+      constexpr bool operator>(const time_point_sec& t) const { return utc_seconds > t.utc_seconds; }
+      constexpr bool operator>=(const time_point_sec& t) const { return utc_seconds >= t.utc_seconds; }
+      constexpr bool operator==(const time_point_sec& t) const { return utc_seconds == t.utc_seconds; }
+      constexpr bool operator!=(const time_point_sec& t) const { return utc_seconds != t.utc_seconds; }
+      time_point_sec& operator+=(uint32_t m) { utc_seconds += m; return *this; }
+      time_point_sec& operator-=(uint32_t m) { utc_seconds -= m; return *this; }
+      constexpr time_point_sec operator+(uint32_t offset) const { return time_point_sec(utc_seconds + offset); }
+      constexpr time_point_sec operator-(uint32_t offset) const { return time_point_sec(utc_seconds - offset); }
+      uint32_t utc_seconds;
+  };
+
+  class block_timestamp {
+    public:
+      explicit block_timestamp(uint32_t s = 0) : slot(s) {}
+      block_timestamp(const time_point& t) { set_time_point(t); }
+      block_timestamp(const time_point_sec& t) { set_time_point(t); }
+      time_point to_time_point() const { return (time_point)(*this); }
+      operator time_point() const {
+        int64_t msec = slot * (int64_t)block_interval_ms;
+        msec += block_timestamp_epoch;
+        return time_point(milliseconds(msec));
+      }
+      uint32_t slot;
+      static constexpr int32_t block_interval_ms = 500;
+      static constexpr int64_t block_timestamp_epoch = 946684800000ll;
+    private:
+      void set_time_point(const time_point& t) {
+        int64_t micro_since_epoch = t.time_since_epoch().count();
+        int64_t msec_since_epoch = micro_since_epoch / 1000;
+        slot = uint32_t((msec_since_epoch - block_timestamp_epoch) / int64_t(block_interval_ms));
+      }
+      void set_time_point(const time_point_sec& t) {
+        int64_t sec_since_epoch = t.sec_since_epoch();
+        slot = uint32_t((sec_since_epoch * 1000 - block_timestamp_epoch) / block_interval_ms);
+      }
+  };
+
+  typedef block_timestamp block_timestamp_type;
+
+} // namespace eosio
@@ -0,0 +1,172 @@
+// Checks history's pending points queue: transfers between the same accounts on
+// the same day share a row, drainpoints empties the queue, and a queue whose
+// drain failed is picked up again by the next transfers, with a failing row
+// parked until requeuepts puts it back. Transfers of users initcore has not
+// copied into usercore yet are still recorded.
+//
+// harvest is deployed behind a wrapper that rejects updatetxpt for one account,
+// standing in for a row that makes the drain transaction fail.
+
+#include <eosio/eosio.hpp>
+#include <contracts.hpp>
+
+#include <cstdio>
+#include <string>
+
+extern "C" {
+  void apply_settings(uint64_t receiver, uint64_t code, uint64_t action);
+  void apply_accounts(uint64_t receiver, uint64_t code, uint64_t action);
+  void apply_history(uint64_t receiver, uint64_t code, uint64_t action);
+  void apply_harvest(uint64_t receiver, uint64_t code, uint64_t action);
+  void apply_token(uint64_t receiver, uint64_t code, uint64_t action);
+}
+
+using namespace eosio;
+
+namespace {
+
+  const name issuer = bankaccts::campaigns;
+  const symbol seeds = symbol("SEEDS", 4);
+
+  const name alice = "queuealice"_n;
+  const name bob = "queuebob"_n;
+  const name carol = "queuecarol"_n;
+  const name broken = "queuebroken"_n;
+
+  bool reject_broken = true;
+  int failures = 0;
+
+  sim::chain & chain() { return sim::chain::instance(); }
+
+  void apply_failing_harvest(uint64_t receiver, uint64_t code, uint64_t act) {
+    if (code == receiver && name(act) == "updatetxpt"_n && reject_broken) {
+      name account = chain().context().act->data_as<name>();
+      check(account != broken, "updatetxpt failed");
+    }
+    apply_harvest(receiver, code, act);
+  }
+
+  template<typename... Args>
+  void push(name actor, name contract, name act, Args... args) {
+    chain().push_action(action(permission_level{actor, "active"_n}, contract, act, std::make_tuple(args...)));
+  }
+
+  void transfer(name from, name to, int64_t amount) {
+    push(from, contracts::token, "transfer"_n, from, to, asset(amount * 10000, seeds), std::string(""));
+  }
+
+  uint64_t count_rows(name scope, name table) {
+    auto t = chain().find_table(sim::table_id{ contracts::history.value, scope.value, table.value });
+    return t ? t->rows.size() : 0;
+  }
+
+  uint64_t pending_rows() { return count_rows(contracts::history, "pendingpts"_n); }
+  uint64_t parked_rows() { return count_rows("parked"_n, "pendingpts"_n); }
+
+  void expect(bool ok, const std::string & what) {
+    if (!ok) {
+      std::fprintf(stderr, "FAIL: %s\n", what.c_str());
+      failures++;
+    }
+  }
+
+  void setup() {
+    chain().deploy(contracts::settings, apply_settings);
+    chain().deploy(contracts::accounts, apply_accounts);
+    chain().deploy(contracts::history, apply_history);
+    chain().deploy(contracts::harvest, apply_failing_harvest);
+    chain().deploy(contracts::token, apply_token);
+    chain().create_account(issuer);
+    chain().set_time(time_point(seconds(1600000000)));
+
+    push(contracts::settings, contracts::settings, "reset"_n);
+    push(contracts::settings, contracts::settings, "configure"_n, "batchsize"_n, uint64_t(4));
+    push(contracts::settings, contracts::settings, "configure"_n, "txlimit.min"_n, uint64_t(1000));
+
+    push(contracts::token, contracts::token, "create"_n, issuer, asset(int64_t(1) << 60, seeds));
+    push(issuer, contracts::token, "issue"_n, issuer, asset(int64_t(1) << 59, seeds), std::string(""));
+
+    for (name user : { alice, bob, carol, broken }) {
+      chain().create_account(user);
+      push(contracts::accounts, contracts::accounts, "adduser"_n, user, std::string(""), "individual"_n);
+      push(issuer, contracts::token, "transfer"_n, issuer, user, asset(int64_t(100000) * 10000, seeds), std::string(""));
+    }
+    chain().drain_deferred();
+  }
+
+  void coalesces_transfers() {
+    transfer(alice, bob, 10);
+    transfer(alice, bob, 20);
+    transfer(alice, bob, 30);
+    transfer(bob, alice, 5);
+
+    expect(pending_rows() == 2, "transfers between the same accounts on one day share a pending row");
+    expect(chain().deferred_count() == 1, "one drainpoints is scheduled for the queue");
+
+    chain().drain_deferred();
+    expect(pending_rows() == 0, "drainpoints empties the queue");
+    expect(count_rows(contracts::history, "drainstate"_n) == 0, "an empty queue clears the drain state");
+  }
+
+  void recovers_from_failed_drain() {
+    transfer(broken, alice, 10);
+    transfer(alice, carol, 10);
+    transfer(bob, carol, 10);
+    transfer(carol, alice, 10);
+    transfer(carol, bob, 10);
+
+    chain().drain_deferred();
+    expect(chain().stats().failed_transactions > 0, "a row whose updatetxpt fails makes drainpoints fail");
+    expect(pending_rows() > 0, "the failed drain leaves the queue in place");
+    expect(chain().deferred_count() == 0, "nothing drains the queue after the failed drainpoints");
+
+    transfer(alice, bob, 1);
+    expect(chain().deferred_count() == 0, "a transfer within the drain timeout does not send another drain");
+
+    // every transfer after the timeout sends a drain with half the rows, until the failing row is parked
+    for (int i = 0; i < 8 && pending_rows() > 0; i++) {
+      chain().set_time(chain().now() + seconds(61));
+      transfer(alice, bob, 1);
+      expect(chain().deferred_count() == 1, "a transfer after the drain timeout sends drainpoints again");
+      chain().drain_deferred();
+    }
+
+    expect(pending_rows() == 0, "the rest of the queue drains");
+    expect(parked_rows() == 1, "the failing row is parked");
+
+    reject_broken = false;
+    push(contracts::history, contracts::history, "requeuepts"_n, uint64_t(0));
+    expect(parked_rows() == 0 && pending_rows() == 1, "requeuepts moves the parked row back into the queue");
+
+    chain().drain_deferred();
+    expect(pending_rows() == 0, "the requeued row drains");
+  }
+
+  void records_users_without_core_rows() {
+    auto core = chain().find_table(sim::table_id{ contracts::accounts.value, contracts::accounts.value, "usercore"_n.value });
+    core->rows.erase(alice.value);
+    core->rows.erase(carol.value);
+
+    transfer(alice, carol, 10);
+    expect(pending_rows() == 1, "a transfer between users missing from usercore is recorded");
+
+    chain().drain_deferred();
+    expect(pending_rows() == 0, "their row drains");
+  }
+
+}
+
+int main() {
+  try {
+    setup();
+    coalesces_transfers();
+    recovers_from_failed_drain();
+    records_users_without_core_rows();
+  } catch (const check_failure & e) {
+    std::fprintf(stderr, "FAIL: %s\n", e.what());
+    return 1;
+  }
+
+  if (failures == 0) std::printf("history queue: ok\n");
+  return failures == 0 ? 0 : 1;
+}
@@ -1,7 +1,7 @@
 const fs = require('fs')
 const path = require('path')
 const R = require('ramda')
-const { eos, isLocal, encodeName, getBalance, accounts, ownerPublicKey, activePublicKey, apiPublicKey, permissions, sleep } = require('./helper')
+const { eos, isLocal, encodeName, getBalance, accounts, ownerPublicKey, activePublicKey, apiPublicKey, permissions, payers, sleep } = require('./helper')
 
 const debug = process.env.DEBUG || false
 
@@ -525,6 +525,32 @@ const updatePermissions = async () => {
   }  
 }
 
+const addPayers = async () => {
+  for (let current = 0; current < payers.length; current++) {
+    const payer = payers[current]
+    try {
+      await eos.transaction({
+        actions: [
+          {
+            account: accounts.token.account,
+            name: 'addpayer',
+            authorization: [{
+              actor: accounts.token.account,
+              permission: 'active'
+            }],
+            data: {
+              sender: payer
+            }
+          }
+        ]
+      })
+      console.log(`${payer} can pay out with transfermany`)
+    } catch (err) {
+      console.error(`cannot add payer ${payer}\n* error: ` + err + `\n`)
+    }
+  }
+}
+
 const createTestToken = async () => {
   await createCoins(accounts.testtoken)
 }
@@ -564,7 +590,8 @@ const deployAllContracts = async () => {
   }
 
   await updatePermissions()
+  await addPayers()
   await reset(accounts.settings)
 }
 
-module.exports = { deployAllContracts, updatePermissions, resetByName, changeOwnerAndActivePermission, changeExistingKeyPermission, createTestToken }
+module.exports = { deployAllContracts, updatePermissions, addPayers, resetByName, changeOwnerAndActivePermission, changeExistingKeyPermission, createTestToken }
@@ -346,9 +346,27 @@ var permissions = [{
 }, {
   target: `${accounts.harvest.account}@active`,
   actor: `${accounts.history.account}@eosio.code`
+}, {
+  target: `${accounts.harvest.account}@active`,
+  actor: `${accounts.accounts.account}@eosio.code`
+}, {
+  target: `${accounts.harvest.account}@active`,
+  actor: `${accounts.region.account}@eosio.code`
+}, {
+  target: `${accounts.accounts.account}@active`,
+  actor: `${accounts.harvest.account}@eosio.code`
+}, {
+  target: `${accounts.accounts.account}@active`,
+  actor: `${accounts.region.account}@eosio.code`
+}, {
+  target: `${accounts.accounts.account}@active`,
+  actor: `${accounts.organization.account}@eosio.code`
 }, {
   target: `${accounts.token.account}@active`,
   actor: `${accounts.token.account}@eosio.code`
+}, {
+  target: `${accounts.history.account}@active`,
+  actor: `${accounts.history.account}@eosio.code`
 }, {
   target: `${accounts.history.account}@active`,
   actor: `${accounts.accounts.account}@active`
@@ -656,6 +674,12 @@ var permissions = [{
 //}
 ]
 
+// contracts allowed to pay out with token transfermany
+const payers = [
+  accounts.harvest.account,
+  accounts.gratitude.account
+]
+
 const isTestnet = chainId == networks.telosTestnet
 const isLocalNet = chainId == networks.local
 
@@ -776,7 +800,7 @@ const sleep = async (ms) => {
 
 module.exports = {
   eos, getEOSWithEndpoint, encodeName, decodeName, getBalance, getBalanceFloat, getTableRows, initContracts,
-  accounts, names, ownerPublicKey, activePublicKey, apiPublicKey, permissions, sha256, isLocal, ramdom64ByteHexString, createKeypair,
+  accounts, names, ownerPublicKey, activePublicKey, apiPublicKey, permissions, payers, sha256, isLocal, ramdom64ByteHexString, createKeypair,
   testnetUserPubkey, getTelosBalance, fromHexString, allContractNames, allContracts, allBankAccountNames, sleep
 }
 
@@ -8,7 +8,7 @@ const docsgen = require('./docsgen')
 const { settings, scheduler } = names
 
 const deploy = require('./deploy.command')
-const { deployAllContracts, updatePermissions, resetByName, changeOwnerAndActivePermission, changeExistingKeyPermission, createTestToken } = require('./deploy')
+const { deployAllContracts, updatePermissions, addPayers, resetByName, changeOwnerAndActivePermission, changeExistingKeyPermission, createTestToken } = require('./deploy')
 
 
 const getContractLocation = (contract) => {
@@ -206,6 +206,13 @@ program
     await updatePermissionAction()
   })
 
+  program
+  .command('addPayers')
+  .description('Allow harvest and gratitude to pay out with token transfermany')
+  .action(async function() {
+    await addPayers()
+  })
+
   program
   .command('updateSettings')
   .description('Deploy and reset settings contract')
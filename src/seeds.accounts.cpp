@@ -26,6 +26,11 @@ void accounts::reset() {
     uitr = users.erase(uitr);
   }
 
+  auto coreitr = usercore.begin();
+  while (coreitr != usercore.end()) {
+    coreitr = usercore.erase(coreitr);
+  }
+
   flag_points_tables flags(get_self(), flag_total_scope.value);
   auto fitr = flags.begin();
   while (fitr != flags.end()) {
@@ -53,6 +58,12 @@ void accounts::reset() {
     refitr = refs.erase(refitr);
   }
 
+  auto rsitr = refstats.begin();
+  while (rsitr != refstats.end()) {
+    rsitr = refstats.erase(rsitr);
+  }
+  set_ref_stats_state(0, true);
+
   auto cbsitr = cbs.begin();
   while (cbsitr != cbs.end()) {
     cbsitr = cbs.erase(cbsitr);
@@ -75,11 +86,28 @@ void accounts::reset() {
     o_repitr = rep_t.erase(o_repitr);
   }
 
+  for (auto tree : { rep_tree, org_rep_tree, cbs_tree, org_cbs_tree }) {
+    rank_tree_tables ranktree(get_self(), tree.value);
+    rank_tree::clear(ranktree);
+    rank_tree::built(ranktree, _self);
+  }
+
+  for (auto scope : { individual_scope, organization_scope }) {
+    rank_cursor_tables cursors(get_self(), scope.value);
+    auto citr = cursors.begin();
+    while (citr != cursors.end()) {
+      ranking::clear_shadows(get_self(), citr->job, scope);
+      citr = cursors.erase(citr);
+    }
+  }
+
   auto sitr = sizes.begin();
   while (sitr != sizes.end()) {
     sitr = sizes.erase(sitr);
   }
 
+  instrument::clear(get_self());
+  jobs::clear(get_self());
 }
 
 void accounts::history_add_resident(name account) {
@@ -108,7 +136,7 @@ void accounts::adduser(name account, string nickname, name type)
   auto uitr = users.find(account.value);
   check(uitr == users.end(), "existing user");
 
-  users.emplace(_self, [&](auto& user) {
+  auto new_user = users.emplace(_self, [&](auto& user) {
       user.account = account;
       user.status = name("visitor");
       user.reputation = 0;
@@ -116,6 +144,7 @@ void accounts::adduser(name account, string nickname, name type)
       user.nickname = nickname;
       user.timestamp = eosio::current_time_point().sec_since_epoch();
   });
+  set_user_core(*new_user);
 
   size_change("users.sz"_n, 1);
 
@@ -179,10 +208,9 @@ void accounts::_vouch(name sponsor, name account) {
         item.account = account;
         item.vouch_points = vouch_points;
       });
+      send_rep_change(account, calc_vouch_rep(account, int64_t(vouch_points)));
     }
   }
-
-  calc_vouch_rep(account); 
 }
 
 void accounts::unvouch (name sponsor, name account) {
@@ -194,31 +222,33 @@ void accounts::unvouch (name sponsor, name account) {
 
   check(vitr != vouches_by_sponsor_account.end(), "vouch not found");
 
+  int64_t vouch_points = int64_t(vitr->vouch_points);
   vouches_by_sponsor_account.erase(vitr);
   
-  calc_vouch_rep(account);
+  send_rep_change(account, calc_vouch_rep(account, -vouch_points));
 }
 
 void accounts::pnishvouched (name sponsor, uint64_t start_account) {
   require_auth(get_self());
 
   uint64_t batch_size = config_get("batchsize"_n);
-  uint128_t id = uint128_t(sponsor.value) << 64;
+  uint128_t id = (uint128_t(sponsor.value) << 64) + start_account;
 
-  auto vouches_by_account = vouches.get_index<"byaccount"_n>();
   auto vouches_by_sponsor_account = vouches.get_index<"byspnsoracct"_n>();
   uint64_t count = 0;
-  uint64_t max_vouch = config_get(max_vouch_points);
 
   auto vitr = vouches_by_sponsor_account.lower_bound(id);
 
   while (vitr != vouches_by_sponsor_account.end() && vitr->sponsor == sponsor && count < batch_size) {
 
-    vouches_by_sponsor_account.modify(vitr, _self, [&](auto & item){
-      item.vouch_points = 0;
-    });
+    int64_t vouch_points = int64_t(vitr->vouch_points);
 
-    calc_vouch_rep(vitr->account);
+    if (vouch_points > 0) {
+      vouches_by_sponsor_account.modify(vitr, _self, [&](auto & item){
+        item.vouch_points = 0;
+      });
+      send_rep_change(vitr->account, calc_vouch_rep(vitr->account, -vouch_points));
+    }
 
     vitr++;
     count++;
@@ -240,53 +270,51 @@ void accounts::pnishvouched (name sponsor, uint64_t start_account) {
   }
 }
 
-void accounts::calc_vouch_rep (name account) {
-  auto vouches_by_account = vouches.get_index<"byaccount"_n>();
-  auto vitr = vouches_by_account.find(account.value);
-
+// Applies the change of one vouch to the account's vouch total and returns how much reputation the
+// account gains (or loses) for it, capped at max_vouch_points. The caller sends the rep change.
+int64_t accounts::calc_vouch_rep (name account, int64_t vouch_delta) {
   uint64_t max_vouch = config_get(max_vouch_points);
   uint64_t total_vouch = 0;
   uint64_t total_rep = 0;
 
-  while (vitr != vouches_by_account.end() && vitr->account == account) {
-    total_vouch += vitr -> vouch_points;
-    vitr++;
+  auto vtitr = vouchtotals.find(account.value);
+  if (vtitr != vouchtotals.end()) {
+    total_vouch = vtitr->total_vouch_points;
+    total_rep = vtitr->total_rep_points;
   }
 
-  auto vtitr = vouchtotals.find(account.value);
-  if (vtitr != vouchtotals.end()) { total_rep = vtitr->total_rep_points; }
+  if (vouch_delta < 0 && uint64_t(-vouch_delta) > total_vouch) {
+    total_vouch = 0;
+  } else {
+    total_vouch = uint64_t(int64_t(total_vouch) + vouch_delta);
+  }
 
   uint64_t total_vouch_capped = std::min(total_vouch, max_vouch);
-  uint64_t delta = 0;
-
-  if (total_rep < total_vouch_capped) {
-    
-    delta = total_vouch_capped - total_rep;
-    send_addrep(account, delta);
-    total_rep += delta;
-
-  } else if (total_rep > total_vouch_capped) {
-
-    delta = total_rep - total_vouch_capped;
-    send_subrep(account, delta);
-    total_rep -= delta;
-
-  }
+  int64_t delta = int64_t(total_vouch_capped) - int64_t(total_rep);
 
   if (vtitr == vouchtotals.end()) {
     vouchtotals.emplace(_self, [&](auto & item){
       item.account = account;
       item.total_vouch_points = total_vouch;
-      item.total_rep_points = total_rep;
+      item.total_rep_points = total_vouch_capped;
     });
   } else {
     vouchtotals.modify(vtitr, _self, [&](auto & item){
       item.total_vouch_points = total_vouch;
-      item.total_rep_points = total_rep;
+      item.total_rep_points = total_vouch_capped;
     });
   }
+
+  return delta;
 }
 
+void accounts::send_rep_change(name user, int64_t delta) {
+  if (delta > 0) {
+    send_addrep(user, uint64_t(delta));
+  } else if (delta < 0) {
+    send_subrep(user, uint64_t(-delta));
+  }
+}
 
 void accounts::send_addrep(name user, uint64_t amount) {
     action(
@@ -445,23 +473,30 @@ void accounts::add_cbs(name account, int points) {
   name scope = get_scope(uitr->type);
 
   cbs_tables cbs_t(get_self(), scope.value);
+  rank_tree_tables ranktree(get_self(), (scope == organization_scope ? org_cbs_tree : cbs_tree).value);
 
   auto citr = cbs_t.find(account.value);
   if (citr != cbs_t.end()) {
+    uint32_t score = citr->community_building_score + points;
+    uint64_t rank = rank_tree::update(ranktree, account.value, true, citr->community_building_score, score, citr->rank, _self);
     cbs_t.modify(citr, _self, [&](auto& item) {
-      item.community_building_score += points;
+      item.community_building_score = score;
+      item.rank = rank;
     });
+    score_vector::send(score_vector::cbs, account, rank);
   } else {
+    uint64_t rank = rank_tree::update(ranktree, account.value, false, 0, uint32_t(points), 0, _self);
     cbs_t.emplace(_self, [&](auto& item) {
       item.account = account;
       item.community_building_score = points;
-      item.rank = 0;
+      item.rank = rank;
     });
     if (scope == individual_scope) {
       size_change("cbs.sz"_n, 1);
     } else if (scope == organization_scope) {
       size_change("cbs.org.sz"_n, 1);
     }
+    score_vector::send(score_vector::cbs, account, rank);
   }
 }
 
@@ -477,6 +512,9 @@ void accounts::addref(name referrer, name invited)
     ref.invited = invited;
   });
 
+  auto uitr = users.find(invited.value);
+  change_ref_stats(referrer, invited, name(), uitr != users.end() ? uitr->status : name(), 1);
+
 }
 
 // internal vouch function
@@ -499,6 +537,7 @@ void accounts::addrep(name user, uint64_t amount)
   users.modify(uitr, _self, [&](auto& user) {
     user.reputation += amount;
   });
+  set_user_core(*uitr);
 
   name scope = get_scope(uitr->type);
 
@@ -508,9 +547,14 @@ void accounts::addrep(name user, uint64_t amount)
   if (ritr == rep_t.end()) {
     add_rep_item(user, amount, scope);
   } else {
+    rank_tree_tables ranktree(get_self(), (scope == organization_scope ? org_rep_tree : rep_tree).value);
+    uint32_t new_rep = ritr->rep + amount;
+    uint64_t rank = rank_tree::update(ranktree, user.value, true, ritr->rep, new_rep, ritr->rank, _self);
     rep_t.modify(ritr, _self, [&](auto& item) {
-      item.rep += amount;
+      item.rep = new_rep;
+      item.rank = rank;
     });
+    send_rep_rank(user, rank);
   }
 
 }
@@ -532,6 +576,7 @@ void accounts::subrep(name user, uint64_t amount)
       user.reputation -= amount;
     }
   });
+  set_user_core(*uitr);
 
   name scope = get_scope(uitr->type);
 
@@ -539,17 +584,24 @@ void accounts::subrep(name user, uint64_t amount)
 
   auto ritr = rep_t.find(user.value);
   if (ritr != rep_t.end()) {
+    rank_tree_tables ranktree(get_self(), (scope == organization_scope ? org_rep_tree : rep_tree).value);
     if (ritr->rep > amount) {
+      uint32_t new_rep = ritr->rep - amount;
+      uint64_t rank = rank_tree::update(ranktree, user.value, true, ritr->rep, new_rep, ritr->rank, _self);
       rep_t.modify(ritr, _self, [&](auto& item) {
-        item.rep -= amount;
+        item.rep = new_rep;
+        item.rank = rank;
       });
+      send_rep_rank(user, rank);
     } else {
+      rank_tree::erase(ranktree, user.value, ritr->rep, _self);
       rep_t.erase(ritr);
       if (scope == individual_scope) {
         size_change("rep.sz"_n, -1);
       } else if (scope == organization_scope) {
         size_change("rep.org.sz"_n, -1);
       }
+      send_rep_rank(user, 0);
     }
   }
 
@@ -684,9 +736,17 @@ void accounts::updatestatus(name user, name status)
   check(uitr != users.end(), "updatestatus: user not found - " + user.to_string());
   check(uitr->type == individual, "updatestatus: Only individuals can become residents or citizens");
 
+  name previous_status = uitr->status;
+
   users.modify(uitr, _self, [&](auto& user) {
     user.status = status;
   });
+  set_user_core(*uitr);
+
+  name referrer = find_referrer(user);
+  if (referrer != not_found) {
+    change_ref_stats(referrer, user, previous_status, status, 0);
+  }
 
   bool trust = status == name("citizen");
 
@@ -824,135 +884,115 @@ uint32_t accounts::num_transactions(name account, uint32_t limit) {
 }
 
 void accounts::rankreps() {
-  rankrep(0, 0, 200, individual_scope);
+  rank_cursor_tables cursors(get_self(), individual_scope.value);
+  ranking::start(cursors, "rankrep"_n, get_size("rep.sz"_n), _self);
+  jobs::start(get_self(), "rankreps"_n);
+  rankrep(config_get("rank.budget"_n), individual_scope);
 }
 
 void accounts::rankorgreps() {
-  rankrep(0, 0, 200, organization_scope);
+  rank_cursor_tables cursors(get_self(), organization_scope.value);
+  ranking::start(cursors, "rankrep"_n, get_size("rep.org.sz"_n), _self);
+  jobs::start(get_self(), "rankorgreps"_n);
+  rankrep(config_get("rank.budget"_n), organization_scope);
 }
 
-void accounts::rankrep(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name scope) {
+void accounts::rankrep(uint64_t budget, name scope) {
   require_auth(_self);
+  instrument::begin("rankrep"_n);
 
-  uint64_t total = 0;
-  if (scope == individual_scope) {
-    total = get_size("rep.sz"_n);
-  } else if (scope == organization_scope) {
-    total = get_size("rep.org.sz"_n);
+  rank_cursor_tables cursors(get_self(), scope.value);
+  if (!ranking::running(cursors, "rankrep"_n)) {
+    uint64_t total = 0;
+    if (scope == individual_scope) {
+      total = get_size("rep.sz"_n);
+    } else if (scope == organization_scope) {
+      total = get_size("rep.org.sz"_n);
+    }
+    ranking::start(cursors, "rankrep"_n, total, _self);
   }
-  if (total == 0) return;
 
   rep_tables rep_t(get_self(), scope.value);
-
-  uint64_t current = chunk * chunksize;
   auto rep_by_rep = rep_t.get_index<"byrep"_n>();
-  auto ritr = start_val == 0 ? rep_by_rep.begin() : rep_by_rep.lower_bound(start_val);
-  uint64_t count = 0;
-
-  while (ritr != rep_by_rep.end() && count < chunksize) {
-
-    uint64_t rank = utils::rank(current, total);
-
-    rep_by_rep.modify(ritr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
 
-    current++;
-    count++;
-    ritr++;
-  }
+  name job = scope == individual_scope ? "rankreps"_n : "rankorgreps"_n;
+  uint64_t ranked = ranking::position(cursors, "rankrep"_n);
+  std::vector<score_vector::rank_update> ranks;
+  bool done = ranking::step(cursors, "rankrep"_n, rep_by_rep, budget, _self, [&](uint64_t account, uint64_t rank) {
+    ranks.push_back(score_vector::rank_update{ name(account), rank });
+    set_profile_rep_rank(name(account), rank);
+  });
+  score_vector::send(score_vector::rep, ranks);
+  jobs::chunk(get_self(), job, ranking::position(cursors, "rankrep"_n) - ranked);
 
-  if (ritr == rep_by_rep.end()) {
-    // Done.
+  if (done) {
+    jobs::finish(get_self(), job);
   } else {
-    // recursive call
-    uint64_t next_value = ritr->by_rep();
-    action next_execution(
-        permission_level{get_self(), "active"_n},
-        get_self(),
-        "rankrep"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize, scope)
-    );
-
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(next_value + 1, _self);
-    
+    ranking::schedule(get_self(), "rankrep"_n, ranking::sender_id("rankrep"_n, scope), budget, scope);
   }
 
+  instrument::end(get_self());
 }
 
 void accounts::rankcbss() {
-  rankcbs(0, 0, 200, individual_scope);
+  rank_cursor_tables cursors(get_self(), individual_scope.value);
+  ranking::start(cursors, "rankcbs"_n, get_size("cbs.sz"_n), _self);
+  jobs::start(get_self(), "rankcbss"_n);
+  rankcbs(config_get("rank.budget"_n), individual_scope);
 }
 
 void accounts::rankorgcbss() {
-  rankcbs(0, 0, 200, organization_scope);
+  rank_cursor_tables cursors(get_self(), organization_scope.value);
+  ranking::start(cursors, "rankcbs"_n, get_size("cbs.org.sz"_n), _self);
+  jobs::start(get_self(), "rankorgcbss"_n);
+  rankcbs(config_get("rank.budget"_n), organization_scope);
 }
 
-void accounts::rankcbs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name scope) {
+void accounts::rankcbs(uint64_t budget, name scope) {
   require_auth(_self);
+  instrument::begin("rankcbs"_n);
 
-  uint64_t total = 0;
-
-  if (scope == individual_scope) {
-    total = get_size("cbs.sz"_n);
-  } else {
-    total = get_size("cbs.org.sz"_n);
+  rank_cursor_tables cursors(get_self(), scope.value);
+  if (!ranking::running(cursors, "rankcbs"_n)) {
+    uint64_t total = scope == individual_scope ? get_size("cbs.sz"_n) : get_size("cbs.org.sz"_n);
+    ranking::start(cursors, "rankcbs"_n, total, _self);
   }
-  if (total == 0) return;
 
   cbs_tables cbs_t(get_self(), scope.value);
-
-  uint64_t current = chunk * chunksize;
   auto cbs_by_cbs = cbs_t.get_index<"bycbs"_n>();
-  auto citr = start_val == 0 ? cbs_by_cbs.begin() : cbs_by_cbs.lower_bound(start_val);
-  uint64_t count = 0;
-
-  while (citr != cbs_by_cbs.end() && count < chunksize) {
-
-    uint64_t rank = utils::rank(current, total);
-
-    cbs_by_cbs.modify(citr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
 
-    current++;
-    count++;
-    citr++;
-  }
+  name job = scope == individual_scope ? "rankcbss"_n : "rankorgcbss"_n;
+  uint64_t ranked = ranking::position(cursors, "rankcbs"_n);
+  std::vector<score_vector::rank_update> ranks;
+  bool done = ranking::step(cursors, "rankcbs"_n, cbs_by_cbs, budget, _self, [&](uint64_t account, uint64_t rank) {
+    ranks.push_back(score_vector::rank_update{ name(account), rank });
+  });
+  score_vector::send(score_vector::cbs, ranks);
+  jobs::chunk(get_self(), job, ranking::position(cursors, "rankcbs"_n) - ranked);
 
-  if (citr == cbs_by_cbs.end()) {
-    // Done.
+  if (done) {
+    jobs::finish(get_self(), job);
   } else {
-    // recursive call
-    uint64_t next_value = citr->by_cbs();
-    action next_execution(
-        permission_level{get_self(), "active"_n},
-        get_self(),
-        "rankcbs"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize, scope)
-    );
-
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(next_value + 1, _self);
-    
+    ranking::schedule(get_self(), "rankcbs"_n, ranking::sender_id("rankcbs"_n, scope), budget, scope);
   }
 
+  instrument::end(get_self());
 }
 
 void accounts::add_rep_item(name account, uint64_t reputation, name scope) {
   check(reputation > 0, "reputation must be > 0");
 
   rep_tables rep_t(get_self(), scope.value);
+  rank_tree_tables ranktree(get_self(), (scope == organization_scope ? org_rep_tree : rep_tree).value);
+
+  uint64_t rank = rank_tree::update(ranktree, account.value, false, 0, reputation, 0, _self);
 
   rep_t.emplace(_self, [&](auto& item) {
     item.account = account;
     item.rep = reputation;
+    item.rank = rank;
   });
+  send_rep_rank(account, rank);
 
   if (scope == individual_scope) {
     size_change("rep.sz"_n, 1);
@@ -1033,7 +1073,13 @@ void accounts::testremove(name user)
     std::make_tuple(user, false)
   ).send();
 
+  name referrer = find_referrer(user);
+  if (referrer != not_found) {
+    change_ref_stats(referrer, user, uitr->status, name(), 0);
+  }
+
   users.erase(uitr);
+  erase_user_core(user);
   size_change("users.sz"_n, -1);
   
 }
@@ -1047,6 +1093,7 @@ void accounts::testsetrep(name user, uint64_t amount) {
   users.modify(uitr, _self, [&](auto& user) {
     user.reputation = amount;
   });
+  set_user_core(*uitr);
 
   name scope = get_scope(uitr->type);
 
@@ -1056,9 +1103,13 @@ void accounts::testsetrep(name user, uint64_t amount) {
   if (ritr == rep_t.end()) {
     add_rep_item(user, amount, scope);
   } else {
+    rank_tree_tables ranktree(get_self(), (scope == organization_scope ? org_rep_tree : rep_tree).value);
+    uint64_t rank = rank_tree::update(ranktree, user.value, true, ritr->rep, amount, ritr->rank, _self);
     rep_t.modify(ritr, _self, [&](auto& item) {
       item.rep = amount;
+      item.rank = rank;
     });
+    send_rep_rank(user, rank);
   }
 }
 
@@ -1076,8 +1127,11 @@ void accounts::testsetrs(name user, uint64_t amount) {
 
   auto ritr = rep_t.find(user.value);
   if (ritr == rep_t.end()) {
+    rank_tree_tables ranktree(get_self(), (scope == organization_scope ? org_rep_tree : rep_tree).value);
+    rank_tree::change(ranktree, user.value, false, 0, 0, _self);
     rep_t.emplace(_self, [&](auto& item) {
       item.account = user;
+      item.rep = 0;
       item.rank = amount;
     });
     if (scope == individual_scope) {
@@ -1090,6 +1144,7 @@ void accounts::testsetrs(name user, uint64_t amount) {
       item.rank = amount;
     });
   }
+  send_rep_rank(user, amount);
 }
 
 void accounts::send_add_cbs_org (name user, uint64_t amount) {
@@ -1112,23 +1167,29 @@ void accounts::testsetcbs(name user, uint64_t amount) {
   name scope = get_scope(usritr->type);
 
   cbs_tables cbs_t(get_self(), scope.value);
+  rank_tree_tables ranktree(get_self(), (scope == organization_scope ? org_cbs_tree : cbs_tree).value);
 
   auto citr = cbs_t.find(user.value);
   if (citr == cbs_t.end()) {
+    uint64_t rank = rank_tree::update(ranktree, user.value, false, 0, amount, 0, _self);
     cbs_t.emplace(_self, [&](auto& item) {
       item.account = user;
       item.community_building_score = amount;
-      item.rank = 0;
+      item.rank = rank;
     });
     if (scope == individual_scope) {
       size_change("cbs.sz"_n, 1);
     } else {
       size_change("cbs.org.sz"_n, 1);
     }
+    score_vector::send(score_vector::cbs, user, rank);
   } else {
+    uint64_t rank = rank_tree::update(ranktree, user.value, true, citr->community_building_score, amount, citr->rank, _self);
     cbs_t.modify(citr, _self, [&](auto& item) {
       item.community_building_score = amount;
+      item.rank = rank;
     });
+    score_vector::send(score_vector::cbs, user, rank);
   }
 }
 
@@ -1138,30 +1199,142 @@ void accounts::check_user(name account)
   check(uitr != users.end(), "no user");
 }
 
+// copies the fields other contracts read into the user's usercore row
+void accounts::set_user_core(const user_table & user) {
+  auto citr = usercore.find(user.account.value);
+  auto copy = [&](auto & item) {
+    item.account = user.account;
+    item.status = user.status;
+    item.type = user.type;
+    item.reputation = user.reputation;
+    item.timestamp = user.timestamp;
+  };
+  if (citr == usercore.end()) {
+    // the row can be new for an existing user initcore has not reached, or one that planted or joined
+    // a region or organization before becoming a user
+    usercore.emplace(_self, [&](auto & item) {
+      copy(item);
+      user_core::read_profile(item);
+    });
+  } else {
+    usercore.modify(citr, _self, copy);
+  }
+}
+
+void accounts::set_profile_rep_rank(name account, uint64_t rank) {
+  auto citr = usercore.find(account.value);
+  if (citr != usercore.end() && citr->rep_rank != rank) {
+    usercore.modify(citr, _self, [&](auto & item) {
+      item.rep_rank = rank;
+    });
+  }
+}
+
+void accounts::send_rep_rank(name account, uint64_t rank) {
+  set_profile_rep_rank(account, rank);
+  score_vector::send(score_vector::rep, account, rank);
+}
+
+ACTION accounts::setprofile(name field, name account, uint64_t value) {
+  require_auth(get_self());
+
+  check(field == transfer_profile::planted || field == transfer_profile::region || field == transfer_profile::org_status,
+    "invalid profile field " + field.to_string());
+
+  auto citr = usercore.find(account.value);
+  if (citr == usercore.end()) {
+    return;
+  }
+
+  usercore.modify(citr, _self, [&](auto & item) {
+    if (field == transfer_profile::planted) {
+      item.planted = value;
+    } else if (field == transfer_profile::region) {
+      item.region = name(value);
+    } else {
+      item.org_status = value;
+    }
+  });
+}
+
+void accounts::erase_user_core(name account) {
+  auto citr = usercore.find(account.value);
+  if (citr != usercore.end()) {
+    usercore.erase(citr);
+  }
+}
+
 uint64_t accounts::countrefs(name user, int check_num_residents) 
 {
-    auto refs_by_referrer = refs.get_index<"byreferrer"_n>();
-    if (check_num_residents == 0) {
-      return std::distance(refs_by_referrer.lower_bound(user.value), refs_by_referrer.upper_bound(user.value));
-    } else {
+    // until initrefstats has counted every referral, count them from refs
+    if (!refstatsst.get_or_default(referral_stats_state_table{ 0, false }).built) {
+      auto refs_by_referrer = refs.get_index<"byreferrer"_n>();
       uint64_t count = 0;
-      int residents = 0;
+      uint64_t residents = 0;
       auto ritr = refs_by_referrer.lower_bound(user.value);
       while (ritr != refs_by_referrer.end() && ritr->referrer == user) {
-        auto uitr = users.find(ritr->invited.value);
-        if (uitr != users.end()) {
-          if (uitr->status == "resident"_n || uitr->status == "citizen"_n) {
+        if (check_num_residents > 0) {
+          auto uitr = users.find(ritr->invited.value);
+          if (uitr != users.end() && (uitr->status == "resident"_n || uitr->status == "citizen"_n)) {
             residents++;
           }
         }
         ritr++;
         count++;
       }
-      check(residents >= check_num_residents, "user has not referred enough residents or citizens: "+std::to_string(residents));
+      check(residents >= uint64_t(check_num_residents), "user has not referred enough residents or citizens: "+std::to_string(residents));
       return count;
     }
 
+    auto rsitr = refstats.find(user.value);
+    if (rsitr == refstats.end()) {
+      check(check_num_residents == 0, "user has not referred enough residents or citizens: 0");
+      return 0;
+    }
+
+    uint64_t residents = rsitr->residents + rsitr->citizens;
+    check(residents >= uint64_t(check_num_residents), "user has not referred enough residents or citizens: "+std::to_string(residents));
+    return rsitr->referrals;
+}
+
+// Moves one invited account between the status counters of its referrer, from_status or to_status is
+// empty when the account is not a user. referrals is 1 for a new referral. Referrals initrefstats has not
+// reached yet are left to it, it reads their status when it gets there.
+void accounts::change_ref_stats(name referrer, name invited, name from_status, name to_status, int64_t referrals) {
+  referral_stats_state_table state = refstatsst.get_or_default(referral_stats_state_table{ 0, false });
+  if (!state.built && invited.value >= state.next) {
+    return;
+  }
+  update_ref_stats(referrer, from_status, to_status, referrals);
+}
+
+void accounts::update_ref_stats(name referrer, name from_status, name to_status, int64_t referrals) {
+  int64_t residents = int64_t(to_status == name("resident")) - int64_t(from_status == name("resident"));
+  int64_t citizens = int64_t(to_status == name("citizen")) - int64_t(from_status == name("citizen"));
 
+  if (referrals == 0 && residents == 0 && citizens == 0) {
+    return;
+  }
+
+  auto change = [](uint64_t value, int64_t delta) {
+    return delta < 0 && uint64_t(-delta) > value ? 0 : uint64_t(int64_t(value) + delta);
+  };
+
+  auto rsitr = refstats.find(referrer.value);
+  if (rsitr == refstats.end()) {
+    refstats.emplace(_self, [&](auto & item) {
+      item.referrer = referrer;
+      item.referrals = change(0, referrals);
+      item.residents = change(0, residents);
+      item.citizens = change(0, citizens);
+    });
+  } else {
+    refstats.modify(rsitr, _self, [&](auto & item) {
+      item.referrals = change(item.referrals, referrals);
+      item.residents = change(item.residents, residents);
+      item.citizens = change(item.citizens, citizens);
+    });
+  }
 }
 
 uint64_t accounts::rep_score(name user) 
@@ -1337,14 +1510,12 @@ void accounts::removeflag (name from, name to) {
 }
 
 void accounts::send_eval_demote (name to) {
-  
-  uint64_t batch_size = config_get(name("batchsize"));
 
   action next_execution(
     permission_level(get_self(), "active"_n),
     get_self(),
     "evaldemote"_n,
-    std::make_tuple(to, uint64_t(0), uint64_t(0), batch_size)
+    std::make_tuple(to)
   );
 
   transaction tx;
@@ -1354,79 +1525,74 @@ void accounts::send_eval_demote (name to) {
 
 }
 
-void accounts::evaldemote (name to, uint64_t start_val, uint64_t chunk, uint64_t chunksize) {
+// deferred so it sees the reputation after the punishment's subrep
+void accounts::evaldemote (name to) {
   require_auth(get_self());
 
-  auto uritr = rep.find(to.value);
-  if (uritr == rep.end()) {
+  auto ritr = rep.find(to.value);
+  if (ritr == rep.end()) {
     updatestatus(to, name("visitor"));
     return;
   }
 
-  uint64_t total = get_size("rep.sz"_n);
-  if (total == 0) return;
+  // ranks are only known once the tree holds every rep row
+  rank_tree_tables ranktree(get_self(), rep_tree.value);
+  if (!rank_tree::ready(ranktree) || rank_tree::total(ranktree) == 0) return;
 
-  uint64_t current = chunk * chunksize;
-  auto rep_by_rep = rep.get_index<"byrep"_n>();
-  auto ritr = start_val == 0 ? rep_by_rep.begin() : rep_by_rep.lower_bound(start_val);
-  uint64_t count = 0;
-  bool evaluated = false;
+  uint64_t rank = rank_tree::rank_of(ranktree, ritr->rep);
 
-  while (ritr != rep_by_rep.end() && count < chunksize) {
+  if (ritr->rank != rank) {
+    rep.modify(ritr, _self, [&](auto& item) {
+      item.rank = rank;
+    });
+    send_rep_rank(to, rank);
+  }
 
-    if (ritr->account == to) {
-      uint64_t rank = utils::rank(current, total);
+  auto uitr = users.find(to.value);
 
-      rep_by_rep.modify(ritr, _self, [&](auto& item) {
-        item.rank = rank;
-      });
+  uint64_t min_rep_score_citizen = config_get("cit.rep.sc"_n);
+  uint64_t min_rep_score_resident = config_get("res.rep.pt"_n);
 
-      auto uitr = users.find(ritr->account.value);
+  name current_rank = uitr->status;
 
-      uint64_t min_rep_score_citizen = config_get("cit.rep.sc"_n);
-      uint64_t min_rep_score_resident = config_get("res.rep.pt"_n);
+  if (rank < min_rep_score_resident) {
+    current_rank = name("visitor");
+  } else if (rank < min_rep_score_citizen) {
+    current_rank = name("resident");
+  } else {
+    current_rank = name("citizen");
+  }
 
-      name current_rank = uitr->status;
+  if (uitr->status == name("citizen") && current_rank != name("citizen")) {
+    updatestatus(uitr->account, current_rank);
+  }
+  else if (uitr->status == name("resident") && current_rank == name("visitor")) {
+    updatestatus(uitr->account, name("visitor"));
+  }
 
-      if (rank < min_rep_score_resident) {
-        current_rank = name("visitor");
-      } else if (rank < min_rep_score_citizen) {
-        current_rank = name("resident");
-      } else {
-        current_rank = name("citizen");
-      }
+}
 
-      if (uitr->status == name("citizen") && current_rank != name("citizen")) {
-        updatestatus(uitr->account, current_rank);
-      }
-      else if (uitr->status == name("resident") && current_rank == name("visitor")) {
-        updatestatus(uitr->account, name("visitor"));
-      }
+// read only, prints the account's current rank in one of the ranked tables
+void accounts::rankof (name tree, name account) {
+  check(tree == rep_tree || tree == org_rep_tree || tree == cbs_tree || tree == org_cbs_tree, "invalid rank tree " + tree.to_string());
 
-      evaluated = true;
-      break;
-    }
+  name scope = tree == org_rep_tree || tree == org_cbs_tree ? organization_scope : individual_scope;
+  uint64_t value = 0;
 
-    current++;
-    count++;
-    ritr++;
-  }
-
-  if (!evaluated && ritr != rep_by_rep.end()) {
-    uint64_t next_value = ritr->by_rep();
-    action next_execution(
-      permission_level{get_self(), "active"_n},
-      get_self(),
-      "evaldemote"_n,
-      std::make_tuple(to, next_value, chunk + 1, chunksize)
-    );
-
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(next_value + 1, _self); 
+  if (tree == rep_tree || tree == org_rep_tree) {
+    rep_tables rep_t(get_self(), scope.value);
+    auto ritr = rep_t.find(account.value);
+    check(ritr != rep_t.end(), account.to_string() + " has no reputation");
+    value = ritr->rep;
+  } else {
+    cbs_tables cbs_t(get_self(), scope.value);
+    auto citr = cbs_t.find(account.value);
+    check(citr != cbs_t.end(), account.to_string() + " has no community building score");
+    value = citr->community_building_score;
   }
 
+  rank_tree_tables ranktree(get_self(), tree.value);
+  print("account:", account, ", rank:", rank_tree::rank_of(ranktree, value), "\n");
 }
 
 
@@ -1517,7 +1683,11 @@ void accounts::migratevouch (uint64_t start_user, uint64_t start_sponsor, uint64
 ACTION accounts::testmigscope (name account, uint64_t amount) {
   require_auth(get_self());
 
+  rank_tree_tables cbs_ranktree(get_self(), cbs_tree.value);
+  rank_tree_tables rep_ranktree(get_self(), rep_tree.value);
+
   auto citr = cbs.find(account.value);
+  rank_tree::change(cbs_ranktree, account.value, citr != cbs.end(), citr != cbs.end() ? citr->community_building_score : 0, amount, _self);
   if (citr != cbs.end()) {
     cbs.modify(citr, _self, [&](auto & item){
       item.community_building_score = amount;
@@ -1532,6 +1702,7 @@ ACTION accounts::testmigscope (name account, uint64_t amount) {
   }
 
   auto ritr = rep.find(account.value);
+  rank_tree::change(rep_ranktree, account.value, ritr != rep.end(), ritr != rep.end() ? ritr->rep : 0, amount, _self);
   if (ritr != rep.end()) {
     rep.modify(ritr, _self, [&](auto & item){
       item.rep = amount;
@@ -1552,6 +1723,8 @@ ACTION accounts::migorgs (uint64_t start) {
 
   cbs_tables cbs_org(get_self(), organization_scope.value);
   rep_tables rep_org(get_self(), organization_scope.value);
+  rank_tree_tables cbs_ranktree(get_self(), org_cbs_tree.value);
+  rank_tree_tables rep_ranktree(get_self(), org_rep_tree.value);
 
   auto uitr = start == 0 ? users.begin() : users.find(start);
 
@@ -1574,6 +1747,8 @@ ACTION accounts::migorgs (uint64_t start) {
     if (citr != cbs.end()) {
 
       auto cbs_itr_org = cbs_org.find(org_name.value);
+      bool existed = cbs_itr_org != cbs_org.end();
+      rank_tree::change(cbs_ranktree, org_name.value, existed, existed ? cbs_itr_org->community_building_score : 0, citr->community_building_score, _self);
 
       if (cbs_itr_org != cbs_org.end()) {
         cbs_org.modify(cbs_itr_org, _self, [&](auto & item){
@@ -1596,6 +1771,8 @@ ACTION accounts::migorgs (uint64_t start) {
     if (ritr != rep.end()) {
 
       auto rep_itr_org = rep_org.find(org_name.value);
+      bool existed = rep_itr_org != rep_org.end();
+      rank_tree::change(rep_ranktree, org_name.value, existed, existed ? rep_itr_org->rep : 0, ritr->rep, _self);
 
       if (rep_itr_org != rep_org.end()) {
         rep_org.modify(rep_itr_org, _self, [&](auto & item){
@@ -1636,6 +1813,9 @@ ACTION accounts::migorgs (uint64_t start) {
 ACTION accounts::delcbsreporg (uint64_t start) {
   require_auth(get_self());
 
+  rank_tree_tables cbs_ranktree(get_self(), cbs_tree.value);
+  rank_tree_tables rep_ranktree(get_self(), rep_tree.value);
+
   auto uitr = start == 0 ? users.begin() : users.find(start);
 
   uint64_t batch_size = config_get(name("batchsize"));
@@ -1652,10 +1832,16 @@ ACTION accounts::delcbsreporg (uint64_t start) {
     name org_name = uitr->account;
 
     auto citr = cbs.find(org_name.value);
-    if (citr != cbs.end()) { cbs.erase(citr); }
+    if (citr != cbs.end()) {
+      rank_tree::erase(cbs_ranktree, org_name.value, citr->community_building_score, _self);
+      cbs.erase(citr);
+    }
 
     auto ritr = rep.find(org_name.value);
-    if (ritr != rep.end()) { rep.erase(ritr); }
+    if (ritr != rep.end()) {
+      rank_tree::erase(rep_ranktree, org_name.value, ritr->rep, _self);
+      rep.erase(ritr);
+    }
 
     uitr++;
     count++;
@@ -1676,6 +1862,142 @@ ACTION accounts::delcbsreporg (uint64_t start) {
   }
 }
 
+// copies every users row into usercore, together with the transfer profile fields
+ACTION accounts::initcore (uint64_t start) {
+  require_auth(get_self());
+
+  uint64_t batch_size = config_get(name("batchsize"));
+  uint64_t count = 0;
+
+  auto uitr = start == 0 ? users.begin() : users.lower_bound(start);
+  while (uitr != users.end() && count < batch_size) {
+    set_user_core(*uitr);
+
+    usercore.modify(usercore.find(uitr->account.value), _self, [&](auto & item) {
+      user_core::read_profile(item);
+    });
+
+    uitr++;
+    count++;
+  }
+
+  if (uitr != users.end()) {
+    uint64_t next_value = uitr->account.value;
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "initcore"_n,
+      std::make_tuple(next_value)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(next_value, _self);
+  }
+}
+
+void accounts::set_ref_stats_state(uint64_t next, bool built) {
+  refstatsst.set(referral_stats_state_table{ next, built }, _self);
+}
+
+// fills refstats from the refs table, start 0 rebuilds it from scratch
+ACTION accounts::initrefstats (uint64_t start) {
+  require_auth(get_self());
+
+  if (start == 0) {
+    auto rsitr = refstats.begin();
+    while (rsitr != refstats.end()) {
+      rsitr = refstats.erase(rsitr);
+    }
+  }
+
+  uint64_t batch_size = config_get(name("batchsize"));
+  uint64_t count = 0;
+
+  auto ritr = refs.lower_bound(start);
+  while (ritr != refs.end() && count < batch_size) {
+    auto uitr = users.find(ritr->invited.value);
+    update_ref_stats(ritr->referrer, name(), uitr != users.end() ? uitr->status : name(), 1);
+    ritr++;
+    count++;
+  }
+
+  if (ritr != refs.end()) {
+    uint64_t next_value = ritr->invited.value;
+    set_ref_stats_state(next_value, false);
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "initrefstats"_n,
+      std::make_tuple(next_value)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(next_value, _self);
+  } else {
+    set_ref_stats_state(0, true);
+  }
+}
+
+// fills a rank tree from the rows already in its table, start 0 rebuilds it from scratch
+ACTION accounts::initranks (name tree, uint64_t start) {
+  require_auth(get_self());
+
+  check(tree == rep_tree || tree == org_rep_tree || tree == cbs_tree || tree == org_cbs_tree, "invalid rank tree " + tree.to_string());
+
+  rank_tree_tables ranktree(get_self(), tree.value);
+  if (start == 0) {
+    rank_tree::clear(ranktree);
+  }
+
+  name scope = tree == org_rep_tree || tree == org_cbs_tree ? organization_scope : individual_scope;
+
+  uint64_t batch_size = config_get(name("batchsize"));
+  uint64_t count = 0;
+  uint64_t next = 0;
+
+  if (tree == rep_tree || tree == org_rep_tree) {
+    rep_tables rep_t(get_self(), scope.value);
+    auto ritr = rep_t.lower_bound(start);
+    while (ritr != rep_t.end() && count < batch_size) {
+      rank_tree::insert(ranktree, ritr->rep, _self);
+      ritr++;
+      count++;
+    }
+    if (ritr != rep_t.end()) next = ritr->account.value;
+  } else {
+    cbs_tables cbs_t(get_self(), scope.value);
+    auto citr = cbs_t.lower_bound(start);
+    while (citr != cbs_t.end() && count < batch_size) {
+      rank_tree::insert(ranktree, citr->community_building_score, _self);
+      citr++;
+      count++;
+    }
+    if (citr != cbs_t.end()) next = citr->account.value;
+  }
+
+  if (next != 0) {
+    rank_tree::built_to(ranktree, next, _self);
+
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "initranks"_n,
+      std::make_tuple(tree, next)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(tree.value, _self);
+  } else {
+    rank_tree::built(ranktree, _self);
+  }
+}
+
 // TDDO: remove along with migratevouch
 void accounts::migrate_calc_vouch_rep (name account) {
   auto vouches_by_account = vouches.get_index<"byaccount"_n>();
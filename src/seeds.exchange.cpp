@@ -126,8 +126,9 @@ void exchange::purchase_usd(name buyer, asset usd_quantity, string paymentSymbol
   uint64_t seeds_amount = seeds_for_usd(usd_quantity).amount;
   asset seeds_quantity = asset(seeds_amount, seeds_symbol);
   
+  uint64_t epoch = epoch_counter::current(epochs, dailystats_counter);
   auto sitr = dailystats.find(buyer.value);
-  if (sitr != dailystats.end()) {
+  if (sitr != dailystats.end() && epoch_counter::fresh(*sitr, epoch)) {
     seeds_purchased = sitr->seeds_purchased;
   }
   
@@ -146,9 +147,11 @@ void exchange::purchase_usd(name buyer, asset usd_quantity, string paymentSymbol
     dailystats.emplace(get_self(), [&](auto& s) {
       s.buyer_account = buyer;
       s.seeds_purchased = seeds_amount;
+      s.epoch = epoch;
     });
   } else {
     dailystats.modify(sitr, get_self(), [&](auto& s) {
+      epoch_counter::renew(s, epoch, [](auto& s) { s.seeds_purchased = 0; });
       s.seeds_purchased += seeds_amount;
     }); 
   }
@@ -264,14 +267,8 @@ void exchange::newpayment(name recipientAccount, string paymentSymbol, string pa
 
 void exchange::onperiod() {
   require_auth(get_self());
-  
-  auto sitr = dailystats.begin();
-  
-  while (sitr != dailystats.end()) {
-    sitr = dailystats.erase(sitr);
-  }
-
 
+  epoch_counter::advance(epochs, dailystats_counter, get_self());
 }
 
 void exchange::updatelimit(asset citizen_limit, asset resident_limit, asset visitor_limit) {
@@ -148,21 +148,31 @@ int64_t forum::pointsfunction(name account, int64_t points_left, uint64_t vbp, u
 int64_t forum::getpoints(name account) {
 
     auto itr = votespower.find(account.value);
-    auto userit = users.get(account.value, "User does not exist.");
+    user_core_table userit;
+    check(user_core::find(account, userit), "User does not exist.");
     auto vbpitr = config.get(vbp.value, "Vote Base Point value is not configured.");
     auto cutoffitr = config.get(cutoff.value, "Cut off value is not configured.");
     auto cutoffzitr = config.get(cutoffz.value, "Cut off zero value is not configured.");
 
-    if(itr == votespower.end()){
+    uint64_t epoch = epoch_counter::current(epochs, votepower_counter);
+
+    if(itr == votespower.end() || !epoch_counter::fresh(*itr, epoch)){
         auto maxpitr = config.get(maxpoints.value, "Max points value is not configured.");
         int64_t max_points = (maxpitr.value) * (vbpitr.value / 10000.0) * (userit.reputation / 10000.0);
 
-        votespower.emplace(_self, [&](auto& new_vote) {
+        auto new_day = [&](auto& new_vote) {
             new_vote.account = account;
             new_vote.num_votes = 0;
             new_vote.points_left = max_points;
             new_vote.max_points = max_points;
-        });
+            new_vote.epoch = epoch;
+        };
+
+        if(itr == votespower.end()){
+            votespower.emplace(_self, new_day);
+        } else {
+            votespower.modify(itr, _self, new_day);
+        }
 
         return pointsfunction(account, max_points, vbpitr.value, userit.reputation, cutoffitr.value, cutoffzitr.value);
     }
@@ -251,6 +261,11 @@ ACTION forum::reset() {
         dayitr = votespower.erase(dayitr);
     }
 
+    auto eitr = epochs.begin();
+    while (eitr != epochs.end()) {
+        eitr = epochs.erase(eitr);
+    }
+
     auto aitr = actives.begin();
     while (aitr != actives.end()) {
         aitr = actives.erase(aitr);
@@ -260,13 +275,16 @@ ACTION forum::reset() {
     while (sitr != sizes.end()) {
         sitr = sizes.erase(sitr);
     }
+
+    jobs::clear(get_self());
 }
 
 
 ACTION forum::createpost(name account, uint64_t backend_id, string url, string body) {
     require_auth(account);
 
-    auto user = users.get(account.value, "User does not exist.");
+    user_core_table user;
+    check(user_core::find(account, user), "User does not exist.");
     createpostcomment(account, 0, backend_id, url, body);
 
     auto repitr = forumreps.find(account.value);
@@ -385,54 +403,28 @@ ACTION forum::onperiod() {
 ACTION forum::newday() {
     require_auth(permission_level(contracts::forum, "execute"_n));
 
-    auto itr = votespower.begin();
-    while(itr != votespower.end()){
-        itr = votespower.erase(itr);
-    }
+    epoch_counter::advance(epochs, votepower_counter, _self);
 }
 
 ACTION forum::rankforums() {
-    uint64_t batch_size = config.get(name("batchsize").value, "The batchsize parameter has not been initialized yet").value;
-    rankforum(0, batch_size, 0);
+    uint64_t budget = config.get(name("rank.budget").value, "The rank.budget parameter has not been initialized yet").value;
+    rank_cursor_tables cursors(get_self(), get_self().value);
+    ranking::start(cursors, "rankforum"_n, get_size(repsize), _self);
+    rankforum(budget);
 }
 
-ACTION forum::rankforum(uint64_t start, uint64_t chunksize, uint64_t chunk) {
+ACTION forum::rankforum(uint64_t budget) {
     require_auth(get_self());
 
-    uint64_t total = get_size(repsize);
-    if (total == 0) return;
-
-    uint64_t current = chunk * chunksize;
-    auto forum_rep_by_points = forumreps.get_index<"byrep"_n>();
-    auto fitr = start == 0 ? forum_rep_by_points.begin() : forum_rep_by_points.lower_bound(start);
-    uint64_t count = 0;
-
-    while (fitr != forum_rep_by_points.end() && count < chunksize) {
-
-        uint64_t rank = utils::rank(current, total);
-
-        forum_rep_by_points.modify(fitr, _self, [&](auto& item) {
-            item.rank = rank;
-        });
-
-        current++;
-        count++;
-        fitr++;
+    rank_cursor_tables cursors(get_self(), get_self().value);
+    if (!ranking::running(cursors, "rankforum"_n)) {
+        ranking::start(cursors, "rankforum"_n, get_size(repsize), _self);
     }
 
-    if (fitr != forum_rep_by_points.end()) {
-        uint64_t next_value = (fitr -> account).value;
-        action next_execution(
-            permission_level{get_self(), "active"_n},
-            get_self(),
-            "rankforum"_n,
-            std::make_tuple(next_value, chunk + 1, chunksize)
-        );
+    auto forum_rep_by_points = forumreps.get_index<"byrep"_n>();
 
-        transaction tx;
-        tx.actions.emplace_back(next_execution);
-        tx.delay_sec = 1;
-        tx.send(repsize.value, _self);
+    if (!ranking::step(cursors, "rankforum"_n, forum_rep_by_points, budget, _self)) {
+        ranking::schedule(get_self(), "rankforum"_n, ranking::sender_id("rankforum"_n, get_self()), budget);
     }
 }
 
@@ -451,6 +443,7 @@ uint64_t forum::get_available_points() {
 ACTION forum::givereps() {
     uint64_t batch_size = config.get(name("batchsize").value, "The batchsize parameter has not been initialized yet").value;
     uint64_t available_points = get_available_points();
+    jobs::start(get_self(), "givereps"_n);
     giverep(0, batch_size, available_points);
     delteactives();
 }
@@ -478,6 +471,8 @@ ACTION forum::giverep(uint64_t start, uint64_t chunksize, uint64_t available_poi
         count++;
     }
 
+    jobs::chunk(get_self(), "givereps"_n, count);
+
     if (fitr != forumreps.end()) {
         uint64_t next_value = (fitr -> account).value;
         action next_execution(
@@ -491,6 +486,8 @@ ACTION forum::giverep(uint64_t start, uint64_t chunksize, uint64_t available_poi
         tx.actions.emplace_back(next_execution);
         tx.delay_sec = 1;
         tx.send(activesize.value, _self);
+    } else {
+        jobs::finish(get_self(), "givereps"_n);
     }
 }
 
@@ -54,6 +54,8 @@ ACTION gratitude::newround() {
   uint64_t tot_accounts = get_size("balances.sz"_n);
   uint64_t volume = get_current_volume();
 
+  std::vector<std::pair<name, asset>> payouts;
+
   auto bitr = balances.begin();
   while (bitr != balances.end()) {
     uint64_t my_received = bitr->received.amount;
@@ -64,16 +66,22 @@ ACTION gratitude::newround() {
     float split_factor = my_received / (float)volume;
     uint64_t payout = contract_balance.amount * split_factor;
     // Pay out SEEDS in store
-    if (payout > 0) _transfer(bitr->account, asset(payout, seeds_symbol), "gratitude bonus");
+    if (payout > 0) payouts.push_back(std::make_pair(bitr->account, asset(payout, seeds_symbol)));
     bitr++;
   }
+
+  // one token action for the whole round
+  if (payouts.size() > 0) {
+    token::transfermany_action action{contracts::token, {contracts::gratitude, "active"_n}};
+    action.send(contracts::gratitude, payouts, string("gratitude bonus"));
+  }
 }
 
 /// ----------================ PRIVATE ================----------
 
 void gratitude::check_user (name account) {
-  auto uitr = users.find(account.value);
-  check(uitr != users.end(), "gratitude: user not found");
+  user_core_table user;
+  check(user_core::find(account, user), "gratitude: user not found");
 }
 
 uint64_t gratitude::get_current_volume() {
@@ -185,10 +193,3 @@ uint64_t gratitude::config_get(name key) {
   }
   return citr->value;
 }
-
-// Transfers out stored SEEDS
-void gratitude::_transfer (name beneficiary, asset quantity, string memo) {
-  utils::check_asset(quantity);
-  token::transfer_action action{contracts::token, {contracts::gratitude, "active"_n}};
-  action.send(contracts::gratitude, beneficiary, quantity, memo);
-}
\ No newline at end of file
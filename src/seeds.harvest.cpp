@@ -17,6 +17,12 @@ void harvest::reset() {
   while (ritr != refunds.end()) {
     ritr = refunds.erase(ritr);
   }
+
+  refund_schedule_tables schedules(get_self(), user.value);
+  auto schitr = schedules.begin();
+  while (schitr != schedules.end()) {
+    schitr = schedules.erase(schitr);
+  }
   
   auto titr = txpoints.begin();
   while (titr != txpoints.end()) {
@@ -41,6 +47,21 @@ void harvest::reset() {
     pitr = planted.erase(pitr);
   }
 
+  for (auto tree : { planted_tree, tx_points_tree, org_tx_points_tree }) {
+    rank_tree_tables ranktree(get_self(), tree.value);
+    rank_tree::clear(ranktree);
+    rank_tree::built(ranktree, _self);
+  }
+
+  for (auto scope : { get_self(), organization_scope }) {
+    rank_cursor_tables cursors(get_self(), scope.value);
+    auto citr = cursors.begin();
+    while (citr != cursors.end()) {
+      ranking::clear_shadows(get_self(), citr->job, scope);
+      citr = cursors.erase(citr);
+    }
+  }
+
   auto qitr = monthlyqevs.begin();
   while (qitr != monthlyqevs.end()) {
     qitr = monthlyqevs.erase(qitr);
@@ -68,8 +89,21 @@ void harvest::reset() {
     bcsitr = regioncstemp.erase(bcsitr);
   }
 
+  auto clitr = claimable.begin();
+  while (clitr != claimable.end()) {
+    clitr = claimable.erase(clitr);
+  }
+
+  auto scitr = scores.begin();
+  while (scitr != scores.end()) {
+    scitr = scores.erase(scitr);
+  }
+
   total.remove();
 
+  instrument::clear(get_self());
+  jobs::clear(get_self());
+
   init_balance(_self);
 }
 
@@ -108,18 +142,26 @@ void harvest::add_planted(name account, asset quantity) {
   balances.modify(bitr, _self, [&](auto& user) {
     user.planted += quantity;
   });
+  transfer_profile::send(transfer_profile::planted, account, bitr->planted.amount);
+  rank_tree_tables ranktree(get_self(), planted_tree.value);
+
   auto pitr = planted.find(account.value);
   if (pitr == planted.end()) {
+    uint64_t rank = rank_tree::update(ranktree, account.value, false, 0, quantity.amount, 0, _self);
     planted.emplace(_self, [&](auto& item) {
       item.account = account;
       item.planted = quantity;
-      item.rank = 0;
+      item.rank = rank;
     });
     size_change(planted_size, 1);
+    set_score_rank(score_vector::planted, account, rank);
   } else {
+    uint64_t rank = rank_tree::update(ranktree, account.value, true, pitr->planted.amount, (pitr->planted + quantity).amount, pitr->rank, _self);
     planted.modify(pitr, _self, [&](auto& item) {
       item.planted += quantity;
+      item.rank = rank;
     });
+    set_score_rank(score_vector::planted, account, rank);
   }
   
   change_total(true, quantity);
@@ -132,16 +174,24 @@ void harvest::sub_planted(name account, asset quantity) {
   balances.modify(fromitr, _self, [&](auto& user) {
     user.planted -= quantity;
   });
+  transfer_profile::send(transfer_profile::planted, account, fromitr->planted.amount);
+
+  rank_tree_tables ranktree(get_self(), planted_tree.value);
 
   auto pitr = planted.find(account.value);
   check(pitr != planted.end(), "user has no balance");
   if (pitr->planted.amount == quantity.amount) {
+    rank_tree::erase(ranktree, account.value, pitr->planted.amount, _self);
     planted.erase(pitr);
     size_change(planted_size, -1);
+    set_score_rank(score_vector::planted, account, 0);
   } else {
+    uint64_t rank = rank_tree::update(ranktree, account.value, true, pitr->planted.amount, (pitr->planted - quantity).amount, pitr->rank, _self);
     planted.modify(pitr, _self, [&](auto& item) {
       item.planted -= quantity;
+      item.rank = rank;
     });
+    set_score_rank(score_vector::planted, account, rank);
   }
   
   change_total(false, quantity);
@@ -162,7 +212,59 @@ void harvest::sow(name from, name to, asset quantity) {
 }
 
 
+uint32_t harvest::refund_weeks_passed(const refund_schedule_table & schedule) {
+  uint64_t now = eosio::current_time_point().sec_since_epoch();
+  if (now <= schedule.request_time) {
+    return 0;
+  }
+  // week n is due once strictly more than n weeks have passed
+  uint64_t passed = (now - schedule.request_time - 1) / ONE_WEEK;
+  return uint32_t(std::min(passed, uint64_t(schedule.weeks)));
+}
+
+int64_t harvest::refund_vested(const refund_schedule_table & schedule, uint32_t weeks_passed) {
+  if (schedule.weeks == 0) {
+    return schedule.total.amount;
+  }
+  int64_t fraction = schedule.total.amount / schedule.weeks;
+  int64_t remainder = schedule.total.amount % schedule.weeks;
+  return fraction * weeks_passed + (weeks_passed == schedule.weeks ? remainder : 0);
+}
+
 void harvest::claimrefund(name from, uint64_t request_id) {
+  refund_schedule_tables schedules(get_self(), from.value);
+
+  auto sitr = schedules.find(request_id);
+  if (sitr == schedules.end()) {
+    claim_legacy_refund(from, request_id);
+    return;
+  }
+
+  name beneficiary = sitr->account;
+  int64_t vested = refund_vested(*sitr, refund_weeks_passed(*sitr));
+  asset total = asset(vested - sitr->claimed.amount, sitr->total.symbol);
+
+  if (vested == sitr->total.amount) {
+    schedules.erase(sitr);
+  } else if (total.amount > 0) {
+    schedules.modify(sitr, _self, [&](auto & schedule) {
+      schedule.claimed.amount = vested;
+    });
+  }
+
+  if (total.amount > 0) {
+    _withdraw(beneficiary, total);
+  }
+  action(
+      permission_level(contracts::history, "active"_n),
+      contracts::history,
+      "historyentry"_n,
+      std::make_tuple(from, string("trackrefund"), total.amount, string(""))
+   ).send();
+}
+
+// refunds requested before the schedules, one row per week
+void harvest::claim_legacy_refund(name from, uint64_t request_id) {
   refund_tables refunds(get_self(), from.value);
 
   auto ritr = refunds.begin();
@@ -199,6 +301,41 @@ void harvest::claimrefund(name from, uint64_t request_id) {
 void harvest::cancelrefund(name from, uint64_t request_id) {
   require_auth(from);
 
+  refund_schedule_tables schedules(get_self(), from.value);
+
+  auto sitr = schedules.find(request_id);
+  if (sitr == schedules.end()) {
+    cancel_legacy_refund(from, request_id);
+    return;
+  }
+
+  uint32_t weeks_passed = refund_weeks_passed(*sitr);
+  int64_t vested = refund_vested(*sitr, weeks_passed);
+  uint64_t totalReplanted = sitr->total.amount - vested;
+
+  if (totalReplanted > 0) {
+    add_planted(from, asset(totalReplanted, sitr->total.symbol));
+  }
+
+  if (vested == sitr->claimed.amount) {
+    schedules.erase(sitr);
+  } else {
+    // what is already due stays claimable
+    schedules.modify(sitr, _self, [&](auto & schedule) {
+      schedule.total.amount = vested;
+      schedule.weeks = weeks_passed;
+    });
+  }
+
+  action(
+      permission_level(contracts::history, "active"_n),
+      contracts::history,
+      "historyentry"_n,
+      std::make_tuple(from, string("trackcancel"), totalReplanted, string(""))
+   ).send();
+}
+
+void harvest::cancel_legacy_refund(name from, uint64_t request_id) {
   refund_tables refunds(get_self(), from.value);
 
   auto ritr = refunds.begin();
@@ -241,51 +378,47 @@ void harvest::unplant(name from, asset quantity) {
   check(bitr->planted.amount >= quantity.amount, "can't unplant more than planted!");
 
   uint64_t lastRequestId = 0;
-  uint64_t lastRefundId = 0;
 
+  // request ids continue after the ones of the per week refund rows
   refund_tables refunds(get_self(), from.value);
   if (refunds.begin() != refunds.end()) {
     auto ritr = refunds.end();
     ritr--;
     lastRequestId = ritr->request_id;
-    lastRefundId = ritr->refund_id;
   }
 
-  uint64_t fraction = quantity.amount / 12;
-  uint64_t remainder = quantity.amount % 12;
-
-  for (uint64_t week = 1; week <= 12; week++) {
-
-    uint64_t amt = fraction;
-
-    if (week == 12) {
-      amt = amt + remainder;
-    }
-
-    refunds.emplace(_self, [&](auto& refund) {
-      refund.request_id = lastRequestId + 1;
-      refund.refund_id = lastRefundId + week;
-      refund.account = from;
-      refund.amount = asset( amt, quantity.symbol );
-      refund.weeks_delay = week;
-      refund.request_time = eosio::current_time_point().sec_since_epoch();
-    });
+  refund_schedule_tables schedules(get_self(), from.value);
+  if (schedules.begin() != schedules.end()) {
+    auto sitr = schedules.end();
+    sitr--;
+    lastRequestId = std::max(lastRequestId, sitr->request_id);
   }
 
+  schedules.emplace(_self, [&](auto & schedule) {
+    schedule.request_id = lastRequestId + 1;
+    schedule.account = from;
+    schedule.total = quantity;
+    schedule.claimed = asset(0, quantity.symbol);
+    schedule.weeks = 12;
+    schedule.request_time = eosio::current_time_point().sec_since_epoch();
+  });
+
   sub_planted(from, quantity);
 
 }
 
 ACTION harvest::updatetxpt(name account) {
   require_auth(get_self());
-  auto uitr = users.get(account.value, "user not found");
-  calc_transaction_points(account, uitr.type);
+  user_core_table user;
+  check(user_core::find(account, user), "user not found");
+  calc_transaction_points(account, user.type);
 }
 
 ACTION harvest::updatecs(name account) {
   require_auth(account);
-  auto uitr = users.get(account.value, "user not found");
-  calc_contribution_score(account, uitr.type);
+  user_core_table user;
+  check(user_core::find(account, user), "user not found");
+  calc_contribution_score(account, user.type);
 }
 
 ACTION harvest::updtotal() { // remove when balances are retired
@@ -379,43 +512,66 @@ ACTION harvest::calctotal(uint64_t startval) {
 // Returns count of iterations
 uint32_t harvest::calc_transaction_points(name account, name type) {
   uint64_t now = eosio::current_time_point().sec_since_epoch();
-  uint64_t cutoffdate = now - (utils::moon_cycle * config_float_get("cyctrx.trail"_n));
+  uint64_t cutoffdate = now - (utils::moon_cycle * conf.get(config_snapshot::cyctrx_trail));
 
   transaction_points_tables transactions(contracts::history, account.value);
+  tx_window_tables txwindows(contracts::history, contracts::history.value);
 
   uint64_t count = 0;
   uint64_t total_points = 0;
 
-  auto titr = transactions.rbegin();
-  while (titr != transactions.rend() && titr -> timestamp >= cutoffdate) {
+  auto witr = txwindows.find(account.value);
+  if (witr != txwindows.end()) {
+    total_points = witr -> points;
+
+    // days that left the window since history last expired them
+    auto titr = transactions.lower_bound(witr -> start);
+    while (titr != transactions.end() && titr -> timestamp < cutoffdate) {
+      total_points -= titr -> points;
+      titr++;
+      count++;
+    }
+  } else {
+    auto titr = transactions.rbegin();
+    while (titr != transactions.rend() && titr -> timestamp >= cutoffdate) {
 
-    total_points += titr -> points;
+      total_points += titr -> points;
 
-    titr++;
-    count++;
+      titr++;
+      count++;
+    }
   }
 
   if (type == name("organisation")) {
     setorgtxpt(account, total_points);
   } else {
+    rank_tree_tables ranktree(get_self(), tx_points_tree.value);
     auto tx_points_itr = txpoints.find(account.value);
 
     if (tx_points_itr == txpoints.end()) {
       if (total_points > 0) {
+        uint64_t rank = rank_tree::update(ranktree, account.value, false, 0, total_points, 0, _self);
         txpoints.emplace(_self, [&](auto& entry) {
           entry.account = account;
           entry.points = total_points;
+          entry.rank = rank;
         });
         size_change(tx_points_size, 1);
+        set_score_rank(score_vector::tx, account, rank);
       }
     } else {
       if (total_points > 0) {
+        uint64_t rank = rank_tree::update(ranktree, account.value, true, tx_points_itr->points, total_points, tx_points_itr->rank, _self);
         txpoints.modify(tx_points_itr, _self, [&](auto& entry) {
           entry.points = total_points; 
+          entry.rank = rank;
         });
+        set_score_rank(score_vector::tx, account, rank);
       } else {
+        rank_tree::erase(ranktree, account.value, tx_points_itr->points, _self);
         txpoints.erase(tx_points_itr);
         size_change(tx_points_size, -1);
+        set_score_rank(score_vector::tx, account, 0);
       }
     }
   }
@@ -424,6 +580,7 @@ uint32_t harvest::calc_transaction_points(name account, name type) {
 }
 
 void harvest::calctrxpts() {
+    jobs::start(get_self(), "calctrxpts"_n);
     calctrxpt(0, 0, 400);
 }
 
@@ -442,8 +599,10 @@ void harvest::calctrxpt(uint64_t start_val, uint64_t chunk, uint64_t chunksize)
     uitr++;
   }
 
+  jobs::chunk(get_self(), "calctrxpts"_n, count);
+
   if (uitr == users.end()) {
-    // done
+    jobs::finish(get_self(), "calctrxpts"_n);
   } else {
     uint64_t next_value = uitr->account.value;
     action next_execution(
@@ -461,131 +620,109 @@ void harvest::calctrxpt(uint64_t start_val, uint64_t chunk, uint64_t chunksize)
 }
 
 void harvest::rankorgtxs() {
-  ranktx(0, 0, 200, "org"_n);
+  rank_cursor_tables cursors(get_self(), "org"_n.value);
+  ranking::start(cursors, "ranktx"_n, get_size(org_tx_points_size), _self);
+  jobs::start(get_self(), "rankorgtxs"_n);
+  ranktx(config_get("rank.budget"_n), "org"_n);
 }
 
 void harvest::ranktxs() {
-  ranktx(0, 0, 200, contracts::harvest);
+  rank_cursor_tables cursors(get_self(), contracts::harvest.value);
+  ranking::start(cursors, "ranktx"_n, get_size(tx_points_size), _self);
+  jobs::start(get_self(), "ranktxs"_n);
+  ranktx(config_get("rank.budget"_n), contracts::harvest);
 }
 
-void harvest::ranktx(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name table) {
+void harvest::ranktx(uint64_t budget, name table) {
   require_auth(_self);
+  instrument::begin("ranktx"_n);
 
-  auto s = table == "org"_n ? org_tx_points_size : tx_points_size;
-  uint64_t total = get_size(s);
-  if (total == 0) return;
+  rank_cursor_tables cursors(get_self(), table.value);
+  if (!ranking::running(cursors, "ranktx"_n)) {
+    auto s = table == "org"_n ? org_tx_points_size : tx_points_size;
+    ranking::start(cursors, "ranktx"_n, get_size(s), _self);
+  }
 
   tx_points_tables txpoints_table(get_self(), table.value);
-
-  uint64_t current = chunk * chunksize;
   auto txpt_by_points = txpoints_table.get_index<"bypoints"_n>();
-  auto titr = start_val == 0 ? txpt_by_points.begin() : txpt_by_points.lower_bound(start_val);
-  uint64_t count = 0;
-
-  while (titr != txpt_by_points.end() && count < chunksize) {
 
-    uint64_t rank = utils::rank(current, total);
-
-    txpt_by_points.modify(titr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
-
-    current++;
-    count++;
-    titr++;
-  }
+  name job = table == "org"_n ? "rankorgtxs"_n : "ranktxs"_n;
+  uint64_t ranked = ranking::position(cursors, "ranktx"_n);
+  bool done = ranking::step(cursors, "ranktx"_n, txpt_by_points, budget, _self, [&](uint64_t account, uint64_t rank) {
+    set_score_rank(score_vector::tx, name(account), rank);
+  });
+  jobs::chunk(get_self(), job, ranking::position(cursors, "ranktx"_n) - ranked);
 
-  if (titr == txpt_by_points.end()) {
-    // Done.
+  if (done) {
+    jobs::finish(get_self(), job);
   } else {
-    // recursive call
-    uint64_t next_value = titr->by_points();
-    action next_execution(
-        permission_level{get_self(), "active"_n},
-        get_self(),
-        "ranktx"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize, table)
-    );
-
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(next_value, _self);
-    
+    ranking::schedule(get_self(), "ranktx"_n, ranking::sender_id("ranktx"_n, table), budget, table);
   }
 
+  instrument::end(get_self());
 }
 
 void harvest::rankplanteds() {
-  rankplanted(0, 0, 200);
+  rank_cursor_tables cursors(get_self(), get_self().value);
+  ranking::start(cursors, "rankplanted"_n, get_size(planted_size), _self);
+  jobs::start(get_self(), "rankplanteds"_n);
+  rankplanted(config_get("rank.budget"_n));
 }
 
-void harvest::rankplanted(uint128_t start_val, uint64_t chunk, uint64_t chunksize) {
+void harvest::rankplanted(uint64_t budget) {
   require_auth(_self);
+  instrument::begin("rankplanted"_n);
 
-  uint64_t total = get_size(planted_size);
-  if (total == 0) return;
+  rank_cursor_tables cursors(get_self(), get_self().value);
+  if (!ranking::running(cursors, "rankplanted"_n)) {
+    ranking::start(cursors, "rankplanted"_n, get_size(planted_size), _self);
+  }
 
-  uint64_t current = chunk * chunksize;
   auto planted_by_planted = planted.get_index<"byplanted"_n>();
-  auto pitr = start_val == 0 ? planted_by_planted.begin() : planted_by_planted.lower_bound(start_val);
-  uint64_t count = 0;
-
-  while (pitr != planted_by_planted.end() && count < chunksize) {
 
-    uint64_t rank = utils::rank(current, total);
-
-    planted_by_planted.modify(pitr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
-
-    current++;
-    count++;
-    pitr++;
-  }
+  uint64_t ranked = ranking::position(cursors, "rankplanted"_n);
+  bool done = ranking::step(cursors, "rankplanted"_n, planted_by_planted, budget, _self, [&](uint64_t account, uint64_t rank) {
+    set_score_rank(score_vector::planted, name(account), rank);
+  });
+  jobs::chunk(get_self(), "rankplanteds"_n, ranking::position(cursors, "rankplanted"_n) - ranked);
 
-  if (pitr == planted_by_planted.end()) {
-    // Done.
+  if (done) {
+    jobs::finish(get_self(), "rankplanteds"_n);
   } else {
-    // recursive call
-    uint128_t next_value = pitr->by_planted();
-    action next_execution(
-        permission_level{get_self(), "active"_n},
-        get_self(),
-        "rankplanted"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize)
-    );
-
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(pitr->account.value, _self);
-    
+    ranking::schedule(get_self(), "rankplanted"_n, ranking::sender_id("rankplanted"_n, get_self()), budget);
   }
 
+  instrument::end(get_self());
 }
 
 void harvest::calccss() {
+  jobs::start(get_self(), "calccss"_n);
   calccs(0, 0, 200);
 }
 
 void harvest::calccs(uint64_t start_val, uint64_t chunk, uint64_t chunksize) {
   require_auth(_self);
+  instrument::begin("calccs"_n);
 
   check(chunksize > 0, "chunk size must be > 0");
 
   uint64_t total = utils::get_users_size();
+  instrument::read();
   auto uitr = start_val == 0 ? users.begin() : users.lower_bound(start_val);
+  instrument::read();
   uint64_t count = 0;
 
   while (uitr != users.end() && count < chunksize) {
     calc_contribution_score(uitr->account, uitr->type);
     count++;
     uitr++;
+    instrument::read();
   }
 
+  jobs::chunk(get_self(), "calccss"_n, count);
+
   if (uitr == users.end()) {
-    // done
+    jobs::finish(get_self(), "calccss"_n);
   } else {
     uint64_t next_value = uitr->account.value;
     action next_execution(
@@ -599,7 +736,19 @@ void harvest::calccs(uint64_t start_val, uint64_t chunk, uint64_t chunksize) {
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
     tx.send(next_value, _self);
+    instrument::sent_deferred();
   }
+
+  instrument::end(get_self());
+}
+
+uint64_t harvest::published_rank(name contract, name job, name scope, uint64_t pk, uint64_t live_rank) {
+  auto key = std::make_tuple(contract.value, job.value, scope.value);
+  auto vitr = rank_views.find(key);
+  if (vitr == rank_views.end()) {
+    vitr = rank_views.try_emplace(key, contract, job, scope).first;
+  }
+  return vitr->second.rank(pk, live_rank);
 }
 
 // [PS+RT+CB X Rep = Total Contribution Score]
@@ -608,42 +757,38 @@ void harvest::calc_contribution_score(name account, name type) {
   uint64_t transactions_score = 0;
   uint64_t community_building_score = 0;
   uint64_t reputation_score = 0;
-
-  auto pitr = planted.find(account.value);
-  if (pitr != planted.end()) planted_score = pitr->rank;
+  name region;
 
   // CS scrore for org needs to be calculated differently
   // Page 71 constitution
 
   name scope;
+  name tx_scope;
   name cs_scope;
   name cs_sz;
 
   if (type == "organisation"_n) {
     scope = organization_scope;
+    tx_scope = "org"_n;
     cs_scope = scope;
     cs_sz = cs_org_size;
-    
-    tx_points_tables orgtxpoints(get_self(), "org"_n.value);
-    auto titr = orgtxpoints.find(account.value);
-    if (titr != orgtxpoints.end()) transactions_score = titr->rank;
-
   } else {
     scope = individual_scope_accounts;
+    tx_scope = get_self();
     cs_scope = individual_scope_harvest;
     cs_sz = cs_size;
-
-    auto titr = txpoints.find(account.value);
-    if (titr != txpoints.end()) transactions_score = titr->rank;
   }
 
-  rep_tables rep_t(contracts::accounts, scope.value);
-  auto ritr = rep_t.find(account.value);
-  if (ritr != rep_t.end()) reputation_score = ritr->rank;
-
-  cbs_tables cbs_t(contracts::accounts, scope.value);
-  auto citr = cbs_t.find(account.value);
-  if (citr != cbs_t.end()) community_building_score = citr->rank;
+  // all the ranks are copied to the score vector, one read instead of a lookup in each ranked table
+  auto sitr = scores.find(account.value);
+  instrument::read();
+  if (sitr != scores.end()) {
+    planted_score = published_rank(get_self(), "rankplanted"_n, get_self(), account.value, sitr->planted_rank);
+    transactions_score = published_rank(get_self(), "ranktx"_n, tx_scope, account.value, sitr->tx_rank);
+    reputation_score = published_rank(contracts::accounts, "rankrep"_n, scope, account.value, sitr->rep_rank);
+    community_building_score = published_rank(contracts::accounts, "rankcbs"_n, scope, account.value, sitr->cbs_rank);
+    region = sitr->region;
+  }
 
   // TODO verify this as correct for the constitution pp 71
   // Orgs need to have different scope for rep
@@ -657,12 +802,21 @@ void harvest::calc_contribution_score(name account, name type) {
   cs_points_tables cspoints_t(get_self(), cs_scope.value);
 
   auto csitr = cspoints_t.find(account.value);
+  instrument::read();
+
+  // region totals only change by the difference to what this account added before
+  if (type != "organisation"_n) {
+    uint64_t previous_points = csitr != cspoints_t.end() ? csitr->contribution_points : 0;
+    change_region_cs(region, int64_t(contribution_points) - int64_t(previous_points));
+  }
+
   if (csitr == cspoints_t.end()) {
     if (contribution_points > 0) {
       cspoints_t.emplace(_self, [&](auto& item) {
         item.account = account;
         item.contribution_points = contribution_points;
       });
+      instrument::emplaced();
       size_change(cs_sz, 1);
     }
   } else {
@@ -670,113 +824,183 @@ void harvest::calc_contribution_score(name account, name type) {
       cspoints_t.modify(csitr, _self, [&](auto& item) {
         item.contribution_points = contribution_points;
       });
+      instrument::modified();
     } else {
       cspoints_t.erase(csitr);
+      instrument::erased();
       size_change(cs_sz, -1);
     }
   }
 
-  if (type != "organisation"_n) {
-    add_cs_to_region(account, uint32_t(contribution_points));
-  }
 }
 
-void harvest::add_cs_to_region(name account, uint32_t points) {
-  auto bitr = members.find(account.value);
-  if (bitr == members.end()) { return; }
+void harvest::change_region_cs(name region, int64_t delta) {
+  if (region == name() || delta == 0) { return; }
 
-  auto csitr = regioncstemp.find(bitr -> region.value);
+  auto csitr = regioncstemp.find(region.value);
+  instrument::read();
   if (csitr == regioncstemp.end()) {
-    if (points > 0) {
+    if (delta > 0) {
       regioncstemp.emplace(_self, [&](auto & item){
-        item.region = bitr -> region;
-        item.points = points;
+        item.region = region;
+        item.points = uint32_t(delta);
       });
+      instrument::emplaced();
       size_change(cs_rgn_size, 1);
     }
   } else {
+    int64_t points = int64_t(csitr->points) + delta;
     if (points > 0) {
       regioncstemp.modify(csitr, _self, [&](auto & item){
-        item.points += points;
+        item.points = uint32_t(points);
       });
+      instrument::modified();
     } else {
       regioncstemp.erase(csitr);
+      instrument::erased();
+      size_change(cs_rgn_size, -1);
+    }
+  }
+}
+
+void harvest::set_score_rank(name field, name account, uint64_t rank) {
+  auto set = [&](auto & item) {
+    if (field == score_vector::planted) {
+      item.planted_rank = uint8_t(rank);
+    } else if (field == score_vector::tx) {
+      item.tx_rank = uint8_t(rank);
+    } else if (field == score_vector::rep) {
+      item.rep_rank = uint8_t(rank);
+    } else if (field == score_vector::cbs) {
+      item.cbs_rank = uint8_t(rank);
+    }
+  };
+
+  auto sitr = scores.find(account.value);
+  instrument::read();
+  if (sitr == scores.end()) {
+    if (rank > 0) {
+      scores.emplace(_self, [&](auto & item) {
+        item.account = account;
+        item.planted_rank = 0;
+        item.tx_rank = 0;
+        item.rep_rank = 0;
+        item.cbs_rank = 0;
+        item.region = name();
+        set(item);
+      });
+      instrument::emplaced();
+    }
+  } else {
+    scores.modify(sitr, _self, set);
+    instrument::modified();
+  }
+}
+
+void harvest::set_score_region(name account, name region) {
+  auto sitr = scores.find(account.value);
+  name previous = sitr != scores.end() ? sitr->region : name();
+  if (previous == region) { return; }
+
+  // the member's contribution points move with them
+  auto csitr = cspoints.find(account.value);
+  if (csitr != cspoints.end()) {
+    change_region_cs(previous, -int64_t(csitr->contribution_points));
+    change_region_cs(region, int64_t(csitr->contribution_points));
+  }
+
+  if (sitr == scores.end()) {
+    if (region != name()) {
+      scores.emplace(_self, [&](auto & item) {
+        item.account = account;
+        item.planted_rank = 0;
+        item.tx_rank = 0;
+        item.rep_rank = 0;
+        item.cbs_rank = 0;
+        item.region = region;
+      });
     }
+  } else {
+    scores.modify(sitr, _self, [&](auto & item) {
+      item.region = region;
+    });
+  }
+}
+
+ACTION harvest::setranks(name field, std::vector<score_vector::rank_update> updates) {
+  require_auth(get_self());
+
+  check(field == score_vector::planted || field == score_vector::tx || field == score_vector::rep || field == score_vector::cbs,
+    "invalid score field " + field.to_string());
+
+  for (auto & update : updates) {
+    set_score_rank(field, update.account, update.rank);
   }
 }
 
+ACTION harvest::setregion(name account, name region) {
+  require_auth(get_self());
+  set_score_region(account, region);
+}
+
 void harvest::rankcss() {
-  size_set(sum_rank_users, 0);
-  rankcs(0, 0, 200, individual_scope_harvest);
+  rank_cursor_tables cursors(get_self(), individual_scope_harvest.value);
+  ranking::start(cursors, "rankcs"_n, get_size(cs_size), _self);
+  jobs::start(get_self(), "rankcss"_n);
+  rankcs(config_get("rank.budget"_n), individual_scope_harvest);
 }
 
 void harvest::rankorgcss() {
-  size_set(sum_rank_orgs, 0);
-  rankcs(0, 0, 200, organization_scope);
+  rank_cursor_tables cursors(get_self(), organization_scope.value);
+  ranking::start(cursors, "rankcs"_n, get_size(cs_org_size), _self);
+  jobs::start(get_self(), "rankorgcss"_n);
+  rankcs(config_get("rank.budget"_n), organization_scope);
 }
 
-void harvest::rankcs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name cs_scope) {
+void harvest::rankcs(uint64_t budget, name cs_scope) {
   require_auth(_self);
+  instrument::begin("rankcs"_n);
 
-  uint64_t total = 0;
+  name cs_sz;
   name sum_rank_name;
   if (cs_scope == individual_scope_harvest) {
-    total = get_size(cs_size);
+    cs_sz = cs_size;
     sum_rank_name = sum_rank_users;
   } else if (cs_scope == organization_scope) {
-    total = get_size(cs_org_size);
+    cs_sz = cs_org_size;
     sum_rank_name = sum_rank_orgs;
+  } else {
+    check(false, "invalid cs scope");
   }
-  if (total == 0) return;
 
-  cs_points_tables cspoints_t(get_self(), cs_scope.value);
+  rank_cursor_tables cursors(get_self(), cs_scope.value);
+  if (!ranking::running(cursors, "rankcs"_n)) {
+    ranking::start(cursors, "rankcs"_n, get_size(cs_sz), _self);
+  }
 
-  uint64_t current = chunk * chunksize;
+  cs_points_tables cspoints_t(get_self(), cs_scope.value);
   auto cs_by_points = cspoints_t.get_index<"bycspoints"_n>();
-  auto citr = start_val == 0 ? cs_by_points.begin() : cs_by_points.lower_bound(start_val);
-  uint64_t count = 0;
-  uint64_t sum_rank = 0;
 
-  while (citr != cs_by_points.end() && count < chunksize) {
-
-    uint64_t rank = utils::rank(current, total);
+  name job = cs_scope == individual_scope_harvest ? "rankcss"_n : "rankorgcss"_n;
+  uint64_t ranked = ranking::position(cursors, "rankcs"_n);
+  bool done = ranking::step(cursors, "rankcs"_n, cs_by_points, budget, _self);
+  jobs::chunk(get_self(), job, ranking::position(cursors, "rankcs"_n) - ranked);
 
-    cs_by_points.modify(citr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
-
-    sum_rank += rank;
-
-    current++;
-    count++;
-    citr++;
-  }
-
-  size_change(sum_rank_name, int64_t(sum_rank));
-
-  if (citr == cs_by_points.end()) {
-    // Done.
+  if (done) {
+    // the sum is only published once the whole pass is ranked, so the harvest
+    // distribution never divides by a partial sum
+    size_set(sum_rank_name, cursors.get("rankcs"_n.value).sum_rank);
+    jobs::finish(get_self(), job);
   } else {
-    // recursive call
-    uint64_t next_value = citr->by_cs_points();
-    action next_execution(
-        permission_level{get_self(), "active"_n},
-        get_self(),
-        "rankcs"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize, cs_scope)
-    );
-
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(next_value, _self);
-    
+    ranking::schedule(get_self(), "rankcs"_n, ranking::sender_id("rankcs"_n, cs_scope), budget, cs_scope);
   }
 
+  instrument::end(get_self());
 }
 
 
 void harvest::rankrgncss() {
+  jobs::start(get_self(), "rankrgncss"_n);
   uint64_t batch_size = config_get("batchsize"_n);
   size_set(sum_rank_rgns, 0);
   rankrgncs(uint64_t(0), uint64_t(0), batch_size);
@@ -786,12 +1010,15 @@ void harvest::rankrgncs(uint64_t start, uint64_t chunk, uint64_t chunksize) {
   require_auth(get_self());
 
   uint64_t total = get_size(cs_rgn_size);
-  if (total == 0) return;
+  if (total == 0) {
+    jobs::finish(get_self(), "rankrgncss"_n);
+    return;
+  }
 
   cs_points_tables rgncspoints(get_self(), name("rgn").value);
 
   auto rgns_by_points = regioncstemp.get_index<"bycspoints"_n>();
-  auto bitr = start == 0 ? rgns_by_points.begin() : rgns_by_points.find(start);
+  auto bitr = start == 0 ? rgns_by_points.begin() : rgns_by_points.lower_bound(start);
   
   uint64_t current = chunk * chunksize;
   uint64_t count = 0;
@@ -817,12 +1044,13 @@ void harvest::rankrgncs(uint64_t start, uint64_t chunk, uint64_t chunksize) {
 
     sum_rank_b += rank;
 
-    bitr = rgns_by_points.erase(bitr);
+    bitr++;
     count++;
     current++;
   }
 
   size_change(sum_rank_rgns, int64_t(sum_rank_b));
+  jobs::chunk(get_self(), "rankrgncss"_n, count);
 
   if (bitr != rgns_by_points.end()) {
     uint64_t next_value = bitr -> by_cs_points();
@@ -838,7 +1066,7 @@ void harvest::rankrgncs(uint64_t start, uint64_t chunk, uint64_t chunksize) {
     tx.delay_sec = 1;
     tx.send(next_value, _self);
   } else {
-    size_set(cs_rgn_size, 0);
+    jobs::finish(get_self(), "rankrgncss"_n);
   }
 
 }
@@ -848,8 +1076,8 @@ void harvest::payforcpu(name account) {
     require_auth(get_self()); // satisfied by payforcpu permission
     require_auth(account);
 
-    auto uitr = users.find(account.value);
-    check(uitr != users.end(), "Not a Seeds user!");
+    user_core_table user;
+    check(user_core::find(account, user), "Not a Seeds user!");
 }
 
 void harvest::init_balance(name account)
@@ -869,8 +1097,8 @@ void harvest::check_user(name account)
   if (account == contracts::onboarding) {
     return;
   }
-  auto uitr = users.find(account.value);
-  check(uitr != users.end(), "harvest: no user");
+  user_core_table user;
+  check(user_core::find(account, user), "harvest: no user");
 }
 
 void harvest::check_asset(asset quantity)
@@ -900,6 +1128,16 @@ void harvest::_withdraw(name beneficiary, asset quantity)
 
 void harvest::testclaim(name from, uint64_t request_id, uint64_t sec_rewind) {
   require_auth(get_self());
+
+  refund_schedule_tables schedules(get_self(), from.value);
+  auto sitr = schedules.find(request_id);
+  if (sitr != schedules.end()) {
+    schedules.modify(sitr, _self, [&](auto & schedule) {
+      schedule.request_time = eosio::current_time_point().sec_since_epoch() - sec_rewind;
+    });
+    return;
+  }
+
   refund_tables refunds(get_self(), from.value);
 
   auto ritr = refunds.begin();
@@ -919,11 +1157,12 @@ void harvest::testclaim(name from, uint64_t request_id, uint64_t sec_rewind) {
 void harvest::testcspoints(name account, uint64_t contribution_points) {
   require_auth(get_self());
 
-  auto uitr = users.get(account.value, "account not found");
+  user_core_table user;
+  check(user_core::find(account, user), "account not found");
   name scope;
   name cs_sz;
 
-  if (uitr.type == "individual"_n) {
+  if (user.type == "individual"_n) {
     scope = individual_scope_harvest;
     cs_sz = cs_size;
   } else {
@@ -934,6 +1173,15 @@ void harvest::testcspoints(name account, uint64_t contribution_points) {
   cs_points_tables cspoints_t(get_self(), scope.value);
 
   auto csitr = cspoints_t.find(account.value);
+
+  if (user.type == "individual"_n) {
+    auto sitr = scores.find(account.value);
+    uint64_t previous_points = csitr != cspoints_t.end() ? csitr->contribution_points : 0;
+    if (sitr != scores.end()) {
+      change_region_cs(sitr->region, int64_t(contribution_points) - int64_t(previous_points));
+    }
+  }
+
   if (csitr == cspoints_t.end()) {
     if (contribution_points > 0) {
       cspoints_t.emplace(_self, [&](auto& item) {
@@ -957,11 +1205,12 @@ void harvest::testcspoints(name account, uint64_t contribution_points) {
 void harvest::testupdatecs(name account, uint64_t contribution_score) {
   require_auth(get_self());
 
-  auto uitr = users.get(account.value, "account not found");
+  user_core_table user;
+  check(user_core::find(account, user), "account not found");
   name scope;
   name cs_sz;
 
-  if (uitr.type == "individual"_n) {
+  if (user.type == "individual"_n) {
     scope = individual_scope_harvest;
     cs_sz = cs_size;
   } else {
@@ -999,11 +1248,13 @@ double harvest::get_rep_multiplier(name account) {
 
 void harvest::size_change(name id, int delta) {
   auto sitr = sizes.find(id.value);
+  instrument::read();
   if (sitr == sizes.end()) {
     sizes.emplace(_self, [&](auto& item) {
       item.id = id;
       item.size = delta;
     });
+    instrument::emplaced();
   } else {
     uint64_t newsize = sitr->size + delta; 
     if (delta < 0) {
@@ -1014,25 +1265,30 @@ void harvest::size_change(name id, int delta) {
     sizes.modify(sitr, _self, [&](auto& item) {
       item.size = newsize;
     });
+    instrument::modified();
   }
 }
 
 void harvest::size_set(name id, uint64_t newsize) {
   auto sitr = sizes.find(id.value);
+  instrument::read();
   if (sitr == sizes.end()) {
     sizes.emplace(_self, [&](auto& item) {
       item.id = id;
       item.size = newsize;
     });
+    instrument::emplaced();
   } else {
     sizes.modify(sitr, _self, [&](auto& item) {
       item.size = newsize;
     });
+    instrument::modified();
   }
 }
 
 uint64_t harvest::get_size(name id) {
   auto sitr = sizes.find(id.value);
+  instrument::read();
   if (sitr == sizes.end()) {
     return 0;
   } else {
@@ -1057,24 +1313,33 @@ ACTION harvest::setorgtxpt(name organization, uint64_t tx_points) {
   require_auth(get_self());
 
   tx_points_tables orgtxpoints(get_self(), "org"_n.value);
+  rank_tree_tables ranktree(get_self(), org_tx_points_tree.value);
   
   auto oitr = orgtxpoints.find(organization.value);
   if (oitr == orgtxpoints.end()) {
     if (tx_points > 0) {
+      uint64_t rank = rank_tree::update(ranktree, organization.value, false, 0, tx_points, 0, _self);
       orgtxpoints.emplace(_self, [&](auto& item) {
         item.account = organization;
         item.points = tx_points;
+        item.rank = rank;
       });
       size_change(org_tx_points_size, 1);
+      set_score_rank(score_vector::tx, organization, rank);
     }
   } else {
     if (tx_points > 0) {
+      uint64_t rank = rank_tree::update(ranktree, organization.value, true, oitr->points, tx_points, oitr->rank, _self);
       orgtxpoints.modify(oitr, _self, [&](auto& item) {
         item.points = tx_points;
+        item.rank = rank;
       });
+      set_score_rank(score_vector::tx, organization, rank);
     } else {
+      rank_tree::erase(ranktree, organization.value, oitr->points, _self);
       orgtxpoints.erase(oitr);
       size_change(org_tx_points_size, -1);
+      set_score_rank(score_vector::tx, organization, 0);
     }
   } 
 
@@ -1092,12 +1357,25 @@ void harvest::calcmqevs () {
     return;
   }
 
-  auto qitr = qevs.rbegin();
+  qev_window_tables qevwindow(contracts::history, contracts::history.value);
   uint64_t total_volume = 0;
 
-  while (qitr != qevs.rend() && qitr -> timestamp >= cutoff) {
-    total_volume += qitr -> qualifying_volume;
-    qitr++;
+  if (qevwindow.exists()) {
+    auto window = qevwindow.get();
+    total_volume = window.qualifying_volume;
+
+    // days that left the window since history last added volume
+    auto qitr = qevs.lower_bound(window.start);
+    while (qitr != qevs.end() && qitr -> timestamp < cutoff) {
+      total_volume -= qitr -> qualifying_volume;
+      qitr++;
+    }
+  } else {
+    auto qitr = qevs.rbegin();
+    while (qitr != qevs.rend() && qitr -> timestamp >= cutoff) {
+      total_volume += qitr -> qualifying_volume;
+      qitr++;
+    }
   }
 
   circulating_supply_table c = circulating.get();
@@ -1177,30 +1455,30 @@ void harvest::calcmintrate () {
 }
 
 uint64_t harvest::config_get(name key) {
-  auto citr = config.find(key.value);
-  if (citr == config.end()) { 
-    check(false, ("settings: the "+key.to_string()+" parameter has not been initialized").c_str());
-  }
-  return citr->value;
+  return conf.get(key);
 }
 
 double harvest::config_float_get(name key) {
-  auto citr = configfloat.find(key.value);
-  if (citr == configfloat.end()) { 
-    check(false, ("settings: the "+key.to_string()+" parameter has not been initialized").c_str());
-  }
-  return citr->value;
+  return conf.get_float(key);
+}
+
+// hrvst.payout came after launch, chains whose settings were not reset keep paying by transfer
+uint64_t harvest::payout_mode() {
+  return conf.get_or(config_snapshot::hrvst_payout, payout_transfer);
 }
 
 void harvest::send_distribute_harvest (name key, asset amount) {
 
   cancel_deferred(key.value);
 
+  // crediting balances is cheap, pay as many accounts per transaction as other batches do
+  uint64_t chunksize = payout_mode() == payout_transfer ? 10 : config_get("batchsize"_n);
+
   action next_execution(
     permission_level{get_self(), "active"_n},
     get_self(),
     key,
-    std::make_tuple(uint64_t(0), uint64_t(10), amount)
+    std::make_tuple(uint64_t(0), chunksize, amount)
   );
 
   transaction tx;
@@ -1215,6 +1493,90 @@ void harvest::withdraw_aux (name sender, name beneficiary, asset quantity, strin
   t_action.send(sender, beneficiary, quantity, memo);
 }
 
+void harvest::pay_harvest (name account, asset quantity, uint64_t payout) {
+  if (payout == payout_transfer) {
+    withdraw_aux(get_self(), account, quantity, "harvest");
+    return;
+  }
+
+  if (quantity.amount <= 0) { return; }
+
+  auto clitr = claimable.find(account.value);
+  if (clitr != claimable.end()) {
+    claimable.modify(clitr, _self, [&](auto & item){
+      item.amount += quantity;
+    });
+  } else {
+    claimable.emplace(_self, [&](auto & item){
+      item.account = account;
+      item.amount = quantity;
+    });
+  }
+}
+
+void harvest::claim (name account) {
+  require_auth(account);
+
+  auto clitr = claimable.find(account.value);
+  check(clitr != claimable.end(), "no harvest to claim for " + account.to_string());
+
+  asset quantity = clitr -> amount;
+  claimable.erase(clitr);
+
+  withdraw_aux(get_self(), account, quantity, "harvest");
+}
+
+void harvest::send_settle () {
+  action next_execution(
+    permission_level{get_self(), "active"_n},
+    get_self(),
+    "settle"_n,
+    std::make_tuple(uint64_t(0))
+  );
+
+  transaction tx;
+  tx.actions.emplace_back(next_execution);
+  tx.delay_sec = 1;
+  tx.send("settle"_n.value, _self, true);
+}
+
+// pays out claimable balances in bulk, one token action per batch
+void harvest::settle (uint64_t start) {
+  require_auth(get_self());
+
+  auto clitr = start == 0 ? claimable.begin() : claimable.lower_bound(start);
+
+  uint64_t batch_size = config_get("batchsize"_n);
+  uint64_t count = 0;
+
+  std::vector<std::pair<name, asset>> payouts;
+
+  while (clitr != claimable.end() && count < batch_size) {
+    payouts.push_back(std::make_pair(clitr -> account, clitr -> amount));
+    clitr = claimable.erase(clitr);
+    count++;
+  }
+
+  if (payouts.size() > 0) {
+    token::transfermany_action t_action{contracts::token, { get_self(), "active"_n }};
+    t_action.send(get_self(), payouts, string("harvest"));
+  }
+
+  if (clitr != claimable.end()) {
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "settle"_n,
+      std::make_tuple(clitr -> account.value)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send("settle"_n.value, _self, true);
+  }
+}
+
 void harvest::runharvest() {
   require_auth(get_self());
 
@@ -1263,14 +1625,16 @@ void harvest::disthvstusrs (uint64_t start, uint64_t chunksize, asset total_amou
   check(sum_rank > 0, "the sum rank for users must be greater than zero");
 
   double fragment_seeds = total_amount.amount / double(sum_rank);
+  uint64_t payout = payout_mode();
   
   while (csitr != cspoints.end() && count < chunksize) {
 
     // auto uitr = users.find(csitr -> account.value);
-    if (csitr->rank > 0) {
+    uint64_t rank = published_rank(get_self(), "rankcs"_n, individual_scope_harvest, csitr->account.value, csitr->rank);
+    if (rank > 0) {
 
-      print("user:", csitr->account, ", rank:", csitr -> rank, ", amount:", asset(csitr -> rank * fragment_seeds, test_symbol), "\n");
-      withdraw_aux(get_self(), csitr->account, asset(csitr->rank * fragment_seeds, test_symbol), "harvest");
+      print("user:", csitr->account, ", rank:", rank, ", amount:", asset(rank * fragment_seeds, test_symbol), "\n");
+      pay_harvest(csitr->account, asset(rank * fragment_seeds, test_symbol), payout);
     
     }
 
@@ -1290,6 +1654,8 @@ void harvest::disthvstusrs (uint64_t start, uint64_t chunksize, asset total_amou
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
     tx.send(sum_rank_users.value, _self);
+  } else if (payout == payout_settle) {
+    send_settle();
   }
 
 }
@@ -1304,12 +1670,13 @@ void harvest::disthvstrgns (uint64_t start, uint64_t chunksize, asset total_amou
 
   check(number_regions > 0, "number of regions must be greater than zero");
   double fragment_seeds = total_amount.amount / double(number_regions);
+  uint64_t payout = payout_mode();
 
   while (bitr != regions.end() && count < chunksize) {
 
     // for the moment, all regions have rank 1
     //print("rgn:", bitr -> id, ", rank:", 1, ", amount:", asset(fragment_seeds, test_symbol), "\n");
-    withdraw_aux(get_self(), name(bitr -> id), asset(fragment_seeds, test_symbol), "harvest");
+    pay_harvest(name(bitr -> id), asset(fragment_seeds, test_symbol), payout);
 
     bitr++;
     count++;
@@ -1327,6 +1694,8 @@ void harvest::disthvstrgns (uint64_t start, uint64_t chunksize, asset total_amou
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
     tx.send(sum_rank_rgns.value, _self);
+  } else if (payout == payout_settle) {
+    send_settle();
   }
 
 }
@@ -1343,14 +1712,16 @@ void harvest::disthvstorgs (uint64_t start, uint64_t chunksize, asset total_amou
   check(sum_rank > 0, "the sum rank for organizations must be greater than zero");
 
   double fragment_seeds = total_amount.amount / double(sum_rank);
+  uint64_t payout = payout_mode();
   
   while (csitr != cspoints_t.end() && count < chunksize) {
 
     // auto uitr = users.find(csitr -> account.value);
-    if (csitr->rank > 0) {
+    uint64_t rank = published_rank(get_self(), "rankcs"_n, organization_scope, csitr->account.value, csitr->rank);
+    if (rank > 0) {
 
-      print("org:", csitr -> account, ", rank:", csitr -> rank, ", amount:", asset(csitr -> rank * fragment_seeds, test_symbol), "\n");
-      withdraw_aux(get_self(), csitr -> account, asset(csitr -> rank * fragment_seeds, test_symbol), "harvest");
+      print("org:", csitr -> account, ", rank:", rank, ", amount:", asset(rank * fragment_seeds, test_symbol), "\n");
+      pay_harvest(csitr -> account, asset(rank * fragment_seeds, test_symbol), payout);
     
     }
 
@@ -1370,6 +1741,8 @@ void harvest::disthvstorgs (uint64_t start, uint64_t chunksize, asset total_amou
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
     tx.send(sum_rank_orgs.value, _self);
+  } else if (payout == payout_settle) {
+    send_settle();
   }
 }
 
@@ -1405,10 +1778,11 @@ ACTION harvest::migorgs (uint64_t start) {
 
   while (csitr != cspoints.end() && count < batch_size) {
 
-    auto uitr = users.find(csitr->account.value);
-    if (uitr->type == name("organisation")) {
+    user_core_table user{};
+    user_core::find(csitr->account, user);
+    if (user.type == name("organisation")) {
 
-      auto org_itr = cspoints_org.find(uitr->account.value);
+      auto org_itr = cspoints_org.find(csitr->account.value);
 
       if (org_itr != cspoints_org.end()) {
         cspoints_org.modify(org_itr, _self, [&](auto & item){
@@ -1417,7 +1791,7 @@ ACTION harvest::migorgs (uint64_t start) {
         });
       } else {
         cspoints_org.emplace(_self, [&](auto & item){
-          item.account = uitr->account;
+          item.account = csitr->account;
           item.contribution_points = csitr->contribution_points;
           item.rank = csitr->rank;
         });
@@ -1445,6 +1819,174 @@ ACTION harvest::migorgs (uint64_t start) {
 
 }
 
+// read only, prints the account's current rank in one of the ranked tables
+ACTION harvest::rankof (name tree, name account) {
+  check(tree == planted_tree || tree == tx_points_tree || tree == org_tx_points_tree, "invalid rank tree " + tree.to_string());
+
+  uint64_t value = 0;
+
+  if (tree == planted_tree) {
+    auto pitr = planted.find(account.value);
+    check(pitr != planted.end(), account.to_string() + " has nothing planted");
+    value = pitr->planted.amount;
+  } else {
+    tx_points_tables txpoints_table(get_self(), tree == org_tx_points_tree ? organization_scope.value : get_self().value);
+    auto titr = txpoints_table.find(account.value);
+    check(titr != txpoints_table.end(), account.to_string() + " has no transaction points");
+    value = titr->points;
+  }
+
+  rank_tree_tables ranktree(get_self(), tree.value);
+  print("account:", account, ", rank:", rank_tree::rank_of(ranktree, value), "\n");
+}
+
+// fills a rank tree from the rows already in its table, start 0 rebuilds it from scratch
+ACTION harvest::initranks (name tree, uint64_t start) {
+  require_auth(get_self());
+
+  check(tree == planted_tree || tree == tx_points_tree || tree == org_tx_points_tree, "invalid rank tree " + tree.to_string());
+
+  rank_tree_tables ranktree(get_self(), tree.value);
+  if (start == 0) {
+    rank_tree::clear(ranktree);
+  }
+
+  uint64_t batch_size = config_get(name("batchsize"));
+  uint64_t count = 0;
+  uint64_t next = 0;
+
+  if (tree == planted_tree) {
+    auto pitr = planted.lower_bound(start);
+    while (pitr != planted.end() && count < batch_size) {
+      rank_tree::insert(ranktree, pitr->planted.amount, _self);
+      pitr++;
+      count++;
+    }
+    if (pitr != planted.end()) next = pitr->account.value;
+  } else {
+    tx_points_tables txpoints_table(get_self(), tree == org_tx_points_tree ? organization_scope.value : get_self().value);
+    auto titr = txpoints_table.lower_bound(start);
+    while (titr != txpoints_table.end() && count < batch_size) {
+      rank_tree::insert(ranktree, titr->points, _self);
+      titr++;
+      count++;
+    }
+    if (titr != txpoints_table.end()) next = titr->account.value;
+  }
+
+  if (next != 0) {
+    rank_tree::built_to(ranktree, next, _self);
+
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "initranks"_n,
+      std::make_tuple(tree, next)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(tree.value, _self);
+  } else {
+    rank_tree::built(ranktree, _self);
+  }
+
+}
+
+// fills the score vector from the ranked tables and region memberships, one batch of users at a time
+ACTION harvest::initscores (uint64_t start) {
+  require_auth(get_self());
+
+  tx_points_tables orgtxpoints(get_self(), "org"_n.value);
+
+  uint64_t batch_size = config_get(name("batchsize"));
+  uint64_t count = 0;
+
+  auto uitr = users.lower_bound(start);
+  while (uitr != users.end() && count < batch_size) {
+    name account = uitr->account;
+    bool org = uitr->type == "organisation"_n;
+    name scope = org ? organization_scope : individual_scope_accounts;
+
+    rep_tables rep_t(contracts::accounts, scope.value);
+    cbs_tables cbs_t(contracts::accounts, scope.value);
+
+    auto pitr = planted.find(account.value);
+    auto titr = org ? orgtxpoints.find(account.value) : txpoints.find(account.value);
+    auto ritr = rep_t.find(account.value);
+    auto citr = cbs_t.find(account.value);
+    auto mitr = members.find(account.value);
+
+    set_score_rank(score_vector::planted, account, pitr != planted.end() ? pitr->rank : 0);
+    set_score_rank(score_vector::tx, account, titr != (org ? orgtxpoints.end() : txpoints.end()) ? titr->rank : 0);
+    set_score_rank(score_vector::rep, account, ritr != rep_t.end() ? ritr->rank : 0);
+    set_score_rank(score_vector::cbs, account, citr != cbs_t.end() ? citr->rank : 0);
+    set_score_region(account, mitr != members.end() ? mitr->region : name());
+
+    uitr++;
+    count++;
+  }
+
+  if (uitr != users.end()) {
+    uint64_t next_value = uitr->account.value;
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "initscores"_n,
+      std::make_tuple(next_value)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(next_value, _self);
+  }
+
+}
+
+// rebuilds the region totals from the individual contribution points, start 0 rebuilds them from scratch
+ACTION harvest::initrgncs (uint64_t start) {
+  require_auth(get_self());
+
+  if (start == 0) {
+    auto bcsitr = regioncstemp.begin();
+    while (bcsitr != regioncstemp.end()) {
+      bcsitr = regioncstemp.erase(bcsitr);
+    }
+    size_set(cs_rgn_size, 0);
+  }
+
+  uint64_t batch_size = config_get(name("batchsize"));
+  uint64_t count = 0;
+
+  auto csitr = cspoints.lower_bound(start);
+  while (csitr != cspoints.end() && count < batch_size) {
+    auto sitr = scores.find(csitr->account.value);
+    if (sitr != scores.end()) {
+      change_region_cs(sitr->region, int64_t(csitr->contribution_points));
+    }
+    csitr++;
+    count++;
+  }
+
+  if (csitr != cspoints.end()) {
+    uint64_t next_value = csitr->account.value;
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "initrgncs"_n,
+      std::make_tuple(next_value)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(next_value, _self);
+  }
+
+}
+
 ACTION harvest::delcsorg (uint64_t start) {
   require_auth(get_self());
 
@@ -1454,8 +1996,9 @@ ACTION harvest::delcsorg (uint64_t start) {
   uint64_t count = 0;
 
   while (csitr != cspoints.end() && count < batch_size) {
-    auto uitr = users.find(csitr->account.value);
-    if (uitr->type == name("organisation")) {
+    user_core_table user{};
+    user_core::find(csitr->account, user);
+    if (user.type == name("organisation")) {
       csitr = cspoints.erase(csitr);
     } else {
       csitr++;
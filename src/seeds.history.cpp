@@ -19,12 +19,42 @@ void history::reset(name account) {
     titr = transactions.erase(titr);
   }
 
+  auto witr = txwindows.find(account.value);
+  if (witr != txwindows.end()) {
+    txwindows.erase(witr);
+  }
+
+  auto expiry_by_account = txexpiry.get_index<"byaccount"_n>();
+  auto eitr = expiry_by_account.find(account.value);
+  while (eitr != expiry_by_account.end() && eitr->account == account) {
+    eitr = expiry_by_account.erase(eitr);
+  }
+
   qev_tables qevs(get_self(), account.value);
   auto qitr = qevs.begin();
   while (qitr != qevs.end()) {
     qitr = qevs.erase(qitr);
   }
 
+  if (account == get_self()) {
+    qev_window_tables qevwindow(get_self(), get_self().value);
+    qevwindow.remove();
+
+    auto pitr = pending.begin();
+    while (pitr != pending.end()) {
+      pitr = pending.erase(pitr);
+    }
+
+    pending_points_tables parked(get_self(), parked_scope.value);
+    auto paitr = parked.begin();
+    while (paitr != parked.end()) {
+      paitr = parked.erase(paitr);
+    }
+
+    drain_state_tables drainstate(get_self(), get_self().value);
+    drainstate.remove();
+  }
+
   auto citr = citizens.begin();
   while (citr != citizens.end()) {
     citr = citizens.erase(citr);
@@ -83,9 +113,9 @@ void history::addcitizen(name account) {
 void history::addreputable(name organization) {
   require_auth(get_self());
 
-  auto uitr = users.find(organization.value);
-  check(uitr != users.end(), "no user found");
-  check(uitr -> type == name("organisation"), "the user type must be organization");
+  user_core_table user;
+  check(user_core::find(organization, user), "no user found");
+  check(user.type == name("organisation"), "the user type must be organization");
 
   reputables.emplace(_self, [&](auto & org){
     org.id = reputables.available_primary_key();
@@ -98,9 +128,9 @@ void history::addreputable(name organization) {
 void history::addregen(name organization) {
   require_auth(get_self());
 
-  auto uitr = users.find(organization.value);
-  check(uitr != users.end(), "no user found");
-  check(uitr -> type == name("organisation"), "the user type must be organization");
+  user_core_table user;
+  check(user_core::find(organization, user), "no user found");
+  check(user.type == name("organisation"), "the user type must be organization");
 
   regens.emplace(_self, [&](auto & org){
     org.id = regens.available_primary_key();
@@ -110,28 +140,30 @@ void history::addregen(name organization) {
   size_change("regens.sz"_n, 1);
 }
 
-double history::get_transaction_multiplier (name account, name other) {
-  double multiplier = utils::get_rep_multiplier(account);
+// both parties come from user_core::find, which reads rank, organization status and region from their
+// source tables when initcore has not written the usercore row yet
+double history::get_transaction_multiplier (const user_core_table & account, const user_core_table & other) {
+  double multiplier = utils::rep_multiplier_for_score(published_rep_rank(account));
   
-  auto oitr = organizations.find(account.value);
-  if (oitr != organizations.end() && oitr -> status == regenerative_org) {
-    multiplier *= config_float_get("regen.mul"_n);
+  if (account.org_status == regenerative_org) {
+    multiplier *= conf.get(config_snapshot::regen_mul);
   }
 
-  auto bitr_account = members.find(account.value);
-  auto bitr_other = members.find(other.value);
-
-  if (
-    bitr_account != members.end() && 
-    bitr_other != members.end() && 
-    bitr_account -> region == bitr_other -> region
-  ) {
-    multiplier *= config_float_get("local.mul"_n);
+  if (account.region != name() && account.region == other.region) {
+    multiplier *= conf.get(config_snapshot::local_mul);
   }
 
   return multiplier;
 }
 
+// rankrep writes each new rank into usercore as it goes, so while a pass is running the rank comes
+// from its last published pass, and every transfer sees the old ranks or the new ones but not a mix
+uint64_t history::published_rep_rank (const user_core_table & account) {
+  name scope = account.type == "organisation"_n ? organization_scope : individual_scope_accounts;
+  ranking::published ranks(contracts::accounts, "rankrep"_n, scope);
+  return ranks.rank(account.account.value, account.rep_rank);
+}
+
 void history::historyentry(name account, string action, uint64_t amount, string meta) {
   require_auth(get_self());
 
@@ -154,10 +186,9 @@ void history::trxentry(name from, name to, asset quantity) {
     return;
   }
 
-  auto from_user = users.find(from.value);
-  auto to_user = users.find(to.value);
+  user_core_table from_user, to_user;
   
-  if (from_user == users.end() || to_user == users.end()) {
+  if (!user_core::find(from, from_user) || !user_core::find(to, to_user)) {
     return;
   }
 
@@ -168,12 +199,12 @@ void history::trxentry(name from, name to, asset quantity) {
   uint64_t transaction_id = transactions.available_primary_key();
   uint64_t timestamp = eosio::current_time_point().sec_since_epoch();
 
-  bool from_is_organization = from_user -> type == "organisation"_n;
-  bool to_is_organization = to_user -> type == "organisation"_n;
+  bool from_is_organization = from_user.type == "organisation"_n;
+  bool to_is_organization = to_user.type == "organisation"_n;
 
-  int64_t transactions_cap = int64_t(config_get("qev.trx.cap"_n));
-  int64_t max_transaction_points_individuals = int64_t(config_get("i.trx.max"_n));
-  int64_t max_transaction_points_organizations = int64_t(config_get("org.trx.max"_n));
+  int64_t transactions_cap = int64_t(conf.get(config_snapshot::qev_trx_cap));
+  int64_t max_transaction_points_individuals = int64_t(conf.get(config_snapshot::i_trx_max));
+  int64_t max_transaction_points_organizations = int64_t(conf.get(config_snapshot::org_trx_max));
 
   double from_capped_amount = (
     from_is_organization ? 
@@ -183,14 +214,18 @@ void history::trxentry(name from, name to, asset quantity) {
   
   double to_capped_amount = std::min(max_transaction_points_organizations, quantity.amount) / 10000.0;
 
+  uint64_t qualifying_volume = std::min(transactions_cap, quantity.amount);
+  uint64_t from_points = uint64_t(ceil(from_capped_amount * get_transaction_multiplier(to_user, from_user)));
+  uint64_t to_points = to_is_organization ? uint64_t(ceil(to_capped_amount * get_transaction_multiplier(from_user, to_user))) : 0;
+
   transactions.emplace(_self, [&](auto & transaction){
     transaction.id = transaction_id;
     transaction.from = from;
     transaction.to = to;
     transaction.volume = quantity.amount;
-    transaction.qualifying_volume = std::min(transactions_cap, quantity.amount);
-    transaction.from_points = uint64_t(ceil(from_capped_amount * get_transaction_multiplier(to, from)));
-    transaction.to_points = to_is_organization ? uint64_t(ceil(to_capped_amount * get_transaction_multiplier(from, to))) : 0;
+    transaction.qualifying_volume = qualifying_volume;
+    transaction.from_points = from_points;
+    transaction.to_points = to_points;
     transaction.timestamp = timestamp;
   });
 
@@ -229,19 +264,183 @@ void history::trxentry(name from, name to, asset quantity) {
     }
   }
 
-  cancel_deferred(from.value);
+  queue_points(from, to, day, from_points, to_points, qualifying_volume);
+}
+
+// transfers between the same accounts on the same day share one pending row
+void history::queue_points (name from, name to, uint64_t day, uint64_t from_points, uint64_t to_points, uint64_t qualifying_volume) {
+  bool idle = pending.begin() == pending.end();
+
+  auto pending_by_from_to = pending.get_index<"byfromto"_n>();
+  auto pitr = pending_by_from_to.find((uint128_t(from.value) << 64) + to.value);
+  while (pitr != pending_by_from_to.end() && pitr -> from == from && pitr -> to == to && pitr -> day != day) {
+    pitr++;
+  }
+
+  if (pitr != pending_by_from_to.end() && pitr -> from == from && pitr -> to == to) {
+    pending_by_from_to.modify(pitr, _self, [&](auto & item){
+      item.from_points += from_points;
+      item.to_points += to_points;
+      item.qualifying_volume += qualifying_volume;
+      item.count += 1;
+    });
+  } else {
+    pending.emplace(_self, [&](auto & item){
+      item.id = pending.available_primary_key();
+      item.day = day;
+      item.from = from;
+      item.to = to;
+      item.from_points = from_points;
+      item.to_points = to_points;
+      item.qualifying_volume = qualifying_volume;
+      item.count = 1;
+    });
+  }
+
+  // a failed drainpoints does not send the next one, so a drain not heard from for a while is sent again
+  drain_state_tables drainstate(get_self(), get_self().value);
+  drain_state_table state = drainstate.get_or_default(drain_state_table{ 0, 0 });
+  uint64_t now = eosio::current_time_point().sec_since_epoch();
+
+  if (idle) {
+    send_drain_points(0);
+  } else if (now > state.scheduled_at + drain_timeout_sec) {
+    send_drain_points(state.retries + 1);
+  }
+}
+
+void history::send_drain_points (uint64_t retries) {
+  drain_state_tables drainstate(get_self(), get_self().value);
+  drainstate.set(drain_state_table{ eosio::current_time_point().sec_since_epoch(), retries }, _self);
 
   action a(
     permission_level{contracts::history, "active"_n},
     get_self(),
-    "savepoints"_n,
-    std::make_tuple(transaction_id, timestamp)
+    "drainpoints"_n,
+    std::make_tuple()
   );
 
   transaction tx;
   tx.actions.emplace_back(a);
   tx.delay_sec = 1;
-  tx.send(from.value, _self);
+  tx.send("drainpoints"_n.value, _self, true);
+}
+
+// every retry after a failed drain halves the rows per transaction. Once a single row has failed,
+// it is parked so the rest of the queue can drain, requeuepts puts it back.
+void history::drainpoints () {
+  require_auth(get_self());
+
+  drain_state_tables drainstate(get_self(), get_self().value);
+  drain_state_table state = drainstate.get_or_default(drain_state_table{ 0, 0 });
+
+  uint64_t batch_size = state.retries < 64 ? config_get("batchsize"_n) >> state.retries : 0;
+  uint64_t max_number_transactions = config_get("htry.trx.max"_n);
+  uint64_t count = 0;
+
+  auto pitr = pending.begin();
+
+  if (batch_size == 0) {
+    batch_size = 1;
+    state.retries -= 1;
+
+    if (pitr != pending.end()) {
+      pending_points_tables parked(get_self(), parked_scope.value);
+      parked.emplace(_self, [&](auto & item){
+        item = *pitr;
+        item.id = parked.available_primary_key();
+      });
+      pitr = pending.erase(pitr);
+    }
+  }
+
+  std::vector<name> update_txpoints;
+
+  while (pitr != pending.end() && count < batch_size) {
+    name from = pitr -> from;
+    name to = pitr -> to;
+    uint64_t day = pitr -> day;
+
+    int64_t from_points = int64_t(pitr -> from_points);
+    int64_t to_points = int64_t(pitr -> to_points);
+    int64_t qualifying_volume = int64_t(pitr -> qualifying_volume);
+
+    // only the largest htry.trx.max transfers between two accounts in a day count,
+    // drop the smallest ones the new transfers pushed out
+    daily_transactions_tables transactions(get_self(), day);
+    auto transactions_by_from_to = transactions.get_index<"byfromto"_n>();
+
+    std::vector<std::pair<uint64_t, uint64_t>> pair_transactions;
+    auto ft_itr = transactions_by_from_to.find((uint128_t(from.value) << 64) + to.value);
+    while (ft_itr != transactions_by_from_to.end() && ft_itr -> from == from && ft_itr -> to == to) {
+      pair_transactions.push_back(std::make_pair(ft_itr -> volume, ft_itr -> id));
+      ft_itr++;
+    }
+
+    if (pair_transactions.size() > max_number_transactions) {
+      std::stable_sort(pair_transactions.begin(), pair_transactions.end(), 
+        [](const auto & a, const auto & b) { return a.first < b.first; });
+
+      for (uint64_t i = 0; i < pair_transactions.size() - max_number_transactions; i++) {
+        auto titr = transactions.find(pair_transactions[i].second);
+        from_points -= titr -> from_points;
+        to_points -= titr -> to_points;
+        qualifying_volume -= titr -> qualifying_volume;
+        transactions.erase(titr);
+      }
+    }
+
+    save_from_metrics(from, from_points, qualifying_volume, day);
+
+    user_core_table to_user, from_user;
+    if (user_core::find(to, to_user) && to_user.type == name("organisation")) {
+      add_trx_points(to, to_points, day);
+    }
+
+    if (user_core::find(from, from_user) && from_user.type != name("organisation")) {
+      if (std::find(update_txpoints.begin(), update_txpoints.end(), from) == update_txpoints.end()) {
+        update_txpoints.push_back(from);
+      }
+    }
+
+    pitr = pending.erase(pitr);
+    count++;
+  }
+
+  for (auto account : update_txpoints) {
+    action(
+      permission_level{contracts::harvest, "active"_n},
+      contracts::harvest,
+      "updatetxpt"_n,
+      std::make_tuple(account)
+    ).send();
+  }
+
+  if (pitr != pending.end()) {
+    send_drain_points(state.retries);
+  } else {
+    drainstate.remove();
+  }
+}
+
+void history::requeuepts (uint64_t id) {
+  require_auth(get_self());
+
+  pending_points_tables parked(get_self(), parked_scope.value);
+  auto paitr = parked.find(id);
+  check(paitr != parked.end(), "parked points not found");
+
+  bool idle = pending.begin() == pending.end();
+
+  pending.emplace(_self, [&](auto & item){
+    item = *paitr;
+    item.id = pending.available_primary_key();
+  });
+  parked.erase(paitr);
+
+  if (idle) {
+    send_drain_points(0);
+  }
 }
 
 
@@ -259,8 +458,9 @@ void history::savepoints(uint64_t id, uint64_t timestamp) {
   name from = titr -> from;
   name to = titr -> to;
 
-  auto uitr_from = users.find(from.value);
-  auto uitr_to = users.find(to.value);
+  user_core_table from_user{}, to_user{};
+  user_core::find(from, from_user);
+  user_core::find(to, to_user);
 
   uint64_t max_number_transactions = config_get("htry.trx.max"_n);
 
@@ -296,46 +496,21 @@ void history::savepoints(uint64_t id, uint64_t timestamp) {
 
   save_from_metrics (from, from_points, qualifying_volume, day);
 
-  if (uitr_to -> type == name("organisation")) {
-    transaction_points_tables trx_points_to(get_self(), to.value);
-    auto trx_itr_to = trx_points_to.find(day);
-
-    if (trx_itr_to != trx_points_to.end()) {
-      trx_points_to.modify(trx_itr_to, _self, [&](auto & item){
-        item.points += to_points;
-      });
-    } else {
-      trx_points_to.emplace(_self, [&](auto & item){
-        item.timestamp = day;
-        item.points = to_points;
-      });
-    }
+  if (to_user.type == name("organisation")) {
+    add_trx_points(to, to_points, day);
   }
 
-  if (uitr_from -> type != name("organisation")) {
+  if (from_user.type != name("organisation")) {
     send_update_txpoints(from);
   }
 }
 
 void history::save_from_metrics (name from, int64_t & from_points, int64_t & qualifying_volume, uint64_t & day) {
-  transaction_points_tables trx_points_from(get_self(), from.value);
   qev_tables qevs(get_self(), from.value);
-  qev_tables qevs_total(get_self(), get_self().value);
 
-  auto trx_itr = trx_points_from.find(day);
   auto qev_itr = qevs.find(day);
-  auto qev_total_itr = qevs_total.find(day);
 
-  if (trx_itr != trx_points_from.end()) {
-    trx_points_from.modify(trx_itr, _self, [&](auto & item){
-      item.points += from_points;
-    });
-  } else {
-    trx_points_from.emplace(_self, [&](auto & item){
-      item.timestamp = day;
-      item.points = from_points;
-    });
-  }
+  add_trx_points(from, from_points, day);
 
   if (qev_itr != qevs.end()) {
     qevs.modify(qev_itr, _self, [&](auto & item){
@@ -348,6 +523,38 @@ void history::save_from_metrics (name from, int64_t & from_points, int64_t & qua
     });
   }
 
+  change_total_qev(day, qualifying_volume);
+}
+
+// keeps the qevwindow sum over the last moon cycle in step with the total qevs rows
+void history::change_total_qev (uint64_t day, int64_t qualifying_volume) {
+  qev_tables qevs_total(get_self(), get_self().value);
+  qev_window_tables qevwindow(get_self(), get_self().value);
+
+  uint64_t cutoff = utils::get_beginning_of_day_in_seconds() - utils::moon_cycle;
+
+  qev_window_table window;
+  if (qevwindow.exists()) {
+    window = qevwindow.get();
+
+    auto qitr = qevs_total.lower_bound(window.start);
+    while (qitr != qevs_total.end() && qitr -> timestamp < cutoff) {
+      window.qualifying_volume -= qitr -> qualifying_volume;
+      qitr++;
+    }
+  } else {
+    window.qualifying_volume = 0;
+    window.start = cutoff;
+
+    auto qitr = qevs_total.rbegin();
+    while (qitr != qevs_total.rend() && qitr -> timestamp >= cutoff) {
+      window.qualifying_volume += qitr -> qualifying_volume;
+      qitr++;
+    }
+  }
+  window.start = std::max(window.start, cutoff);
+
+  auto qev_total_itr = qevs_total.find(day);
   if (qev_total_itr != qevs_total.end()) {
     qevs_total.modify(qev_total_itr, _self, [&](auto & item){
       item.qualifying_volume += qualifying_volume;
@@ -358,6 +565,133 @@ void history::save_from_metrics (name from, int64_t & from_points, int64_t & qua
       item.qualifying_volume = qualifying_volume;
     });
   }
+
+  if (day >= window.start) {
+    window.qualifying_volume += qualifying_volume;
+  }
+
+  qevwindow.set(window, get_self());
+}
+
+// trxpoints rows from this day on count towards transaction points, same cutoff harvest uses
+uint64_t history::tx_points_cutoff () {
+  uint64_t now = eosio::current_time_point().sec_since_epoch();
+  return now - (utils::moon_cycle * conf.get(config_snapshot::cyctrx_trail));
+}
+
+void history::add_trx_points (name account, int64_t points, uint64_t day) {
+  transaction_points_tables trx_points(get_self(), account.value);
+
+  auto witr = txwindows.find(account.value);
+  if (witr == txwindows.end()) {
+    init_tx_window(account);
+    witr = txwindows.find(account.value);
+  }
+
+  auto trx_itr = trx_points.find(day);
+  bool new_day = trx_itr == trx_points.end();
+
+  if (!new_day) {
+    trx_points.modify(trx_itr, _self, [&](auto & item){
+      item.points += points;
+    });
+  } else {
+    trx_points.emplace(_self, [&](auto & item){
+      item.timestamp = day;
+      item.points = points;
+    });
+  }
+
+  if (day < witr->start) {
+    return;
+  }
+
+  txwindows.modify(witr, _self, [&](auto & item){
+    item.points += points;
+  });
+
+  if (new_day) {
+    txexpiry.emplace(_self, [&](auto & item){
+      item.id = txexpiry.available_primary_key();
+      item.account = account;
+      item.day = day;
+    });
+  }
+}
+
+// accounts that had transaction points before windows existed are summed up once
+void history::init_tx_window (name account) {
+  transaction_points_tables trx_points(get_self(), account.value);
+
+  uint64_t cutoff = tx_points_cutoff();
+  uint64_t total_points = 0;
+
+  auto titr = trx_points.rbegin();
+  while (titr != trx_points.rend() && titr->timestamp >= cutoff) {
+    total_points += titr->points;
+    uint64_t day = titr->timestamp;
+    txexpiry.emplace(_self, [&](auto & item){
+      item.id = txexpiry.available_primary_key();
+      item.account = account;
+      item.day = day;
+    });
+    titr++;
+  }
+
+  txwindows.emplace(_self, [&](auto & item){
+    item.account = account;
+    item.points = total_points;
+    item.start = cutoff;
+  });
+}
+
+void history::expiretxpts () {
+  require_auth(get_self());
+
+  uint64_t cutoff = tx_points_cutoff();
+  uint64_t batch_size = config_get("batchsize"_n);
+  uint64_t count = 0;
+
+  auto expiry_by_day = txexpiry.get_index<"byday"_n>();
+  auto eitr = expiry_by_day.begin();
+
+  while (eitr != expiry_by_day.end() && eitr->day < cutoff && count < batch_size) {
+    auto witr = txwindows.find(eitr->account.value);
+
+    if (witr != txwindows.end() && eitr->day >= witr->start) {
+      transaction_points_tables trx_points(get_self(), eitr->account.value);
+      auto titr = trx_points.find(eitr->day);
+      uint64_t next_day = eitr->day + utils::seconds_per_day;
+
+      txwindows.modify(witr, _self, [&](auto & item){
+        if (titr != trx_points.end()) {
+          item.points -= titr->points;
+        }
+        item.start = next_day;
+      });
+    }
+
+    eitr = expiry_by_day.erase(eitr);
+    count++;
+  }
+
+  jobs::chunk(get_self(), "expiretxpts"_n, count);
+
+  if (eitr != expiry_by_day.end() && eitr->day < cutoff) {
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "expiretxpts"_n,
+      std::make_tuple()
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send("expiretxpts"_n.value, _self, true);
+  } else {
+    jobs::finish(get_self(), "expiretxpts"_n);
+  }
 }
 
 // CAUTION: this will iterate on all citizens, residents and orgs
@@ -471,32 +805,16 @@ void history::numtrx(name account) {
 
 void history::check_user(name account)
 {
-  auto uitr = users.find(account.value);
-  check(uitr != users.end(), "no user");
+  user_core_table user;
+  check(user_core::find(account, user), "no user");
 }
 
 uint64_t history::config_get(name key) {
-  DEFINE_CONFIG_TABLE
-  DEFINE_CONFIG_TABLE_MULTI_INDEX
-  config_tables config(contracts::settings, contracts::settings.value);
-
-  auto citr = config.find(key.value);
-  if (citr == config.end()) { 
-    check(false, ("settings: the "+key.to_string()+" parameter has not been initialized").c_str());
-  }
-  return citr->value;
+  return conf.get(key);
 }
 
 double history::config_float_get(name key) {
-  DEFINE_CONFIG_FLOAT_TABLE
-  DEFINE_CONFIG_FLOAT_TABLE_MULTI_INDEX
-  config_float_tables config(contracts::settings, contracts::settings.value);
-
-  auto citr = config.find(key.value);
-  if (citr == config.end()) { 
-    check(false, ("settings: the "+key.to_string()+" parameter has not been initialized").c_str());
-  }
-  return citr->value;
+  return conf.get_float(key);
 }
 
 
@@ -511,17 +829,9 @@ void history::testtotalqev (uint64_t numdays, uint64_t volume) {
 
   while (current_day >= cutoff) {
     auto qitr = qevs_total.find(current_day);
+    uint64_t previous = qitr != qevs_total.end() ? qitr -> qualifying_volume : 0;
 
-    if (qitr != qevs_total.end()) {
-      qevs_total.modify(qitr, _self, [&](auto & item){
-        item.qualifying_volume = volume;
-      });
-    } else {
-      qevs_total.emplace(_self, [&](auto & item){
-        item.timestamp = current_day;
-        item.qualifying_volume = volume;
-      });
-    }
+    change_total_qev(current_day, int64_t(volume) - int64_t(previous));
 
     current_day -= utils::seconds_per_day;
   }
@@ -538,6 +848,11 @@ void history::migrateusers () {
 void history::migrateuser (uint64_t start, uint64_t transaction_id, uint64_t chunksize) {
   require_auth(get_self());
 
+  // walks every user, usercore can be missing the ones initcore has not reached
+  DEFINE_USER_TABLE
+  DEFINE_USER_TABLE_MULTI_INDEX
+  user_tables users(contracts::accounts, contracts::accounts.value);
+
   auto uitr = start == 0 ? users.begin() : users.find(start);
   uint64_t count = 0;
 
@@ -610,8 +925,9 @@ void history::migrateuser (uint64_t start, uint64_t transaction_id, uint64_t chu
 
 void history::save_migration_user_transaction (name from, name to, asset quantity, uint64_t timestamp) {
 
-  auto from_user = users.find(from.value);
-  auto to_user = users.find(to.value);
+  user_core_table from_user{}, to_user{};
+  user_core::find(from, from_user);
+  user_core::find(to, to_user);
 
   auto date = eosio::time_point_sec(timestamp / 86400 * 86400);
   uint64_t day = date.utc_seconds;
@@ -621,12 +937,12 @@ void history::save_migration_user_transaction (name from, name to, asset quantit
   
   uint64_t transaction_id = transactions.available_primary_key();
 
-  bool from_is_organization = from_user -> type == "organisation"_n;
-  bool to_is_organization = to_user -> type == "organisation"_n;
+  bool from_is_organization = from_user.type == "organisation"_n;
+  bool to_is_organization = to_user.type == "organisation"_n;
 
-  int64_t transactions_cap = int64_t(config_get("qev.trx.cap"_n));
-  int64_t max_transaction_points_individuals = int64_t(config_get("i.trx.max"_n));
-  int64_t max_transaction_points_organizations = int64_t(config_get("org.trx.max"_n));
+  int64_t transactions_cap = int64_t(conf.get(config_snapshot::qev_trx_cap));
+  int64_t max_transaction_points_individuals = int64_t(conf.get(config_snapshot::i_trx_max));
+  int64_t max_transaction_points_organizations = int64_t(conf.get(config_snapshot::org_trx_max));
 
   double from_trx_multiplier = (
     from_is_organization ? 
@@ -698,8 +1014,8 @@ void history::adjust_transactions (uint64_t id, uint64_t timestamp) {
   
   name from = titr -> from;
   name to = titr -> to;
-  auto uitr_from = users.find(from.value);
-  auto uitr_to = users.find(to.value);
+  user_core_table to_user{};
+  user_core::find(to, to_user);
   uint64_t max_number_transactions = config_get("htry.trx.max"_n);
   
   uint128_t from_to_id = (uint128_t(titr -> from.value) << 64) + titr -> to.value;
@@ -731,18 +1047,7 @@ void history::adjust_transactions (uint64_t id, uint64_t timestamp) {
   
   save_from_metrics(from, from_points, qualifying_volume, day);
   
-  if (uitr_to -> type == name("organisation")) {
-    transaction_points_tables trx_points_to(get_self(), to.value);
-    auto trx_itr_to = trx_points_to.find(day);
-    if (trx_itr_to != trx_points_to.end()) {
-      trx_points_to.modify(trx_itr_to, _self, [&](auto & item){
-        item.points += to_points;
-      });
-    } else {
-      trx_points_to.emplace(_self, [&](auto & item){
-        item.timestamp = day;
-        item.points = to_points;
-      });
-    }
+  if (to_user.type == name("organisation")) {
+    add_trx_points(to, to_points, day);
   }
 }
\ No newline at end of file
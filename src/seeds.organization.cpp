@@ -74,6 +74,20 @@ void organization::decrease_size_by_one(name id) {
     }
 }
 
+void organization::set_size(name id, uint64_t size) {
+    auto itr = sizes.find(id.value);
+    if (itr != sizes.end()) {
+        sizes.modify(itr, _self, [&](auto & s){
+            s.size = size;
+        });
+    } else {
+        sizes.emplace(_self, [&](auto & s){
+            s.id = id;
+            s.size = size;
+        });
+    }
+}
+
 void organization::deposit(name from, name to, asset quantity, string memo) {
     if (get_first_receiver() == contracts::token  &&  // from SEEDS token account
         to  ==  get_self() &&                     // to here
@@ -171,6 +185,8 @@ ACTION organization::reset() {
     while (cbsitr != cbsorgs.end()) {
         cbsitr = cbsorgs.erase(cbsitr);
     }
+
+    jobs::clear(get_self());
 }
 
 
@@ -247,6 +263,7 @@ ACTION organization::destroy(name organization, name owner) {
     
     auto org = organizations.find(organization.value);
     organizations.erase(org);
+    transfer_profile::send(transfer_profile::org_status, organization, regular_org);
 
     decrease_size_by_one(get_self());
 
@@ -492,17 +509,16 @@ uint64_t organization::get_regen_score(name organization) {
 }
 
 uint64_t organization::count_refs(name organization, uint32_t check_num_residents) {
-    auto refs_by_referrer = refs.get_index<"byreferrer"_n>();
-    if (check_num_residents == 0) {
-      return std::distance(refs_by_referrer.lower_bound(organization.value), refs_by_referrer.upper_bound(organization.value));
-    } else {
+    // until accounts has counted every referral in refstats, count them from refs
+    if (!refstatsst.get_or_default(referral_stats_state_table{ 0, false }).built) {
+      auto refs_by_referrer = refs.get_index<"byreferrer"_n>();
       uint64_t count = 0;
-      int residents = 0;
+      uint64_t residents = 0;
       auto ritr = refs_by_referrer.lower_bound(organization.value);
       while (ritr != refs_by_referrer.end() && ritr->referrer == organization) {
-        auto uitr = users.find(ritr->invited.value);
-        if (uitr != users.end()) {
-          if (uitr->status == "resident"_n || uitr->status == "citizen"_n) {
+        if (check_num_residents > 0) {
+          auto uitr = users.find(ritr->invited.value);
+          if (uitr != users.end() && (uitr->status == "resident"_n || uitr->status == "citizen"_n)) {
             residents++;
           }
         }
@@ -512,6 +528,16 @@ uint64_t organization::count_refs(name organization, uint32_t check_num_resident
       check(residents >= check_num_residents, "organization has not referred enough residents or citizens: "+std::to_string(residents));
       return count;
     }
+
+    auto rsitr = refstats.find(organization.value);
+    if (rsitr == refstats.end()) {
+      check(check_num_residents == 0, "organization has not referred enough residents or citizens: 0");
+      return 0;
+    }
+
+    uint64_t residents = rsitr->residents + rsitr->citizens;
+    check(residents >= check_num_residents, "organization has not referred enough residents or citizens: "+std::to_string(residents));
+    return rsitr->referrals;
 }
 
 uint64_t organization::count_transactions(name organization) {
@@ -583,6 +609,7 @@ void organization::update_status(name organization, uint64_t status) {
   organizations.modify(oitr, _self, [&](auto& org) {
     org.status = status;
   });
+  transfer_profile::send(transfer_profile::org_status, organization, status);
 }
 
 void organization::history_add_regenerative(name organization) {
@@ -705,6 +732,9 @@ ACTION organization::cleandaus () {
     require_auth(get_self());
 
     uint64_t today_timestamp = get_beginning_of_day_in_seconds();
+    uint64_t dispatched = 0;
+
+    jobs::start(get_self(), "cleandaus"_n);
 
     auto appitr = apps.begin();
     while (appitr != apps.end()) {
@@ -724,15 +754,25 @@ ACTION organization::cleandaus () {
         tx.delay_sec = 1;
         tx.send((appitr -> app_name).value + 1, _self);
 
+        dispatched++;
         appitr++;
     }
+
+    // the apps are cleaned in parallel, the last one to finish closes the job
+    set_size(daus_pending, dispatched);
+    if (dispatched == 0) {
+        jobs::finish(get_self(), "cleandaus"_n);
+    }
 }
 
 ACTION organization::cleandau (name appname, uint64_t todaytimestamp, uint64_t start) {
     require_auth(get_self());
 
     auto appitr = apps.get(appname.value, "This application does not exist.");
-    if (appitr.is_banned) { return; }
+    if (appitr.is_banned) {
+        clean_dau_done();
+        return;
+    }
 
     auto batch_size = config.get(name("batchsize").value, "The batchsize parameter has not been initialized yet.").value;
 
@@ -759,6 +799,8 @@ ACTION organization::cleandau (name appname, uint64_t todaytimestamp, uint64_t s
         dauitr++;
     }
 
+    jobs::chunk(get_self(), "cleandaus"_n, count);
+
     if (dauitr != daus.end()) {
         action clean_dau_action(
             permission_level{get_self(), "active"_n},
@@ -771,6 +813,15 @@ ACTION organization::cleandau (name appname, uint64_t todaytimestamp, uint64_t s
         tx.actions.emplace_back(clean_dau_action);
         tx.delay_sec = 1;
         tx.send((appitr.app_name).value + 1, _self);
+    } else {
+        clean_dau_done();
+    }
+}
+
+void organization::clean_dau_done() {
+    decrease_size_by_one(daus_pending);
+    if (get_size(daus_pending) == 0) {
+        jobs::finish(get_self(), "cleandaus"_n);
     }
 }
 
@@ -125,8 +125,8 @@ void pouch::_deposit (asset quantity) {
 }
 
 void pouch::check_user (name account) {
-  auto uitr = users.find(account.value);
-  check(uitr != users.end(), "pouch: no user");
+  user_core_table user;
+  check(user_core::find(account, user), "pouch: no user");
 }
 
 void pouch::_transfer (name beneficiary, asset quantity, string memo) {
@@ -14,6 +14,18 @@ void proposals::reset() {
       voteitr = votes.erase(voteitr);
     }
 
+    delegated_vote_tables delvotes(get_self(), pitr->id);
+    auto dvotitr = delvotes.begin();
+    while (dvotitr != delvotes.end()) {
+      dvotitr = delvotes.erase(dvotitr);
+    }
+
+    vote_override_tables overrides(get_self(), pitr->id);
+    auto oitr = overrides.begin();
+    while (oitr != overrides.end()) {
+      oitr = overrides.erase(oitr);
+    }
+
     pitr = props.erase(pitr);
   }
 
@@ -38,6 +50,11 @@ void proposals::reset() {
     mitr = minstake.erase(mitr);
   }
 
+  auto litr = liveprops.begin();
+  while (litr != liveprops.end()) {
+    litr = liveprops.erase(litr);
+  }
+
   auto aitr = actives.begin();
   while (aitr != actives.end()) {
     aitr = actives.erase(aitr);
@@ -56,6 +73,12 @@ void proposals::reset() {
     while (ditr != deltrusts.end()) {
       ditr = deltrusts.erase(ditr);
     }
+
+    delegated_voice_tables delvoice(get_self(), (scopes[i]).value);
+    auto dvitr = delvoice.begin();
+    while (dvitr != delvoice.end()) {
+      dvitr = delvoice.erase(dvitr);
+    }
   }
 
   auto citr = cyclestats.begin();
@@ -65,6 +88,8 @@ void proposals::reset() {
 
   cycle.remove();
 
+  instrument::clear(get_self());
+  jobs::clear(get_self());
 }
 
 bool proposals::is_enough_stake(asset staked, asset quantity, name fund) {
@@ -180,6 +205,7 @@ uint64_t proposals::get_size(name id) {
   size_tables sizes(get_self(), get_self().value);
 
   auto sitr = sizes.find(id.value);
+  instrument::read();
   if (sitr == sizes.end()) {
     return 0;
   } else {
@@ -217,6 +243,7 @@ void proposals::calcvotepow() {
   DEFINE_CS_POINTS_TABLE_MULTI_INDEX
 
   cs_points_tables cspoints(contracts::harvest, contracts::harvest.value);
+  ranking::published cs_ranks(contracts::harvest, "rankcs"_n, contracts::harvest);
   uint64_t cutoff_date = active_cutoff_date();
   uint64_t vote_power = 0;
   uint64_t voice_size = 0;
@@ -227,7 +254,7 @@ void proposals::calcvotepow() {
       auto csitr = cspoints.find(vitr->account.value);
       uint64_t points = 0;
       if (csitr != cspoints.end()) {
-        points = csitr -> rank;
+        points = cs_ranks.rank(csitr->account.value, csitr->rank);
       }
 
       vote_power += points;
@@ -258,48 +285,47 @@ uint64_t proposals::active_cutoff_date() {
 
 bool proposals::is_active(name account, uint64_t cutoff_date) {
   auto aitr = actives.find(account.value);
+  instrument::read();
   return aitr != actives.end() && aitr->timestamp > cutoff_date;
 }
 
 void proposals::onperiod() {
     require_auth(_self);
 
-    auto props_by_status = props.get_index<"bystatus"_n>();
+    check(get_size(user_active_size) > 0, "no eligible voters - likely an error; can't run proposals.");
 
-    uint64_t prop_majority = config_get(name("propmajority"));
+    jobs::start(get_self(), "onperiod"_n);
+    evalprops((uint64_t)0, get_size(prop_active_size));
+}
 
-    uint64_t number_active_proposals = get_size(prop_active_size);
-    uint64_t total_eligible_voters = get_size(user_active_size);
-    check(total_eligible_voters > 0, "no eligible voters - likely an error; can't run proposals.");
-    
-    uint64_t quorum =  get_quorum(number_active_proposals);
+// moves staged proposals to active and evaluates active ones, only proposals in liveprops are visited
+void proposals::evalprops(uint64_t start, uint64_t active_proposals) {
+    require_auth(_self);
+    instrument::begin("evalprops"_n);
+
+    uint64_t prop_majority = config_get(name("propmajority"));
 
     cycle_table c = cycle.get_or_create(get_self(), cycle_table());
     uint64_t current_cycle = c.propcycle;
+    instrument::read();
 
-    std::vector<uint64_t> active_props;
-    std::vector<uint64_t> eval_props;
+    uint64_t batch_size = config_get(name("batchsize"));
+    uint64_t count = 0;
 
-    // TODO this is not working at the moment, use old way... FIX after this cycle.
+    auto litr = liveprops.lower_bound(start);
+    instrument::read();
 
-    // find smallesd prop id that's in open or eval stage
-    // this way we skip all proposals that are definitely already passed or rejected
-    // auto pps_itr = props_by_status.begin();
-    // uint64_t smallest_prop_id = 0;
-    // while (pps_itr != props_by_status.end() && 
-    //   (pps_itr -> status == status_open || pps_itr -> status == status_evaluate) ) {
-    //   smallest_prop_id  = std::min(smallest_prop_id, pps_itr -> id);
-    //   pps_itr++;
-    // }
-
-    // print("smallest id: "+std::to_string(smallest_prop_id));
-      
-    // auto pitr = props.find(smallest_prop_id);
+    while (litr != liveprops.end() && count < batch_size) {
+      auto pitr = props.find(litr->id);
+      instrument::read();
+      count++;
 
-    auto pitr = props.begin();
-    
-    while (pitr != props.end()) {
-      uint64_t prop_id = pitr -> id;
+      if (pitr == props.end()) {
+        litr = liveprops.erase(litr);
+        instrument::erased();
+        instrument::read();
+        continue;
+      }
 
       // active proposals are evaluated
       if (pitr->stage == stage_active) {
@@ -322,6 +348,7 @@ void proposals::onperiod() {
           auto citr = cyclestats.find(current_cycle);
           uint64_t quorum_votes_needed = citr != cyclestats.end() ? citr->quorum_votes_needed : 0;
           valid_quorum = votes_in_favor >= quorum_votes_needed;
+          instrument::read();
         }
 
         if (passed && valid_quorum) {
@@ -349,8 +376,7 @@ void proposals::onperiod() {
               proposal.status = status_evaluate;
               proposal.current_payout += payout_amount;
             });
-
-            eval_props.push_back(prop_id);
+            instrument::modified();
 
           } else {
             
@@ -372,11 +398,10 @@ void proposals::onperiod() {
                 proposal.executed = true;
                 proposal.status = status_passed;
                 proposal.stage = stage_done;
-              } else {
-                eval_props.push_back(prop_id);
               }
               proposal.current_payout += payout_amount;
             });
+            instrument::modified();
           }
 
         } else {
@@ -393,6 +418,7 @@ void proposals::onperiod() {
               proposal.status = status_rejected;
               proposal.stage = stage_done;
           });
+          instrument::modified();
         }
 
         size_change(prop_active_size, -1);
@@ -404,27 +430,75 @@ void proposals::onperiod() {
         props.modify(pitr, _self, [&](auto& proposal) {
           proposal.stage = stage_active;
         });
+        instrument::modified();
         size_change(prop_active_size, 1);
-        active_props.push_back(prop_id);
       }
 
-      pitr++;
-    } 
+      if (pitr->stage == stage_done) {
+        litr = liveprops.erase(litr);
+        instrument::erased();
+      } else {
+        litr++;
+      }
+      instrument::read();
+    }
+
+    jobs::chunk(get_self(), "onperiod"_n, count);
+
+    if (litr != liveprops.end()) {
+      action next_execution(
+        permission_level{get_self(), "active"_n},
+        get_self(),
+        "evalprops"_n,
+        std::make_tuple(litr->id, active_proposals)
+      );
+
+      transaction tx;
+      tx.actions.emplace_back(next_execution);
+      tx.delay_sec = 1;
+      tx.send("evalprops"_n.value, _self, true);
+      instrument::sent_deferred();
+    } else {
+      finish_period(active_proposals);
+    }
+
+    instrument::end(get_self());
+}
+
+// after the last chunk every live proposal is either newly active and open, or active and in evaluation
+void proposals::finish_period(uint64_t active_proposals) {
+    std::vector<uint64_t> active_props;
+    std::vector<uint64_t> eval_props;
+
+    for (auto litr = liveprops.begin(); litr != liveprops.end(); litr++) {
+      auto pitr = props.find(litr->id);
+      instrument::read(2);
+      if (pitr == props.end() || pitr->stage != stage_active) continue;
+
+      if (pitr->status == status_evaluate) {
+        eval_props.push_back(pitr->id);
+      } else {
+        active_props.push_back(pitr->id);
+      }
+    }
 
     update_cycle();
     update_cycle_stats(active_props, eval_props);
+
     updatevoices();
     
-    transaction trx_erase_participants{};
-    trx_erase_participants.actions.emplace_back(
+    // delegators are credited for their delegatees' votes first, erasepartpts follows
+    transaction trx_credit_delegators{};
+    trx_credit_delegators.actions.emplace_back(
       permission_level(_self, "active"_n),
       _self,
-      "erasepartpts"_n,
-      std::make_tuple(number_active_proposals)
+      "creditdelegs"_n,
+      std::make_tuple(get_self(), uint64_t(0), active_proposals)
     );
-    // I don't know how long delay I should use
-    // trx_erase_participants.delay_sec = 5;
-    trx_erase_participants.send(eosio::current_time_point().sec_since_epoch(), _self);
+    trx_credit_delegators.send(eosio::current_time_point().sec_since_epoch(), _self);
+    instrument::sent_deferred();
+
+    jobs::finish(get_self(), "onperiod"_n);
 }
 
 void proposals::testperiod() {
@@ -507,6 +581,7 @@ void proposals::testperiod() {
 }
 void proposals::updatevoices() {
   require_auth(get_self());
+  jobs::start(get_self(), "updatevoices"_n);
   updatevoice((uint64_t)0);
 }
 
@@ -519,9 +594,11 @@ void proposals::updatevoice(uint64_t start) {
   uint64_t cutoff_date = active_cutoff_date();
 
   cs_points_tables cspoints(contracts::harvest, contracts::harvest.value);
+  ranking::published cs_ranks(contracts::harvest, "rankcs"_n, contracts::harvest);
   voice_tables voice_alliance(get_self(), alliance_type.value);
 
   auto vitr = start == 0 ? voice.begin() : voice.find(start);
+  instrument::read();
 
   if (start == 0) {
       size_set(cycle_vote_power_size, 0);
@@ -535,9 +612,10 @@ void proposals::updatevoice(uint64_t start) {
   
   while (vitr != voice.end() && count < batch_size) {
       auto csitr = cspoints.find(vitr->account.value);
+      instrument::read();
       uint64_t points = 0;
       if (csitr != cspoints.end()) {
-        points = csitr -> rank;
+        points = cs_ranks.rank(csitr->account.value, csitr->rank);
       }
 
       set_voice(vitr -> account, points, ""_n);
@@ -548,12 +626,15 @@ void proposals::updatevoice(uint64_t start) {
       }
 
       vitr++;
+      instrument::read();
       count++;
   }
-  
+
   size_change(cycle_vote_power_size, vote_power);
   size_change(user_active_size, active_users);
 
+  jobs::chunk(get_self(), "updatevoices"_n, count);
+
   if (vitr != voice.end()) {
     uint64_t next_value = vitr->account.value;
     action next_execution(
@@ -567,6 +648,9 @@ void proposals::updatevoice(uint64_t start) {
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
     tx.send(next_value, _self);
+    instrument::sent_deferred();
+  } else {
+    jobs::finish(get_self(), "updatevoices"_n);
   }
 }
 
@@ -596,6 +680,7 @@ void proposals::decayvoices() {
     c.t_voicedecay = now;
     cycle.set(c, get_self());
     uint64_t batch_size = config_get(name("batchsize"));
+    jobs::start(get_self(), "decayvoices"_n);
     decayvoice(0, batch_size);
   }
 }
@@ -615,20 +700,26 @@ void proposals::decayvoice(uint64_t start, uint64_t chunksize) {
   while (vitr != voice.end() && count < chunksize) {
     auto vaitr = voice_alliance.find(vitr -> account.value);
 
+    uint64_t old_balance = vitr -> balance;
     voice.modify(vitr, _self, [&](auto & v){
       v.balance *= multiplier;
     });
+    change_delegated_voice(vitr -> account, get_self(), old_balance, vitr -> balance);
 
     if (vaitr != voice_alliance.end()) {
+      uint64_t old_alliance_balance = vaitr -> balance;
       voice_alliance.modify(vaitr, _self, [&](auto & va){
         va.balance *= multiplier;
       });
+      change_delegated_voice(vaitr -> account, alliance_type, old_alliance_balance, vaitr -> balance);
     }
 
     vitr++;
     count++;
   }
 
+  jobs::chunk(get_self(), "decayvoices"_n, count);
+
   if (vitr != voice.end()) {
     uint64_t next_value = vitr->account.value;
     action next_execution(
@@ -642,6 +733,8 @@ void proposals::decayvoice(uint64_t start, uint64_t chunksize) {
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
     tx.send(next_value, _self);
+  } else {
+    jobs::finish(get_self(), "decayvoices"_n);
   }
 }
 
@@ -661,6 +754,7 @@ void proposals::migratevoice(uint64_t start) {
         voice.account = vitr -> account;
         voice.balance = vitr -> balance;
       });
+      change_delegated_voice(vitr -> account, alliance_type, 0, vitr -> balance);
     }
     vitr++;
     count++;
@@ -684,13 +778,16 @@ void proposals::migratevoice(uint64_t start) {
 
 void proposals::update_cycle() {
     cycle_table c = cycle.get_or_create(get_self(), cycle_table());
+    instrument::read();
     c.propcycle += 1;
     c.t_onperiod = current_time_point().sec_since_epoch();
     cycle.set(c, get_self());
+    instrument::modified();
 }
 
 void proposals::update_cycle_stats (std::vector<uint64_t>active_props, std::vector<uint64_t> eval_props) {
   cycle_table c = cycle.get();
+  instrument::read();
 
   uint64_t quorum_vote_base = calc_quorum_base(c.propcycle - 1);
   uint64_t num_proposals = active_props.size();
@@ -711,6 +808,7 @@ void proposals::update_cycle_stats (std::vector<uint64_t>active_props, std::vect
     item.active_props.assign(active_props.begin(), active_props.end());
     item.eval_props.assign(eval_props.begin(), eval_props.end());
   });
+  instrument::emplaced();
 
 }
 
@@ -796,6 +894,10 @@ void proposals::createx(
       proposal.current_payout = asset(0, seeds_symbol);
   });
 
+  liveprops.emplace(_self, [&](auto& item) {
+    item.id = propKey;
+  });
+
   auto litr = lastprops.find(creator.value);
   if (litr == lastprops.end()) {
     lastprops.emplace(_self, [&](auto& proposal) {
@@ -863,6 +965,11 @@ void proposals::cancel(uint64_t id) {
 
   props.erase(pitr);
 
+  auto litr = liveprops.find(id);
+  if (litr != liveprops.end()) {
+    liveprops.erase(litr);
+  }
+
 }
 
 void proposals::stake(name from, name to, asset quantity, string memo) {
@@ -933,6 +1040,78 @@ void proposals::erasepartpts(uint64_t active_proposals) {
   }
 }
 
+// gives every delegator whose chain voted in the cycle the participant entry, reputation and activity
+// it would have got voting itself, one voice scope after the other, then erases the participants
+void proposals::creditdelegs(name scope, uint64_t start, uint64_t active_proposals) {
+  require_auth(get_self());
+  check_voice_scope(scope);
+
+  uint64_t batch_size = config_get(name("batchsize"));
+  uint64_t rep = config_get(name("voterep2.ind")) * (config_get(name("votedel.mul")) / 100.0);
+
+  delegate_trust_tables deltrusts(get_self(), scope.value);
+
+  uint64_t count = 0;
+  auto ditr = start == 0 ? deltrusts.begin() : deltrusts.lower_bound(start);
+  while (ditr != deltrusts.end() && count < batch_size) {
+    credit_delegator(ditr -> delegator, chain_top(ditr -> delegator, scope), rep);
+    ditr++;
+    count++;
+  }
+
+  transaction tx;
+  if (ditr != deltrusts.end()) {
+    tx.actions.emplace_back(permission_level(_self, "active"_n), _self, "creditdelegs"_n,
+      std::make_tuple(scope, ditr -> delegator.value, active_proposals));
+  } else if (scope == get_self()) {
+    tx.actions.emplace_back(permission_level(_self, "active"_n), _self, "creditdelegs"_n,
+      std::make_tuple(alliance_type, uint64_t(0), active_proposals));
+  } else {
+    tx.actions.emplace_back(permission_level(_self, "active"_n), _self, "erasepartpts"_n,
+      std::make_tuple(active_proposals));
+  }
+  tx.delay_sec = 1;
+  tx.send(eosio::current_time_point().sec_since_epoch(), _self);
+  instrument::sent_deferred();
+}
+
+void proposals::credit_delegator(name delegator, name top, uint64_t rep) {
+  auto titr = participants.find(top.value);
+  instrument::read();
+  if (titr == participants.end()) return;
+
+  // only citizens vote, as they had to when their delegatee's votes were cast for them
+  auto uitr = users.find(delegator.value);
+  instrument::read();
+  if (uitr == users.end() || uitr -> status != name("citizen")) return;
+
+  auto paitr = participants.find(delegator.value);
+  instrument::read();
+  if (paitr == participants.end()) {
+    action(
+      permission_level{contracts::accounts, "active"_n},
+      contracts::accounts, "addrep"_n,
+      std::make_tuple(delegator, rep)
+    ).send();
+    instrument::sent_inline();
+    participants.emplace(_self, [&](auto & participant){
+      participant.account = delegator;
+      participant.nonneutral = titr -> nonneutral;
+      participant.count = titr -> count;
+    });
+    instrument::emplaced();
+  } else if (paitr -> count < titr -> count || (titr -> nonneutral && !paitr -> nonneutral)) {
+    // a delegator that also voted itself is counted for whichever took part in more proposals
+    participants.modify(paitr, _self, [&](auto & participant){
+      participant.count = std::max(participant.count, titr -> count);
+      participant.nonneutral = participant.nonneutral || titr -> nonneutral;
+    });
+    instrument::modified();
+  }
+
+  set_active(delegator);
+}
+
 bool proposals::revert_vote (name voter, uint64_t id) {
   auto pitr = props.find(id);
   
@@ -957,7 +1136,7 @@ bool proposals::revert_vote (name voter, uint64_t id) {
   return false;
 }
 
-void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option, bool is_new, bool is_delegated) {
+void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option, bool is_new) {
   check_citizen(voter);
 
   auto pitr = props.find(id);
@@ -977,18 +1156,6 @@ void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option,
   
   check(option == trust || option == distrust || option == abstain, "Invalid option");
 
-  if (option == trust) {
-    props.modify(pitr, _self, [&](auto& proposal) {
-      proposal.total += amount;
-      proposal.favour += amount;
-    });
-  } else if (option == distrust) {
-    props.modify(pitr, _self, [&](auto& proposal) {
-      proposal.total += amount;
-      proposal.against += amount;
-    });
-  }
-
   name scope;
   name fund_type = get_type(pitr -> fund);
   if (fund_type == alliance_type) {
@@ -997,11 +1164,33 @@ void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option,
     scope = get_self();
   }
 
+  // a delegator voting itself first pays for what its delegatees spent of its voice, then
+  // takes the rest back out of their vote on this proposal
+  if (is_trust_delegated(voter, scope)) {
+    charge_delegated(voter, scope);
+    override_delegatee(voter, scope, id, amount);
+  }
+
   double percenetage_used = voice_change(voter, amount, true, scope);
+
+  // the voice delegated to the voter is cast along with its own, in the same share
+  uint64_t weight = amount + spend_delegated(voter, scope, percenetage_used, id);
+
+  if (option == trust) {
+    props.modify(pitr, _self, [&](auto& proposal) {
+      proposal.total += weight;
+      proposal.favour += weight;
+    });
+  } else if (option == distrust) {
+    props.modify(pitr, _self, [&](auto& proposal) {
+      proposal.total += weight;
+      proposal.against += weight;
+    });
+  }
   
   votes.emplace(_self, [&](auto& vote) {
     vote.account = voter;
-    vote.amount = amount;
+    vote.amount = weight;
     if (option == trust) {
       vote.favour = true;
     } else if (option == distrust) {
@@ -1010,22 +1199,15 @@ void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option,
     vote.proposal_id = id;
   });
 
-  if (!is_delegated) {
-    check(!is_trust_delegated(voter, scope), "voice is delegated, user can not vote by itself");
-  }
-
-  send_mimic_delegatee_vote(voter, scope, id, percenetage_used, option);
-
   if (is_new) {
     auto rep = config_get(name("voterep2.ind"));
-    double rep_multiplier = is_delegated ? config_get(name("votedel.mul")) / 100.0 : 1.0;
     auto paitr = participants.find(voter.value);
     if (paitr == participants.end()) {
       // add reputation for entering in the table
       action(
         permission_level{contracts::accounts, "active"_n},
         contracts::accounts, "addrep"_n,
-        std::make_tuple(voter, uint64_t(rep * rep_multiplier))
+        std::make_tuple(voter, uint64_t(rep))
       ).send();
       // add the voter to the table
       participants.emplace(_self, [&](auto & participant){
@@ -1047,47 +1229,45 @@ void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option,
     }
   }
 
-  auto aitr = actives.find(voter.value);
+  set_active(voter);
+
+  add_voted_proposal(pitr->id); // this should happen in onperiod, when status is set to open / active
+  increase_voice_cast(voter, weight, option);
+
+}
+
+void proposals::set_active(name account) {
+  auto aitr = actives.find(account.value);
+  instrument::read();
   if (aitr == actives.end()) {
     actives.emplace(_self, [&](auto& item) {
-      item.account = voter;
+      item.account = account;
       item.timestamp = current_time_point().sec_since_epoch();
     });
+    instrument::emplaced();
     size_change(user_active_size, 1);
   } else {
     actives.modify(aitr, _self, [&](auto & item){
       item.timestamp = current_time_point().sec_since_epoch();
     });
+    instrument::modified();
   }
-
-  add_voted_proposal(pitr->id); // this should happen in onperiod, when status is set to open / active
-  increase_voice_cast(voter, amount, option);
-
 }
 
 void proposals::favour(name voter, uint64_t id, uint64_t amount) {
   require_auth(voter);
-  vote_aux(voter, id, amount, trust, true, false);
+  vote_aux(voter, id, amount, trust, true);
 }
 
 void proposals::against(name voter, uint64_t id, uint64_t amount) {
   require_auth(voter);
   bool vote_reverted = revert_vote(voter, id);
-  vote_aux(voter, id, amount, distrust, !vote_reverted, false);
+  vote_aux(voter, id, amount, distrust, !vote_reverted);
 }
 
 void proposals::neutral(name voter, uint64_t id) {
   require_auth(voter);
-  vote_aux(voter, id, (uint64_t)0, abstain, true, false);
-}
-
-void proposals::voteonbehalf(name voter, uint64_t id, uint64_t amount, name option) {
-  require_auth(get_self());
-  bool is_new = true;
-  if (option == distrust) {
-    is_new = !(revert_vote(voter, id));
-  }
-  vote_aux(voter, id, amount, option, is_new, true);
+  vote_aux(voter, id, (uint64_t)0, abstain, true);
 }
 
 void proposals::addvoice(name user, uint64_t amount) {
@@ -1120,6 +1300,8 @@ double proposals::voice_change (name user, uint64_t amount, bool reduce, name sc
         check(amount <= vitr -> balance && amount <= vaitr -> balance, "voice balance exceeded");
         percentage_used = amount / double(vitr -> balance);
       }
+      uint64_t old_balance = vitr -> balance;
+      uint64_t old_alliance_balance = vaitr -> balance;
       voice.modify(vitr, _self, [&](auto& voice) {
         if (reduce) {
           voice.balance -= amount;
@@ -1134,6 +1316,8 @@ double proposals::voice_change (name user, uint64_t amount, bool reduce, name sc
           voice.balance += amount;
         }
       });
+      change_delegated_voice(user, get_self(), old_balance, vitr -> balance);
+      change_delegated_voice(user, alliance_type, old_alliance_balance, vaitr -> balance);
     }
   } else {
     check_voice_scope(scope);
@@ -1146,6 +1330,7 @@ double proposals::voice_change (name user, uint64_t amount, bool reduce, name sc
       check(amount <= vitr -> balance, "voice balance exceeded");
       percentage_used = amount / double(vitr -> balance);
     }
+    uint64_t old_balance = vitr -> balance;
     voices.modify(vitr, _self, [&](auto & voice){
       if (reduce) {
         voice.balance -= amount;
@@ -1153,6 +1338,7 @@ double proposals::voice_change (name user, uint64_t amount, bool reduce, name sc
         voice.balance += amount;
       }
     });
+    change_delegated_voice(user, scope, old_balance, vitr -> balance);
   }
   return percentage_used;
 }
@@ -1163,17 +1349,23 @@ void proposals::set_voice (name user, uint64_t amount, name scope) {
 
     auto vitr = voice.find(user.value);
     auto vaitr = voice_alliance.find(user.value);
+    instrument::read(2);
+
+    uint64_t old_balance = vitr == voice.end() ? 0 : vitr -> balance;
+    uint64_t old_alliance_balance = vaitr == voice_alliance.end() ? 0 : vaitr -> balance;
 
     if (vitr == voice.end()) {
         voice.emplace(_self, [&](auto& voice) {
             voice.account = user;
             voice.balance = amount;
         });
+        instrument::emplaced();
         size_change("voice.sz"_n, 1);
     } else {
       voice.modify(vitr, _self, [&](auto& voice) {
         voice.balance = amount;
       });
+      instrument::modified();
     }
 
     if (vaitr == voice.end()) {
@@ -1181,22 +1373,31 @@ void proposals::set_voice (name user, uint64_t amount, name scope) {
         voice.account = user;
         voice.balance = amount;
       });
+      instrument::emplaced();
     } else {
       voice_alliance.modify(vaitr, _self, [&](auto & voice){
         voice.balance = amount;
       });
+      instrument::modified();
     }
 
+    change_delegated_voice(user, get_self(), old_balance, amount);
+    change_delegated_voice(user, alliance_type, old_alliance_balance, amount);
+
   } else {
     check_voice_scope(scope);
     
     voice_tables voices(get_self(), scope.value);
     auto vitr = voices.find(user.value);
+    instrument::read();
     check(vitr != voices.end(), "user does not have a voice entry");
 
+    uint64_t old_balance = vitr -> balance;
     voices.modify(vitr, _self, [&](auto & voice){
       voice.balance = amount;
     });
+    instrument::modified();
+    change_delegated_voice(user, scope, old_balance, amount);
   }
 }
 
@@ -1208,6 +1409,9 @@ void proposals::erase_voice (name user) {
   auto vitr = voice.find(user.value);
   auto vaitr = voice_alliance.find(user.value);
 
+  change_delegated_voice(user, get_self(), vitr -> balance, 0);
+  change_delegated_voice(user, alliance_type, vaitr -> balance, 0);
+
   voice.erase(vitr);
   voice_alliance.erase(vaitr);
 
@@ -1242,6 +1446,7 @@ void proposals::deposit(asset quantity) {
 
   token::transfer_action action{name(token_account), {_self, "active"_n}};
   action.send(_self, name(bank_account), quantity, "");
+  instrument::sent_inline();
 }
 
 void proposals::refund_staked(name beneficiary, asset quantity) {
@@ -1256,6 +1461,7 @@ void proposals::change_rep(name beneficiary, bool passed) {
       contracts::accounts, "addrep"_n,
       std::make_tuple(beneficiary, reward_points)
     ).send();
+    instrument::sent_inline();
 
   }
 
@@ -1268,6 +1474,7 @@ void proposals::send_to_escrow(name fromfund, name recipient, asset quantity, st
     contracts::token, "transfer"_n,
     std::make_tuple(fromfund, contracts::escrow, quantity, memo))
   .send();
+  instrument::sent_inline();
 
   action(
       permission_level{fromfund, "active"_n},
@@ -1282,6 +1489,7 @@ void proposals::send_to_escrow(name fromfund, name recipient, asset quantity, st
                                   current_time_point().time_since_epoch()),  // long time from now
                       memo))
   .send();
+  instrument::sent_inline();
 
 }
 
@@ -1295,6 +1503,7 @@ void proposals::withdraw(name beneficiary, asset quantity, name sender, string m
 
   token::transfer_action action{name(token_account), {sender, "active"_n}};
   action.send(sender, beneficiary, quantity, memo);
+  instrument::sent_inline();
 }
 
 void proposals::burn(asset quantity)
@@ -1306,6 +1515,7 @@ void proposals::burn(asset quantity)
 
   token::burn_action action{name(token_account), {name(bank_account), "active"_n}};
   action.send(name(bank_account), quantity);
+  instrument::sent_inline();
 }
 
 void proposals::check_user(name account)
@@ -1385,12 +1595,14 @@ void proposals::size_change(name id, int64_t delta) {
   size_tables sizes(get_self(), get_self().value);
 
   auto sitr = sizes.find(id.value);
+  instrument::read();
   if (sitr == sizes.end()) {
     check(delta >= 0, "can't add negagtive size");
     sizes.emplace(_self, [&](auto& item) {
       item.id = id;
       item.size = delta;
     });
+    instrument::emplaced();
   } else {
     uint64_t newsize = sitr->size + delta; 
     if (delta < 0) {
@@ -1401,6 +1613,7 @@ void proposals::size_change(name id, int64_t delta) {
     sizes.modify(sitr, _self, [&](auto& item) {
       item.size = newsize;
     });
+    instrument::modified();
   }
 }
 
@@ -1408,15 +1621,18 @@ void proposals::size_set(name id, int64_t value) {
   size_tables sizes(get_self(), get_self().value);
 
   auto sitr = sizes.find(id.value);
+  instrument::read();
   if (sitr == sizes.end()) {
     sizes.emplace(_self, [&](auto& item) {
       item.id = id;
       item.size = value;
     });
+    instrument::emplaced();
   } else {
     sizes.modify(sitr, _self, [&](auto& item) {
       item.size = value;
     });
+    instrument::modified();
   }
 }
 
@@ -1514,6 +1730,7 @@ ACTION proposals::delegate (name delegator, name delegatee, name scope) {
   check(has_no_cycles, "can not add delegatee, cycles are not allowed");
 
   if (ditr != deltrusts.end()) {
+    leave_delegatee(delegator, scope);
     deltrusts.modify(ditr, _self, [&](auto & item){
       item.delegatee = delegatee;
       item.weight = 1.0;
@@ -1528,93 +1745,314 @@ ACTION proposals::delegate (name delegator, name delegatee, name scope) {
     });
   }
 
-}
+  // the delegator brings its own voice and everything delegated to it,
+  // read again as leave_delegatee may have charged it
+  voice_tables voices(get_self(), scope.value);
+  delegated_voice_tables delvoice(get_self(), scope.value);
+  auto dvitr = delvoice.find(delegator.value);
+  uint64_t subtree = dvitr != delvoice.end() ? dvitr -> voice : 0;
+  change_delegated(delegator, scope, int64_t(voices.get(delegator.value).balance + subtree));
+
+  // the chain's votes so far this cycle did not spend the delegator's voice, charge_delegated charges the rest
+  uint64_t current_cycle = cycle.get_or_create(get_self(), cycle_table()).propcycle;
+  double joined_used = delegated_used(delegator, scope);
+  if (dvitr == delvoice.end()) {
+    delvoice.emplace(_self, [&](auto & item){
+      item.delegatee = delegator;
+      item.voice = 0;
+      item.used = 0.0;
+      item.cycle = 0;
+      item.joined_used = joined_used;
+      item.joined_cycle = current_cycle;
+    });
+  } else {
+    delvoice.modify(dvitr, _self, [&](auto & item){
+      item.joined_used = joined_used;
+      item.joined_cycle = current_cycle;
+    });
+  }
 
-void proposals::send_vote_on_behalf (name voter, uint64_t id, uint64_t amount, name option) {
-  action vote_on_behalf_action(
-    permission_level{get_self(), "active"_n},
-    get_self(),
-    "voteonbehalf"_n,
-    std::make_tuple(voter, id, amount, option)
-  );
-  transaction tx;
-  tx.actions.emplace_back(vote_on_behalf_action);
-  // tx.delay_sec = 1;
-  tx.send(voter.value, _self);
 }
 
-void proposals::send_mimic_delegatee_vote (name delegatee, name scope, uint64_t proposal_id, double percentage_used, name option) {
+void proposals::change_delegated_voice (name user, name scope, uint64_t old_balance, uint64_t new_balance) {
+  if (old_balance != new_balance) {
+    change_delegated(user, scope, int64_t(new_balance) - int64_t(old_balance));
+  }
+}
 
-  uint64_t batch_size = config_get("batchsize"_n);
+// adds delta to the delegated voice of everyone up the delegator's chain
+void proposals::change_delegated (name delegator, name scope, int64_t delta) {
+  if (delta == 0) return;
 
   delegate_trust_tables deltrusts(get_self(), scope.value);
-  auto deltrusts_by_delegatee_delegator = deltrusts.get_index<"byddelegator"_n>();
+  auto ditr = deltrusts.find(delegator.value);
+  instrument::read();
+  if (ditr == deltrusts.end()) return;
 
-  uint128_t id = uint128_t(delegatee.value) << 64;
-  auto ditr = deltrusts_by_delegatee_delegator.lower_bound(id);
+  delegated_voice_tables delvoice(get_self(), scope.value);
+  uint64_t max_depth = config_get("dlegate.dpth"_n);
 
-  if (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee) {
-    action mimic_action(
-      permission_level{get_self(), "active"_n},
-      get_self(),
-      "mimicvote"_n,
-      std::make_tuple(delegatee, ditr -> delegator, scope, proposal_id, percentage_used, option, batch_size)
-    );
+  for (uint64_t depth = 0; ditr != deltrusts.end() && depth < max_depth; depth++) {
+    name delegatee = ditr -> delegatee;
+
+    auto dvitr = delvoice.find(delegatee.value);
+    instrument::read();
+    if (dvitr == delvoice.end()) {
+      delvoice.emplace(_self, [&](auto & item){
+        item.delegatee = delegatee;
+        item.voice = delta > 0 ? uint64_t(delta) : 0;
+        item.used = 0.0;
+        item.cycle = 0;
+        item.joined_used = 0.0;
+        item.joined_cycle = 0;
+      });
+      instrument::emplaced();
+    } else {
+      delvoice.modify(dvitr, _self, [&](auto & item){
+        item.voice = delta < 0 && uint64_t(-delta) > item.voice ? 0 : item.voice + delta;
+      });
+      instrument::modified();
+    }
 
-    transaction tx;
-    tx.actions.emplace_back(mimic_action);
-    tx.delay_sec = 1;
-    tx.send(delegatee.value + 1, _self);
+    ditr = deltrusts.find(delegatee.value);
+    instrument::read();
   }
-
 }
 
-ACTION proposals::mimicvote (name delegatee, name delegator, name scope, uint64_t proposal_id, double percentage_used, name option, uint64_t chunksize) {
+// spends percentage_used of the voice delegated to delegatee, less the delegators that voted proposal id
+// themselves, records it in the proposal's delvotes and returns the amount spent
+uint64_t proposals::spend_delegated (name delegatee, name scope, double percentage_used, uint64_t id) {
+  delegated_vote_tables delvotes(get_self(), id);
+  auto dvotitr = delvotes.find(delegatee.value);
+  instrument::read();
 
-  require_auth(get_self());
+  uint64_t voice = 0;
+  uint64_t amount = 0;
+
+  delegated_voice_tables delvoice(get_self(), scope.value);
+  auto dvitr = delvoice.find(delegatee.value);
+  instrument::read();
+  if (percentage_used > 0 && dvitr != delvoice.end() && dvitr -> voice > 0) {
+    // override_delegatee keeps the voice of the delegators that voted themselves in the delegatee's row
+    uint64_t overridden = dvotitr != delvotes.end() ? dvotitr -> overridden : 0;
+    voice = overridden < dvitr -> voice ? dvitr -> voice - overridden : 0;
+
+    uint64_t current_cycle = cycle.get_or_create(get_self(), cycle_table()).propcycle;
+    double used = dvitr -> cycle == current_cycle ? dvitr -> used : 0.0;
+    amount = voice * (1.0 - used) * percentage_used;
+
+    // used stays the share of all the delegated voice spent, overridden voice was not
+    delvoice.modify(dvitr, _self, [&](auto & item){
+      item.used = used + (1.0 - used) * percentage_used * (voice / double(dvitr -> voice));
+      item.cycle = current_cycle;
+    });
+    instrument::modified();
+  }
 
+  if (dvotitr != delvotes.end()) {
+    delvotes.modify(dvotitr, _self, [&](auto & item){
+      item.voice = voice;
+      item.amount = amount;
+    });
+    instrument::modified();
+  } else if (amount > 0) {
+    delvotes.emplace(_self, [&](auto & item){
+      item.account = delegatee;
+      item.voice = voice;
+      item.amount = amount;
+      item.overridden = 0;
+    });
+    instrument::emplaced();
+  }
+
+  return amount;
+}
+
+// the account its delegation chain ends at
+name proposals::chain_top (name account, name scope) {
   delegate_trust_tables deltrusts(get_self(), scope.value);
-  auto deltrusts_by_delegatee_delegator = deltrusts.get_index<"byddelegator"_n>();
+  uint64_t max_depth = config_get("dlegate.dpth"_n);
+
+  name top = account;
+  auto ditr = deltrusts.find(account.value);
+  instrument::read();
+  for (uint64_t depth = 0; ditr != deltrusts.end() && depth < max_depth; depth++) {
+    top = ditr -> delegatee;
+    ditr = deltrusts.find(top.value);
+    instrument::read();
+  }
+  return top;
+}
+
+// keeps the delegator's voice out of its delegatees' vote on proposal id, amount is the voice it votes with.
+// What is left of its voice after the vote is added to the overridden voice of its delegatees up to the
+// first that voted, and if one did, the delegator's share of that vote's delegated weight is taken off.
+void proposals::override_delegatee (name delegator, name scope, uint64_t id, uint64_t amount) {
+  vote_override_tables overrides(get_self(), id);
+  instrument::read();
+  if (overrides.find(delegator.value) != overrides.end()) return;
 
-  check_voice_scope(scope);
   voice_tables voices(get_self(), scope.value);
+  delegated_voice_tables delvoice(get_self(), scope.value);
+  delegated_vote_tables delvotes(get_self(), id);
+  auto vitr = voices.find(delegator.value);
+  auto dvitr = delvoice.find(delegator.value);
+  auto ownitr = delvotes.find(delegator.value);
+  instrument::read(3);
+
+  // delegators below that voted themselves were already kept out further up
+  uint64_t voice = (vitr != voices.end() ? vitr -> balance : 0) + (dvitr != delvoice.end() ? dvitr -> voice : 0);
+  uint64_t overridden = ownitr != delvotes.end() ? ownitr -> overridden : 0;
+  uint64_t taken = overridden < voice ? voice - overridden : 0;
+  uint64_t kept_out = amount < taken ? taken - amount : 0;
+
+  overrides.emplace(_self, [&](auto & item){
+    item.account = delegator;
+  });
+  instrument::emplaced();
 
-  uint128_t id = (uint128_t(delegatee.value) << 64) + delegator.value;
+  delegate_trust_tables deltrusts(get_self(), scope.value);
+  votes_tables votes(get_self(), id);
+  uint64_t max_depth = config_get("dlegate.dpth"_n);
 
-  auto ditr = deltrusts_by_delegatee_delegator.find(id);
-  uint64_t count = 0;
+  name delegatee;
+  auto ditr = deltrusts.find(delegator.value);
+  instrument::read();
+  for (uint64_t depth = 0; ditr != deltrusts.end() && depth < max_depth; depth++) {
+    name current = ditr -> delegatee;
+
+    if (kept_out > 0) {
+      auto cdvotitr = delvotes.find(current.value);
+      instrument::read();
+      if (cdvotitr == delvotes.end()) {
+        delvotes.emplace(_self, [&](auto & item){
+          item.account = current;
+          item.voice = 0;
+          item.amount = 0;
+          item.overridden = kept_out;
+        });
+        instrument::emplaced();
+      } else {
+        delvotes.modify(cdvotitr, _self, [&](auto & item){
+          item.overridden += kept_out;
+        });
+        instrument::modified();
+      }
+    }
 
-  while (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee && count < chunksize) {
+    instrument::read();
+    if (votes.find(current.value) != votes.end()) {
+      delegatee = current;
+      break;
+    }
+    ditr = deltrusts.find(current.value);
+    instrument::read();
+  }
 
-    name voter = ditr -> delegator;
+  if (delegatee == name()) return;
 
-    auto vitr = voices.find(voter.value);
-    if (option == trust) {
-      send_vote_on_behalf(voter, proposal_id, vitr -> balance * percentage_used, trust);
-    } else if (option == distrust) {
-      send_vote_on_behalf(voter, proposal_id, vitr -> balance * percentage_used, distrust);
-    } else if (option == abstain) {
-      send_vote_on_behalf(voter, proposal_id, uint64_t(0), abstain);
+  auto dvotitr = delvotes.find(delegatee.value);
+  instrument::read();
+  if (dvotitr == delvotes.end() || dvotitr -> voice == 0) return;
+
+  auto voteitr = votes.find(delegatee.value);
+  auto pitr = props.find(id);
+  instrument::read(2);
+
+  taken = std::min(taken, dvotitr -> voice);
+  uint64_t share = std::min(uint64_t(dvotitr -> amount * (taken / double(dvotitr -> voice))), voteitr -> amount);
+
+  delvotes.modify(dvotitr, _self, [&](auto & item){
+    item.voice -= taken;
+    item.amount = share < item.amount ? item.amount - share : 0;
+  });
+  votes.modify(voteitr, _self, [&](auto & vote){
+    vote.amount -= share;
+  });
+  props.modify(pitr, _self, [&](auto & proposal){
+    proposal.total -= share;
+    if (voteitr -> favour) {
+      proposal.favour -= share;
+    } else {
+      proposal.against -= share;
     }
+  });
+  instrument::modified(3);
+}
 
-    ditr++;
-    count++;
-  }
+// share of the account's voice spent this cycle by the top of its delegation chain
+double proposals::delegated_used (name account, name scope) {
+  delegated_voice_tables delvoice(get_self(), scope.value);
+  auto dvitr = delvoice.find(chain_top(account, scope).value);
+  instrument::read();
+  uint64_t current_cycle = cycle.get_or_create(get_self(), cycle_table()).propcycle;
 
-  if (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee) {
-    action next_execution(
-      permission_level{get_self(), "active"_n},
-      get_self(),
-      "mimicvote"_n,
-      std::make_tuple(delegatee, ditr -> delegator, scope, proposal_id, percentage_used, option, chunksize)
-    );
+  return dvitr != delvoice.end() && dvitr -> cycle == current_cycle ? dvitr -> used : 0.0;
+}
 
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(delegatee.value + 1, _self);
+// Delegators' voice is not reduced when their delegatee votes, so before a delegator votes itself or
+// leaves its chain it is charged what the chain spent since it joined or was last charged, and the
+// change goes into its delegatees' aggregate. Its deltrusts row has to still be there.
+void proposals::charge_delegated (name delegator, name scope) {
+  voice_tables voices(get_self(), scope.value);
+  delegated_voice_tables delvoice(get_self(), scope.value);
+
+  auto vitr = voices.find(delegator.value);
+  auto dvitr = delvoice.find(delegator.value);
+  instrument::read(2);
+
+  uint64_t current_cycle = cycle.get_or_create(get_self(), cycle_table()).propcycle;
+  double chain_used = delegated_used(delegator, scope);
+  double joined_used = dvitr != delvoice.end() && dvitr -> joined_cycle == current_cycle ? dvitr -> joined_used : 0.0;
+  double used = chain_used - joined_used;
+
+  if (used > 0 && vitr != voices.end()) {
+    uint64_t old_balance = vitr -> balance;
+    voices.modify(vitr, _self, [&](auto & voice){
+      voice.balance = old_balance * (1.0 - used);
+    });
+    instrument::modified();
+    change_delegated_voice(delegator, scope, old_balance, vitr -> balance);
+  }
+
+  // the voice delegated to the delegator was spent in the same share
+  if (dvitr == delvoice.end()) {
+    delvoice.emplace(_self, [&](auto & item){
+      item.delegatee = delegator;
+      item.voice = 0;
+      item.used = used > 0 ? used : 0.0;
+      item.cycle = current_cycle;
+      item.joined_used = chain_used;
+      item.joined_cycle = current_cycle;
+    });
+    instrument::emplaced();
+  } else {
+    double own_used = dvitr -> cycle == current_cycle ? dvitr -> used : 0.0;
+    delvoice.modify(dvitr, _self, [&](auto & item){
+      if (used > 0) {
+        item.used = own_used + (1.0 - own_used) * used;
+        item.cycle = current_cycle;
+      }
+      item.joined_used = chain_used;
+      item.joined_cycle = current_cycle;
+    });
+    instrument::modified();
   }
+}
+
+// takes the delegator's voice out of its chain, the delegator's deltrusts row has to still be there
+void proposals::leave_delegatee (name delegator, name scope) {
+  charge_delegated(delegator, scope);
 
+  voice_tables voices(get_self(), scope.value);
+  delegated_voice_tables delvoice(get_self(), scope.value);
+  auto vitr = voices.find(delegator.value);
+  auto dvitr = delvoice.find(delegator.value);
+  instrument::read(2);
+
+  uint64_t balance = vitr != voices.end() ? vitr -> balance : 0;
+  uint64_t subtree = dvitr != delvoice.end() ? dvitr -> voice : 0;
+  change_delegated(delegator, scope, -int64_t(balance + subtree));
 }
 
 ACTION proposals::undelegate (name delegator, name scope) {
@@ -1631,6 +2069,7 @@ ACTION proposals::undelegate (name delegator, name scope) {
     require_auth(ditr -> delegatee);
   }
 
+  leave_delegatee(delegator, scope);
   deltrusts.erase(ditr);
 }
 
@@ -1660,6 +2099,7 @@ uint64_t proposals::calc_quorum_base (uint64_t propcycle) {
   uint64_t count = 0;
 
   auto citr = cyclestats.find(propcycle);
+  instrument::read();
 
   if (citr == cyclestats.end()) {
     // in case there is no information for this propcycle
@@ -1676,6 +2116,7 @@ uint64_t proposals::calc_quorum_base (uint64_t propcycle) {
       break;
     } else {
       citr--;
+      instrument::read();
     }
 
   }
@@ -1844,4 +2285,87 @@ void proposals::testpropquor(uint64_t current_cycle, uint64_t prop_id) {
     "valid: " + ( valid_quorum ? "YES " : "NO ") 
   );
 
-}
\ No newline at end of file
+}
+
+// fills liveprops from the proposals that are still staged or active, start 0 rebuilds it from scratch
+void proposals::initlive(uint64_t start) {
+  require_auth(get_self());
+
+  if (start == 0) {
+    auto litr = liveprops.begin();
+    while (litr != liveprops.end()) {
+      litr = liveprops.erase(litr);
+    }
+  }
+
+  uint64_t batch_size = config_get(name("batchsize"));
+  uint64_t count = 0;
+
+  auto pitr = props.lower_bound(start);
+  while (pitr != props.end() && count < batch_size) {
+    if (pitr->stage == stage_staged || pitr->stage == stage_active) {
+      liveprops.emplace(_self, [&](auto& item) {
+        item.id = pitr->id;
+      });
+    }
+    pitr++;
+    count++;
+  }
+
+  if (pitr != props.end()) {
+    uint64_t next_value = pitr->id;
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "initlive"_n,
+      std::make_tuple(next_value)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(next_value, _self);
+  }
+}
+
+// rebuilds the delegated voice of scope from the voice and deltrusts tables, start 0 rebuilds it from scratch
+void proposals::initdelvoice(name scope, uint64_t start) {
+  require_auth(get_self());
+  check_voice_scope(scope);
+
+  delegated_voice_tables delvoice(get_self(), scope.value);
+
+  if (start == 0) {
+    auto dvitr = delvoice.begin();
+    while (dvitr != delvoice.end()) {
+      dvitr = delvoice.erase(dvitr);
+    }
+  }
+
+  voice_tables voices(get_self(), scope.value);
+
+  uint64_t batch_size = config_get(name("batchsize"));
+  uint64_t count = 0;
+
+  auto vitr = voices.lower_bound(start);
+  while (vitr != voices.end() && count < batch_size) {
+    change_delegated(vitr -> account, scope, int64_t(vitr -> balance));
+    vitr++;
+    count++;
+  }
+
+  if (vitr != voices.end()) {
+    uint64_t next_value = vitr -> account.value;
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "initdelvoice"_n,
+      std::make_tuple(scope, next_value)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(scope.value + next_value, _self);
+  }
+}
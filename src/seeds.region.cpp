@@ -188,6 +188,8 @@ ACTION region::join(name region, name account) {
         item.account = account;
     });
     size_change(region, 1);
+    score_vector::send_region(account, region);
+    transfer_profile::send(transfer_profile::region, account, region.value);
 
 }
 
@@ -261,6 +263,8 @@ void region::remove_member(name account) {
     size_change(mitr->region, -1);
 
     members.erase(mitr);
+    score_vector::send_region(account, name());
+    transfer_profile::send(transfer_profile::region, account, 0);
 
 }
 
@@ -294,6 +298,8 @@ ACTION region::removebr(name region) {
 
     auto mitr = rgnmembers.find(region.value);
     while (mitr != rgnmembers.end() && mitr->region.value == region.value) {
+        score_vector::send_region(mitr->account, name());
+        transfer_profile::send(transfer_profile::region, mitr->account, 0);
         mitr = rgnmembers.erase(mitr);
     }
 }
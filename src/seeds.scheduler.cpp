@@ -3,10 +3,12 @@
 #include <eosio/transaction.hpp>
 #include <contracts.hpp>
 #include <string>
+#include <algorithm>
 
 
 bool scheduler::is_ready_to_execute(name operation){
     auto itr = operations.find(operation.value);
+    instrument::read();
 
     if (itr == operations.end()) {
         return false;
@@ -67,6 +69,15 @@ void scheduler::reset_aux(bool destructive) {
         titr = test.erase(titr);
     }
 
+    if (destructive) {
+        instrument::clear(get_self());
+
+        auto sitr = opstate.begin();
+        while(sitr != opstate.end()){
+            sitr = opstate.erase(sitr);
+        }
+    }
+
     std::vector<name> id_v = { 
         name("exch.period"),
         name("tokn.resetw"),
@@ -79,7 +90,8 @@ void scheduler::reset_aux(bool destructive) {
         name("hrvst.ranktx"),
         name("hrvst.rankpl"),
 
-        name("hrvst.calccs"), // after the above 4
+        name("hstry.expire"), // before hrvst.calctx
+        name("hrvst.calccs"), // after the above 6, see reset_deps
         name("hrvst.rankcs"), 
         name("hrvst.rorgcs"),
         name("hrvst.calctx"), // 24h
@@ -112,6 +124,7 @@ void scheduler::reset_aux(bool destructive) {
         name("ranktxs"),
         name("rankplanteds"),
 
+        name("expiretxpts"),
         name("calccss"),
         name("rankcss"),
         name("rankorgcss"),
@@ -145,6 +158,7 @@ void scheduler::reset_aux(bool destructive) {
         contracts::harvest,
         contracts::harvest,
 
+        contracts::history,
         contracts::harvest,
         contracts::harvest,
         contracts::harvest,
@@ -170,14 +184,17 @@ void scheduler::reset_aux(bool destructive) {
         utils::seconds_per_day * 7,
         utils::seconds_per_day * 7,
 
-        utils::seconds_per_hour,
-        utils::seconds_per_hour,
-        utils::seconds_per_hour,
-        utils::seconds_per_hour,
+        // ranks are updated when the ranked value changes, these passes only
+        // catch up the rows whose percentile moved because others changed
+        utils::seconds_per_day,
+        utils::seconds_per_day,
+        utils::seconds_per_day,
+        utils::seconds_per_day,
 
-        utils::seconds_per_hour,
-        utils::seconds_per_hour,
+        utils::seconds_per_day,
+        utils::seconds_per_day,
 
+        utils::seconds_per_day,
         utils::seconds_per_hour,
         utils::seconds_per_hour,
         utils::seconds_per_hour,
@@ -213,11 +230,13 @@ void scheduler::reset_aux(bool destructive) {
         now - utils::seconds_per_hour, 
         now - utils::seconds_per_hour, 
 
-        now + 300 - utils::seconds_per_hour, // kicks off 5 minutes later
-        now + 600 - utils::seconds_per_hour, // kicks off 10 minutes later
-        now + 600 - utils::seconds_per_hour, // kicks off 10 minutes later
+        // the order within the pipeline comes from the dependencies, not from offsets
+        now - utils::seconds_per_hour,
+        now - utils::seconds_per_hour,
+        now - utils::seconds_per_hour,
+        now - utils::seconds_per_hour,
         now,
-        now + 600 - utils::seconds_per_hour, // kicks off 10 minutes later
+        now - utils::seconds_per_hour,
 
         now,
         now,
@@ -231,7 +250,7 @@ void scheduler::reset_aux(bool destructive) {
         now - utils::seconds_per_hour,
 
         now,
-        now + 600 - utils::seconds_per_hour,
+        now - utils::seconds_per_hour,
         now
     };
 
@@ -254,6 +273,72 @@ void scheduler::reset_aux(bool destructive) {
         }
         i++;
     }
+
+    reset_deps();
+}
+
+void scheduler::reset_deps() {
+    std::vector<name> signalling_v = {
+        name("acct.rankrep"),
+        name("acct.rorgrep"),
+        name("acct.rankcbs"),
+        name("acct.rorgcbs"),
+        name("hrvst.ranktx"),
+        name("hrvst.orgtxs"),
+        name("hrvst.rankpl"),
+        name("hstry.expire"),
+        name("hrvst.calctx"),
+        name("hrvst.calccs"),
+        name("hrvst.rankcs"),
+        name("hrvst.rorgcs"),
+        name("hrvst.rgncs"),
+    };
+
+    std::vector<std::pair<name, std::vector<name>>> after_v = {
+        { name("hrvst.calctx"), { name("hstry.expire") } },
+        { name("hrvst.ranktx"), { name("hrvst.calctx") } },
+        { name("hrvst.calccs"), {
+            name("acct.rankrep"), name("acct.rorgrep"), name("acct.rankcbs"), name("acct.rorgcbs"),
+            name("hrvst.ranktx"), name("hrvst.orgtxs"), name("hrvst.rankpl")
+        } },
+        { name("hrvst.rankcs"), { name("hrvst.calccs") } },
+        { name("hrvst.rorgcs"), { name("hrvst.calccs") } },
+        { name("hrvst.rgncs"), { name("hrvst.calccs") } },
+        { name("hrvst.hrvst"), { name("hrvst.rankcs"), name("hrvst.rorgcs"), name("hrvst.rgncs") } },
+    };
+
+    auto set_deps = [&](name id, std::vector<name> after, bool signals) {
+        auto sitr = opstate.find(id.value);
+        if (sitr == opstate.end()) {
+            opstate.emplace(_self, [&](auto & item) {
+                item.id = id;
+                item.after = after;
+                item.signals = signals;
+                item.running = false;
+                item.started_at = 0;
+                item.completed_at = 0;
+            });
+        } else {
+            opstate.modify(sitr, _self, [&](auto & item) {
+                item.after = after;
+                item.signals = signals;
+            });
+        }
+    };
+
+    for (auto & id : signalling_v) {
+        std::vector<name> after;
+        for (auto & entry : after_v) {
+            if (entry.first == id) after = entry.second;
+        }
+        set_deps(id, after, true);
+    }
+
+    for (auto & entry : after_v) {
+        if (std::find(signalling_v.begin(), signalling_v.end(), entry.first) == signalling_v.end()) {
+            set_deps(entry.first, entry.second, false);
+        }
+    }
 }
 
 
@@ -339,6 +424,94 @@ ACTION scheduler::pauseop(name id, uint8_t pause) {
     });
 }
 
+ACTION scheduler::configdeps(name id, std::vector<name> after, bool signals) {
+    require_auth(get_self());
+
+    check(std::find(after.begin(), after.end(), id) == after.end(), "an operation cannot depend on itself");
+
+    auto sitr = opstate.find(id.value);
+    if (sitr == opstate.end()) {
+        opstate.emplace(_self, [&](auto & item) {
+            item.id = id;
+            item.after = after;
+            item.signals = signals;
+            item.running = false;
+            item.started_at = 0;
+            item.completed_at = 0;
+        });
+    } else {
+        opstate.modify(sitr, _self, [&](auto & item) {
+            item.after = after;
+            item.signals = signals;
+            if (!signals) item.running = false;
+        });
+    }
+}
+
+ACTION scheduler::opdone(name contract, name operation) {
+    require_auth(contract);
+
+    uint64_t now = current_time_point().sec_since_epoch();
+
+    for (auto itr = operations.begin(); itr != operations.end(); itr++) {
+        if (itr->contract != contract || itr->operation != operation) continue;
+
+        auto sitr = opstate.find(itr->id.value);
+        if (sitr == opstate.end() || !sitr->running) continue;
+
+        opstate.modify(sitr, _self, [&](auto & item) {
+            item.running = false;
+            item.completed_at = now;
+        });
+    }
+}
+
+bool scheduler::dependencies_done(name operation) {
+    auto sitr = opstate.find(operation.value);
+    instrument::read();
+    if (sitr == opstate.end()) {
+        return true;
+    }
+
+    uint64_t now = current_time_point().sec_since_epoch();
+
+    for (auto & dep : sitr->after) {
+        auto ditr = opstate.find(dep.value);
+        instrument::read();
+
+        // a dependency that is due runs first, unless it already started since this op last did:
+        // one that is due again every tick would otherwise hold this op forever
+        bool ran_since = ditr != opstate.end() && ditr->started_at > sitr->started_at;
+        if (!ran_since && is_ready_to_execute(dep)) return false;
+
+        if (ditr == opstate.end() || !ditr->running) continue;
+
+        // a job that never reports back holds the ops after it for one of its periods at most
+        auto oitr = operations.find(dep.value);
+        instrument::read();
+        if (oitr != operations.end() && now < ditr->started_at + oitr->period) return false;
+    }
+
+    return true;
+}
+
+void scheduler::mark_started(name operation) {
+    auto sitr = opstate.find(operation.value);
+    instrument::read();
+    if (sitr == opstate.end()) {
+        return;
+    }
+
+    uint64_t now = current_time_point().sec_since_epoch();
+
+    opstate.modify(sitr, _self, [&](auto & item) {
+        item.started_at = now;
+        item.running = item.signals;
+        if (!item.signals) item.completed_at = now;
+    });
+    instrument::modified();
+}
+
 ACTION scheduler::confirm(name operation) {
     require_auth(get_self());
 
@@ -389,32 +562,43 @@ ACTION scheduler::execute() {
 
     cancel_deferred(contracts::scheduler.value);
 
+    instrument::begin("execute"_n);
+
     // =======================
     // execute operations
     // =======================
 
+    // every ready op whose dependencies are done is sent off in this tick, up to the budget
+    auto citr = config.find(ops_per_tick.value);
+    uint64_t budget = citr != config.end() && citr->value > 0 ? citr->value : 1;
+    instrument::read();
+
     auto ops_by_last_executed = operations.get_index<"bytimestamp"_n>();
     auto itr = ops_by_last_executed.begin();
+    instrument::read();
     bool has_executed = false;
+    uint64_t executed = 0;
 
-    while(itr != ops_by_last_executed.end()) {
-        if(is_ready_to_execute(itr -> id)){
+    while(itr != ops_by_last_executed.end() && executed < budget) {
+        if(is_ready_to_execute(itr -> id) && dependencies_done(itr -> id)){
 
             print("\nOperation to be executed: " + itr -> id.to_string());
 
+            mark_started(itr->id);
             exec_op(itr->id, itr->contract, itr->operation);
 
             has_executed = true;
-            
-            break;
+            executed++;
         }
         itr++;
+        instrument::read();
     }
 
     // =======================
     // schedule next execution
     // =======================
 
+    if (!has_executed) instrument::read();
     auto it_s = has_executed ? 1 : config.get(seconds_to_execute.value, (contracts::scheduler.to_string() + ": the parameter " + seconds_to_execute.to_string() + " is not configured in " + contracts::settings.to_string()).c_str()).value;
 
     action next_execution(
@@ -430,7 +614,9 @@ ACTION scheduler::execute() {
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = it_s;
     tx.send(contracts::scheduler.value /*eosio::current_time_point().sec_since_epoch() + 30*/, _self);
-    
+    instrument::sent_deferred();
+
+    instrument::end(get_self());
 
 }
 
@@ -487,6 +673,8 @@ ACTION scheduler::testexec(name op) {
     exec_op(op, operation.contract, operation.operation);
 
 }
+// each op and its confirm run in their own deferred transaction, so an op that fails or runs out
+// of CPU does not take the other ops or the scheduler's next execution down with it
 void scheduler::exec_op(name id, name contract, name operation) {
     
     action a = action(
@@ -496,13 +684,6 @@ void scheduler::exec_op(name id, name contract, name operation) {
         std::make_tuple()
     );
 
-    // transaction txa;
-    // txa.actions.emplace_back(a);
-    // txa.delay_sec = 0;
-    // txa.send(eosio::current_time_point().sec_since_epoch() + 20, _self);
-
-    a.send();
-
     action c = action(
         permission_level{get_self(), "active"_n},
         get_self(),
@@ -510,8 +691,13 @@ void scheduler::exec_op(name id, name contract, name operation) {
         std::make_tuple(id)
     );
 
-    c.send();
+    transaction txa;
+    txa.actions.emplace_back(a);
+    txa.actions.emplace_back(c);
+    txa.delay_sec = 0;
+    txa.send(id.value, _self, true);
+    instrument::sent_deferred();
 }
 
 
-EOSIO_DISPATCH(scheduler,(configop)(execute)(reset)(confirm)(pauseop)(removeop)(stop)(start)(moonphase)(test1)(test2)(testexec)(updateops));
+EOSIO_DISPATCH(scheduler,(configop)(execute)(reset)(confirm)(configdeps)(opdone)(pauseop)(removeop)(stop)(start)(moonphase)(test1)(test2)(testexec)(updateops));
@@ -43,6 +43,7 @@ void settings::reset() {
   confwithdesc(name("hrvstreward"), 100000, "Harvest reward", high_impact);
   confwithdesc(name("mooncyclesec"), utils::moon_cycle, "Number of seconds a moon cycle has", high_impact);
   confwithdesc(name("batchsize"), 200, "Number of elements per batch", high_impact);
+  confwithdesc(name("rank.budget"), 2000, "Work units a ranking transaction may spend (1 per row read, 4 more per row rewritten)", high_impact);
   confwithdesc(name("region.fee"), uint64_t(1000) * uint64_t(10000), "Minimum amount to create a region (in Seeds)", high_impact);
   confwithdesc(name("vdecayprntge"), 15, "The percentage of voice decay (in percentage)", high_impact);
   confwithdesc(name("decaytime"), utils::proposal_cycle / 2, "Minimum amount of seconds before start voice decay", high_impact);
@@ -72,6 +73,8 @@ void settings::reset() {
   confwithdesc(name("hrvst.rgns"), 300000, "Percentage of the harvest that Regions will receive (4 decimals of precision)", high_impact);
   confwithdesc(name("hrvst.orgs"), 200000, "Percentage of the harvest that Organizations will receive (4 decimals of precision)", high_impact);
   confwithdesc(name("hrvst.global"), 200000, "Percentage of the harvest that Global G-DHO will receive (4 decimals of precision)", high_impact);
+  confwithdesc(name("hrvst.payout"), 0, "Harvest payout: 0 transfer to each account, 1 credit a balance accounts claim, 2 credit and pay out in bulk", high_impact);
+  confwithdesc(name("instr.on"), 0, "Record rows, sent actions and timing of instrumented actions in each contract's actstats table (1 on, 0 off)", low_impact);
   
   // Organizations
   confwithdesc(name("org.minplant"), 200 * 10000, "Minimum amount to create an organization (in Seeds)", high_impact);
@@ -105,6 +108,7 @@ void settings::reset() {
 
   // Scheduler cycle
   confwithdesc(name("secndstoexec"), 60, "Seconds to execute", high_impact);
+  confwithdesc(name("sched.ops"), 4, "Maximum number of scheduled operations started in one scheduler execution", high_impact);
 
   // =====================================
   // citizenship path 
@@ -307,6 +311,8 @@ void settings::configure(name param, uint64_t value) {
       item.value = value;
     });
   }
+
+  config_snapshot::update(get_self(), param, value);
 }
 
 void settings::conffloat(name param, double value) {
@@ -328,6 +334,8 @@ void settings::conffloat(name param, double value) {
       item.value = value;
     });
   }
+
+  config_snapshot::update_float(get_self(), param, value);
 }
 
 void settings::confwithdesc(name param, uint64_t value, string description, name impact) {
@@ -353,6 +361,8 @@ void settings::confwithdesc(name param, uint64_t value, string description, name
       item.impact = impact;
     });
   }
+
+  config_snapshot::update(get_self(), param, value);
 }
 
 void settings::conffloatdsc(name param, double value, string description, name impact) {
@@ -378,6 +388,8 @@ void settings::conffloatdsc(name param, double value, string description, name i
       item.impact = impact;
     });
   }
+
+  config_snapshot::update_float(get_self(), param, value);
 }
 
 void settings::setcontract(name contract, name account) {
@@ -397,3 +409,33 @@ void settings::setcontract(name contract, name account) {
     });
   }
 }
+
+// rebuilds the config snapshot from the config tables, for parameters set before the snapshot existed
+void settings::publishconf() {
+  require_auth(get_self());
+
+  config_snapshot_tables snap(get_self(), get_self().value);
+  auto current = snap.get_or_default(config_snapshot_table{ 0, {}, {}, 0, 0 });
+
+  config_snapshot_table rebuilt{ current.version + 1, {}, {}, 0, 0 };
+  rebuilt.values.resize(config_snapshot::param_count, 0);
+  rebuilt.float_values.resize(config_snapshot::float_param_count, 0);
+
+  for (uint8_t i = 0; i < config_snapshot::param_count; i++) {
+    auto citr = config.find(config_snapshot::params[i].value);
+    if (citr != config.end()) {
+      rebuilt.values[i] = citr->value;
+      rebuilt.present |= uint64_t(1) << i;
+    }
+  }
+
+  for (uint8_t i = 0; i < config_snapshot::float_param_count; i++) {
+    auto fitr = configfloat.find(config_snapshot::float_params[i].value);
+    if (fitr != configfloat.end()) {
+      rebuilt.float_values[i] = fitr->value;
+      rebuilt.float_present |= uint64_t(1) << i;
+    }
+  }
+
+  snap.set(rebuilt, get_self());
+}
@@ -51,6 +51,10 @@ void token::issue( const name& to, const asset& quantity, const string& memo )
        s.supply += quantity;
     });
 
+    if ( sym == seeds_symbol ) {
+       change_circulating( quantity.amount, quantity.amount );
+    }
+
     add_balance( st.issuer, quantity, st.issuer );
 }
 
@@ -75,6 +79,10 @@ void token::retire( const asset& quantity, const string& memo )
        s.supply -= quantity;
     });
 
+    if ( sym == seeds_symbol ) {
+       change_circulating( -quantity.amount, -quantity.amount );
+    }
+
     sub_balance( st.issuer, quantity );
 }
 
@@ -93,6 +101,10 @@ void token::burn( const name& from, const asset& quantity )
   statstable.modify(sitr, from, [&](auto& stats) {
     stats.supply -= quantity;
   });
+
+  if (sym == seeds_symbol) {
+    change_circulating(-quantity.amount, -quantity.amount);
+  }
 }
 
 void token::transfer( const name&    from,
@@ -129,6 +141,52 @@ void token::transfer( const name&    from,
     update_stats( from, to, quantity );
 }
 
+void token::transfermany( const name&    from,
+                          const std::vector<std::pair<name, asset>>& payouts,
+                          const string&  memo )
+{
+    require_auth( from );
+
+    payer_tables payers( get_self(), get_self().value );
+    auto pitr = payers.find( from.value );
+    check( pitr != payers.end(), "seeds: transfermany is only available for system payouts" );
+    check( payouts.size() > 0, "seeds: no payouts" );
+    check( memo.size() <= 256, "seeds: memo has more than 256 bytes" );
+
+    auto sym = payouts[0].second.symbol;
+    stats statstable( get_self(), sym.code().raw() );
+    const auto& st = statstable.get( sym.code().raw() );
+
+    asset total( 0, sym );
+
+    for ( const auto& payout : payouts ) {
+        const name& to = payout.first;
+        const asset& quantity = payout.second;
+
+        check( from != to, "seeds: cannot transfer to self" );
+        check( is_account( to ), "seeds: to account does not exist");
+        check( quantity.is_valid(), "seeds: invalid quantity" );
+        check( quantity.amount > 0, "seeds: must transfer positive quantity" );
+        check( quantity.symbol == st.supply.symbol, "seeds: symbol precision mismatch" );
+
+        // recipients see the payout as they saw each transfer it replaces
+        require_recipient( to );
+        add_balance( to, quantity, from );
+        total += quantity;
+    }
+
+    sub_balance( from, total );
+
+    payers.modify( pitr, get_self(), [&]( auto& p ) {
+        p.payouts += 1;
+        p.recipients += payouts.size();
+        if ( sym == seeds_symbol ) {
+            p.volume += total;
+        }
+        p.last_payout_at = eosio::current_time_point().sec_since_epoch();
+    });
+}
+
 void token::sub_balance( const name& owner, const asset& value ) {
    accounts from_acnts( get_self(), owner.value );
 
@@ -139,6 +197,10 @@ void token::sub_balance( const name& owner, const asset& value ) {
    from_acnts.modify( from, owner, [&]( auto& a ) {
          a.balance -= value;
       });
+
+   if ( value.symbol == seeds_symbol && is_system_account( owner ) ) {
+      change_circulating( 0, value.amount );
+   }
 }
 
 void token::add_balance( const name& owner, const asset& value, const name& ram_payer )
@@ -154,6 +216,26 @@ void token::add_balance( const name& owner, const asset& value, const name& ram_
         a.balance += value;
       });
    }
+
+   if ( value.symbol == seeds_symbol && is_system_account( owner ) ) {
+      change_circulating( 0, -value.amount );
+   }
+}
+
+bool token::is_system_account( const name& account ) {
+   return sysaccts.find( account.value ) != sysaccts.end();
+}
+
+void token::change_circulating( int64_t total_delta, int64_t circulating_delta ) {
+   // updatecirc sets the baseline, until then there is nothing to adjust
+   if ( !circulating.exists() ) {
+      return;
+   }
+
+   circulating_supply_table c = circulating.get();
+   c.total = uint64_t( int64_t(c.total) + total_delta );
+   c.circulating = uint64_t( int64_t(c.circulating) + circulating_delta );
+   circulating.set( c, get_self() );
 }
 
 void token::save_transaction(name from, name to, asset quantity) {
@@ -172,43 +254,34 @@ void token::save_transaction(name from, name to, asset quantity) {
 }
 
 void token::check_limit_transactions(name from) {
-  user_tables users(contracts::accounts, contracts::accounts.value);
   config_tables config(contracts::settings, contracts::settings.value);
-  balance_tables balances(contracts::harvest, contracts::harvest.value);
 
-  auto bitr = balances.find(from.value);
-  auto uitr = users.find(from.value);
+  user_core_table user;
 
-  if (uitr != users.end()) {
+  if (user_core::find(from, user)) {
     uint64_t max_trx = 0;
     auto min_trx = config.get(name("txlimit.min").value, "The txlimit.min parameters has not been initialized yet.");
-    if (bitr != balances.end() && bitr -> planted > asset(0, seeds_symbol)) {
+    if (user.planted > 0) {
       auto mul_trx = config.get(name("txlimit.mul").value, "The txlimit.mul parameters has not been initialized yet.");
-      max_trx = (mul_trx.value * (bitr -> planted).amount) / 10000;
+      max_trx = (mul_trx.value * user.planted) / 10000;
     } 
         
     if (min_trx.value > max_trx) {
       max_trx = min_trx.value;
     }
 
-    transaction_tables transactions(get_self(), seeds_symbol.code().raw());
-    auto titr = transactions.find(from.value);
-
-    if (titr != transactions.end()) {
-      check(max_trx > titr -> outgoing_transactions, "Maximum limit of allowed transactions reached.");
-    }
+    check(max_trx > outgoing_this_week(from), "Maximum limit of allowed transactions reached.");
   }
 }
 
 void token::check_limit(const name& from) {
-  user_tables users(contracts::accounts, contracts::accounts.value);
-  auto uitr = users.find(from.value);
+  user_core_table user;
 
-  if (uitr == users.end()) {
+  if (!user_core::find(from, user)) {
     return;
   }
 
-  name status = uitr->status;
+  name status = user.status;
 
   uint64_t limit = 10;
   if (status == "resident"_n) {
@@ -217,66 +290,33 @@ void token::check_limit(const name& from) {
     limit = 100;
   }
 
-  transaction_tables transactions(get_self(), seeds_symbol.code().raw());
-  auto titr = transactions.find(from.value);
-  uint64_t current = titr->outgoing_transactions;
+  uint64_t current = outgoing_this_week(from);
 
   check(current < limit, "too many outgoing transactions");
 }
 
-void token::reset_weekly_aux(uint64_t begin) {
-
-  config_tables config(contracts::settings, contracts::settings.value);
-
-  auto batch_size = config.get(name("batchsize").value, "The batchsize parameter has not been initialized yet.");
-  auto sym_code_raw = seeds_symbol.code().raw();
-  uint64_t count = 0;
-
-  transaction_tables transactions(get_self(), sym_code_raw);
-
-  auto titr = begin == 0 ? transactions.begin() : transactions.lower_bound(begin);
-  while (titr != transactions.end() && count < batch_size.value) {
-    transactions.modify(titr, _self, [&](auto& user) {
-      user.incoming_transactions = 0;
-      user.outgoing_transactions = 0;
-      user.total_transactions = 0;
-      user.transactions_volume = asset(0, seeds_symbol);
-    });
-    titr++;
-    count++;
-  }
+uint64_t token::outgoing_this_week(const name& from) {
+  transaction_tables transactions(get_self(), seeds_symbol.code().raw());
+  auto titr = transactions.find(from.value);
 
-  if (titr != transactions.end()) {
-    transaction trx{};
-    trx.actions.emplace_back(
-      permission_level(_self, "active"_n),
-      _self,
-      "resetwhelper"_n,
-      std::make_tuple((titr -> account).value)
-    );
-    trx.delay_sec = 1;
-    trx.send(eosio::current_time_point().sec_since_epoch(), _self);
+  if (titr == transactions.end() || !epoch_counter::fresh(*titr, epoch_counter::current(epochs, trxstat_counter))) {
+    return 0;
   }
-
+  return titr->outgoing_transactions;
 }
 
 void token::resetweekly() {
   require_auth(get_self());
-  reset_weekly_aux((uint64_t)0);
-}
-
-void token::resetwhelper (uint64_t begin) {
-  require_auth(get_self());
-  reset_weekly_aux(begin);
+  jobs::start(get_self(), "resetweekly"_n);
+  epoch_counter::advance(epochs, trxstat_counter, get_self());
+  jobs::chunk(get_self(), "resetweekly"_n, 1);
+  jobs::finish(get_self(), "resetweekly"_n);
 }
 
 void token::update_stats( const name& from, const name& to, const asset& quantity ) {
-    user_tables users(contracts::accounts, contracts::accounts.value);
+    user_core_table fromuser, touser;
 
-    auto fromuser = users.find(from.value);
-    auto touser = users.find(to.value);
-    
-    if (fromuser == users.end() || touser == users.end()) {
+    if (!user_core::find(from, fromuser) || !user_core::find(to, touser)) {
       return;
     }
 
@@ -285,6 +325,14 @@ void token::update_stats( const name& from, const name& to, const asset& quantit
 
     auto fromitr = transactions.find(from.value);
     auto toitr = transactions.find(to.value);
+    uint64_t epoch = epoch_counter::current(epochs, trxstat_counter);
+
+    auto reset = [&](auto& user) {
+      user.transactions_volume = asset(0, quantity.symbol);
+      user.total_transactions = 0;
+      user.incoming_transactions = 0;
+      user.outgoing_transactions = 0;
+    };
 
     if (fromitr == transactions.end()) {
       transactions.emplace(get_self(), [&](auto& user) {
@@ -293,9 +341,11 @@ void token::update_stats( const name& from, const name& to, const asset& quantit
         user.total_transactions = 1;
         user.incoming_transactions = 0;
         user.outgoing_transactions = 1;
+        user.epoch = epoch;
       });
     } else {
       transactions.modify(fromitr, get_self(), [&](auto& user) {
+          epoch_counter::renew(user, epoch, reset);
           user.transactions_volume += quantity;
           user.outgoing_transactions += 1;
           user.total_transactions += 1;
@@ -309,9 +359,11 @@ void token::update_stats( const name& from, const name& to, const asset& quantit
         user.total_transactions = 1;
         user.incoming_transactions = 1;
         user.outgoing_transactions = 0;
+        user.epoch = epoch;
       });
     } else {
       transactions.modify(toitr, get_self(), [&](auto& user) {
+        epoch_counter::renew(user, epoch, reset);
         user.transactions_volume += quantity;
         user.total_transactions += 1;
         user.incoming_transactions += 1;
@@ -348,53 +400,106 @@ void token::close( const name& owner, const symbol& symbol )
    acnts.erase( it );
 }
 
-void token::updatecirc() {
-
-   require_auth(get_self());
-
-    // total supply
+void token::reconcile_circulating() {
     stats statstable( get_self(), seeds_symbol.code().raw() );
     auto sitr = statstable.find( seeds_symbol.code().raw() );
 
     uint64_t total = sitr->supply.amount;
     uint64_t result = total;
 
-    std::array<name, 12> system_accounts = {
-      "gift.seeds"_n,
-      "milest.seeds"_n,
-      "hypha.seeds"_n,
-      "allies.seeds"_n,
-      "refer.seeds"_n,
-      "bank.seeds"_n,
-      "system.seeds"_n,
-      "harvst.seeds"_n,   // planted - although these go into system actually
-      "funds.seeds"_n,    // proposals
-      "rules.seeds"_n,    // referendums
-      "dao.hypha"_n,      // hypha dao escrow contract
-      "escrow.seeds"_n
-    };
-
-    for(const auto& account : system_accounts) {   // Range-for!
-      result -= balance_for(account);
+    for (auto aitr = sysaccts.begin(); aitr != sysaccts.end(); aitr++) {
+      result -= balance_for(aitr->account);
     }
 
     circulating_supply_table c = circulating.get_or_create(get_self(), circulating_supply_table());
     c.total = total;
     c.circulating = result;
     circulating.set(c, get_self());
+}
 
-    transaction trx{};
-    trx.actions.emplace_back(
-      permission_level(_self, "active"_n),
-      _self,
-      "updatecirc"_n,
-      std::make_tuple()
-    );
-    trx.delay_sec = 60 * 60; // TODO use scheduler for this - run every hour
-    trx.send(eosio::current_time_point().sec_since_epoch() + 19, _self);
-    
+void token::updatecirc() {
+  require_auth(get_self());
+  reconcile_circulating();
+}
+
+void token::addsysacct(name account) {
+  require_auth(get_self());
+
+  check(sysaccts.find(account.value) == sysaccts.end(), "seeds: " + account.to_string() + " is already a system account");
+
+  sysaccts.emplace(get_self(), [&](auto & item) {
+    item.account = account;
+  });
+
+  change_circulating(0, -int64_t(balance_for(account)));
+}
+
+void token::delsysacct(name account) {
+  require_auth(get_self());
+
+  auto aitr = sysaccts.find(account.value);
+  check(aitr != sysaccts.end(), "seeds: " + account.to_string() + " is not a system account");
+
+  sysaccts.erase(aitr);
+
+  change_circulating(0, int64_t(balance_for(account)));
+}
+
+void token::initsysaccts() {
+  require_auth(get_self());
+
+  std::array<name, 12> system_accounts = {
+    "gift.seeds"_n,
+    "milest.seeds"_n,
+    "hypha.seeds"_n,
+    "allies.seeds"_n,
+    "refer.seeds"_n,
+    "bank.seeds"_n,
+    "system.seeds"_n,
+    "harvst.seeds"_n,   // planted - although these go into system actually
+    "funds.seeds"_n,    // proposals
+    "rules.seeds"_n,    // referendums
+    "dao.hypha"_n,      // hypha dao escrow contract
+    "escrow.seeds"_n
+  };
+
+  for (const auto& account : system_accounts) {
+    if (sysaccts.find(account.value) == sysaccts.end()) {
+      sysaccts.emplace(get_self(), [&](auto & item) {
+        item.account = account;
+      });
+    }
+  }
+
+  reconcile_circulating();
 }
 
+void token::addpayer(name sender) {
+  require_auth(get_self());
+
+  payer_tables payers(get_self(), get_self().value);
+  if (payers.find(sender.value) != payers.end()) {
+    return;
+  }
+
+  payers.emplace(get_self(), [&](auto & item) {
+    item.sender = sender;
+    item.payouts = 0;
+    item.recipients = 0;
+    item.volume = asset(0, seeds_symbol);
+    item.last_payout_at = 0;
+  });
+}
+
+void token::delpayer(name sender) {
+  require_auth(get_self());
+
+  payer_tables payers(get_self(), get_self().value);
+  auto pitr = payers.find(sender.value);
+  check(pitr != payers.end(), "seeds: " + sender.to_string() + " is not a payer");
+
+  payers.erase(pitr);
+}
 
 uint64_t token::balance_for( const name& owner ) {
    accounts from_acnts( get_self(), owner.value );
@@ -441,4 +546,4 @@ void token::minttst (const name& to, const asset& quantity, const string& memo)
 
 } /// namespace eosio
 
-EOSIO_DISPATCH( eosio::token, (create)(issue)(transfer)(open)(close)(retire)(burn)(resetweekly)(resetwhelper)(updatecirc)(minttst) )
+EOSIO_DISPATCH( eosio::token, (create)(issue)(transfer)(transfermany)(open)(close)(retire)(burn)(resetweekly)(updatecirc)(addsysacct)(delsysacct)(initsysaccts)(addpayer)(delpayer)(minttst) )
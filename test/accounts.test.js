@@ -25,6 +25,19 @@ const get_reps = async () => {
   return result
 }
 
+const get_rank_tree_total = async (tree) => {
+  const nodes = await eos.getTableRows({
+    code: accounts,
+    scope: tree,
+    table: 'ranktree',
+    lower_bound: 0,
+    upper_bound: 0,
+    json: true,
+  })
+
+  return nodes.rows.length == 0 ? 0 : nodes.rows[0].counts.reduce((sum, count) => sum + Number(count), 0)
+}
+
 const can_vote = async (user) => {
   const voice = await eos.getTableRows({
     code: proposals,
@@ -185,6 +198,13 @@ describe('General accounts', async assert => {
     json: true,
   })
 
+  const usercore = await eos.getTableRows({
+    code: accounts,
+    scope: accounts,
+    table: 'usercore',
+    json: true,
+  })
+
   const refs = await eos.getTableRows({
     code: accounts,
     scope: accounts,
@@ -192,6 +212,13 @@ describe('General accounts', async assert => {
     json: true
   })
 
+  const refstats = await eos.getTableRows({
+    code: accounts,
+    scope: accounts,
+    table: 'refstats',
+    json: true
+  })
+
   console.log('test citizen second user')
   await contract.testcitizen(seconduser, { authorization: `${accounts}@active` })
 
@@ -277,6 +304,18 @@ describe('General accounts', async assert => {
     }
   })
 
+  assert({
+    given: 'invited user',
+    should: 'count referral for referrer',
+    actual: refstats.rows[0],
+    expected: {
+      referrer: firstuser,
+      referrals: 1,
+      residents: 0,
+      citizens: 0
+    }
+  })
+
   assert({
     given: 'users table',
     should: 'show joined users',
@@ -296,6 +335,13 @@ describe('General accounts', async assert => {
     ]
   })
 
+  assert({
+    given: 'users table',
+    should: 'have the same status, type and reputation in usercore',
+    actual: usercore.rows.map(({ account, status, type, reputation }) => ({ account, status, type, reputation })),
+    expected: users.rows.map(({ account, status, type, reputation }) => ({ account, status, type, reputation }))
+  })
+
   assert({
     given: 'test-removed user',
     should: 'have 1 fewer users than before',
@@ -1129,7 +1175,7 @@ describe('reputation & cbs ranking', async assert => {
 
   // await contracts.accounts.rankrep(0, 0, 200, { authorization: `${accounts}@active` })
 
-  await contracts.accounts.rankcbs(0, 0, 1, accounts, { authorization: `${accounts}@active` })
+  await contracts.accounts.rankcbs(1, accounts, { authorization: `${accounts}@active` })
   await sleep(4000)
 
   const repsAfter = await getTableRows({
@@ -1146,7 +1192,7 @@ describe('reputation & cbs ranking', async assert => {
     json: true
   })
   
-  await contracts.accounts.rankcbs(0, 0, 40, accounts, { authorization: `${accounts}@active` })
+  await contracts.accounts.rankcbs(200, accounts, { authorization: `${accounts}@active` })
 
   const cbsAfter2 = await getTableRows({
     code: accounts,
@@ -1743,6 +1789,195 @@ describe('Punishment', async assert => {
 
 })
 
+describe('flag demotes a citizen by its rank tree rank', async assert => {
+
+  if (!isLocal()) {
+    console.log("only run unit tests on local - don't reset accounts on mainnet or testnet")
+    return
+  }
+
+  const contracts = await initContracts({ accounts, settings })
+
+  console.log('reset accounts')
+  await contracts.accounts.reset({ authorization: `${accounts}@active` })
+
+  console.log('reset settings')
+  await contracts.settings.reset({ authorization: `${settings}@active` })
+
+  console.log('configure flags and thresholds')
+  await contracts.settings.configure('flag.thresh', 100, { authorization: `${settings}@active` })
+  await contracts.settings.configure('flag.base.c', 100, { authorization: `${settings}@active` })
+  await contracts.settings.configure('res.rep.pt', 10, { authorization: `${settings}@active` })
+  await contracts.settings.configure('cit.rep.sc', 50, { authorization: `${settings}@active` })
+
+  const users = [firstuser, seconduser, thirduser, fourthuser]
+  const reps = [300, 150, 200, 250]
+
+  console.log('join citizens')
+  for (let i = 0; i < users.length; i++) {
+    await contracts.accounts.adduser(users[i], 'user', 'individual', { authorization: `${accounts}@active` })
+    await contracts.accounts.testcitizen(users[i], { authorization: `${accounts}@active` })
+    await contracts.accounts.addrep(users[i], reps[i], { authorization: `${accounts}@active` })
+  }
+
+  const getFirst = async () => {
+    const rep = await getTableRows({
+      code: accounts,
+      scope: accounts,
+      table: 'rep',
+      lower_bound: firstuser,
+      upper_bound: firstuser,
+      json: true
+    })
+    const usersTable = await getTableRows({
+      code: accounts,
+      scope: accounts,
+      table: 'users',
+      lower_bound: firstuser,
+      upper_bound: firstuser,
+      json: true
+    })
+    return { rep: rep.rows[0].rep, rank: rep.rows[0].rank, status: usersTable.rows[0].status }
+  }
+
+  const before = await getFirst()
+
+  console.log('flag the top ranked citizen')
+  // a rank 99 citizen flags with 2x the base points, 200 rep takes the first user to the bottom
+  await contracts.accounts.testsetrs(fourthuser, 99, { authorization: `${accounts}@active` })
+  await contracts.accounts.flag(fourthuser, firstuser, { authorization: `${fourthuser}@active` })
+
+  await sleep(2000)
+
+  const after = await getFirst()
+
+  assert({
+    given: 'the highest reputation',
+    should: 'be a citizen above the citizen rank',
+    actual: [before.status, before.rank >= 50],
+    expected: ['citizen', true]
+  })
+
+  assert({
+    given: 'a flag that takes the reputation to the bottom',
+    should: 'rank the user from the rank tree and demote them',
+    actual: after,
+    expected: { rep: 100, rank: 0, status: 'visitor' }
+  })
+
+})
+
+describe('vouch totals through vouch, unvouch and punishment', async assert => {
+
+  if (!isLocal()) {
+    console.log("only run unit tests on local - don't reset accounts on mainnet or testnet")
+    return
+  }
+
+  const contracts = await initContracts({ accounts, settings })
+
+  console.log('reset accounts')
+  await contracts.accounts.reset({ authorization: `${accounts}@active` })
+
+  console.log('reset settings')
+  await contracts.settings.reset({ authorization: `${settings}@active` })
+  await contracts.settings.configure('batchsize', 2, { authorization: `${settings}@active` })
+
+  const sponsors = [firstuser, seconduser]
+  const vouched = [thirduser, fourthuser, fifthuser]
+
+  console.log('join users')
+  for (const user of sponsors.concat(vouched)) {
+    await contracts.accounts.adduser(user, 'user', 'individual', { authorization: `${accounts}@active` })
+  }
+
+  // citizens with rank 99 vouch with 2 x 20 points, maxvouch caps the rep at 50
+  for (const sponsor of sponsors) {
+    await contracts.accounts.testcitizen(sponsor, { authorization: `${accounts}@active` })
+    await contracts.accounts.addrep(sponsor, 100, { authorization: `${accounts}@active` })
+    await contracts.accounts.testsetrs(sponsor, 99, { authorization: `${accounts}@active` })
+  }
+
+  const getTotals = async () => {
+    const totals = await getTableRows({
+      code: accounts,
+      scope: accounts,
+      table: 'vouchtotals',
+      json: true
+    })
+    return vouched.map(user => {
+      const row = totals.rows.find(r => r.account == user)
+      return row ? [row.total_vouch_points, row.total_rep_points] : null
+    })
+  }
+
+  const getReps = async () => {
+    const reps = await getTableRows({
+      code: accounts,
+      scope: accounts,
+      table: 'rep',
+      json: true
+    })
+    return sponsors.concat(vouched).map(user => {
+      const row = reps.rows.find(r => r.account == user)
+      return row ? row.rep : 0
+    })
+  }
+
+  console.log('vouch')
+  for (const user of vouched) {
+    await contracts.accounts.vouch(firstuser, user, { authorization: `${firstuser}@active` })
+  }
+  await contracts.accounts.vouch(seconduser, thirduser, { authorization: `${seconduser}@active` })
+  await sleep(500)
+
+  const totalsVouched = await getTotals()
+  const repsVouched = await getReps()
+
+  console.log('unvouch')
+  await contracts.accounts.unvouch(seconduser, thirduser, { authorization: `${seconduser}@active` })
+  await sleep(500)
+
+  const totalsUnvouched = await getTotals()
+  const repsUnvouched = await getReps()
+
+  console.log('punish the sponsor')
+  await contracts.accounts.punish(firstuser, 10, { authorization: `${accounts}@active` })
+  await sleep(3000)
+
+  const totalsPunished = await getTotals()
+  const repsPunished = await getReps()
+
+  const vouches = await getTableRows({
+    code: accounts,
+    scope: accounts,
+    table: 'vouches',
+    json: true
+  })
+
+  assert({
+    given: 'two vouches for one user and one each for the others',
+    should: 'add them to the vouch totals and cap the rep',
+    actual: [totalsVouched, repsVouched],
+    expected: [[[80, 50], [40, 40], [40, 40]], [100, 100, 50, 40, 40]]
+  })
+
+  assert({
+    given: 'one of the two vouches removed',
+    should: 'take it out of the total and the rep',
+    actual: [totalsUnvouched, repsUnvouched],
+    expected: [[[40, 40], [40, 40], [40, 40]], [100, 100, 40, 40, 40]]
+  })
+
+  assert({
+    given: 'the sponsor punished with vouches in more than one batch',
+    should: 'clear every vouch it gave and the rep they brought',
+    actual: [totalsPunished, repsPunished, vouches.rows.filter(v => v.sponsor == firstuser).map(v => v.vouch_points)],
+    expected: [[[0, 0], [0, 0], [0, 0]], [90, 100, 0, 0, 0], [0, 0, 0]]
+  })
+
+})
+
 describe('Migrate cbs and rep for orgs', async assert => {
 
   if (!isLocal()) {
@@ -1848,4 +2083,176 @@ describe('Migrate cbs and rep for orgs', async assert => {
   await printHarvestTables(harvest)
   await printHarvestTables('org')
 
-})
\ No newline at end of file
+  const treeSizes = {}
+  for (const [tree, scope, table] of [['rep', accounts, 'rep'], ['org.rep', 'org', 'rep'], ['cbs', accounts, 'cbs'], ['org.cbs', 'org', 'cbs']]) {
+    treeSizes[tree] = {
+      tree: await get_rank_tree_total(tree),
+      rows: (await getTableRows({ code: accounts, scope, table, json: true })).rows.length
+    }
+  }
+
+  assert({
+    given: 'orgs migrated and deleted from the individual scope',
+    should: 'keep one value per row in the rank trees',
+    actual: treeSizes,
+    expected: {
+      rep: { tree: 2, rows: 2 },
+      'org.rep': { tree: 5, rows: 5 },
+      cbs: { tree: 2, rows: 2 },
+      'org.cbs': { tree: 5, rows: 5 }
+    }
+  })
+
+})
+
+describe('rank trees on a deployed contract', async assert => {
+
+  if (!isLocal()) {
+    console.log("only run unit tests on local - don't reset accounts on mainnet or testnet")
+    return
+  }
+
+  const contracts = await initContracts({ accounts, settings })
+
+  console.log('reset accounts')
+  await contracts.accounts.reset({ authorization: `${accounts}@active` })
+
+  console.log('reset settings')
+  await contracts.settings.reset({ authorization: `${settings}@active` })
+
+  console.log('add users')
+  const users = [firstuser, seconduser, thirduser]
+  for (let i = 0; i < users.length; i++) {
+    await contracts.accounts.adduser(users[i], `user ${i}`, 'individual', { authorization: `${accounts}@active` })
+    await contracts.accounts.addrep(users[i], 10 * (i + 1), { authorization: `${accounts}@api` })
+  }
+
+  console.log('rebuild the rep tree one row per transaction')
+  await contracts.settings.configure('batchsize', 1, { authorization: `${settings}@active` })
+  await contracts.accounts.initranks('rep', 0, { authorization: `${accounts}@active` })
+
+  const rankBeforeBuilt = (await getTableRows({ code: accounts, scope: accounts, table: 'rep', lower_bound: thirduser, upper_bound: thirduser, json: true })).rows[0].rank
+
+  console.log('change rep while the tree is being built')
+  let changesWork = true
+  try {
+    await contracts.accounts.subrep(firstuser, 5, { authorization: `${accounts}@api` })
+    await contracts.accounts.addrep(thirduser, 1000, { authorization: `${accounts}@api` })
+  } catch (err) {
+    changesWork = false
+    console.log('rep change failed', err)
+  }
+
+  const rankWhileBuilding = (await getTableRows({ code: accounts, scope: accounts, table: 'rep', lower_bound: thirduser, upper_bound: thirduser, json: true })).rows[0].rank
+
+  await sleep(5000)
+
+  const treeTotal = await get_rank_tree_total('rep')
+
+  await contracts.accounts.addrep(seconduser, 1, { authorization: `${accounts}@api` })
+  await contracts.accounts.addrep(thirduser, 1, { authorization: `${accounts}@api` })
+
+  const repsAfter = await getTableRows({ code: accounts, scope: accounts, table: 'rep', json: true })
+
+  await contracts.settings.configure('batchsize', 200, { authorization: `${settings}@active` })
+
+  assert({
+    given: 'rep changed while initranks runs',
+    should: 'not fail',
+    actual: changesWork,
+    expected: true
+  })
+
+  assert({
+    given: 'rep changed for a row initranks has not reached',
+    should: 'keep the rank of the last pass',
+    actual: rankWhileBuilding,
+    expected: rankBeforeBuilt
+  })
+
+  assert({
+    given: 'initranks finished',
+    should: 'count every row once',
+    actual: treeTotal,
+    expected: 3
+  })
+
+  assert({
+    given: 'rep changed after the tree is built',
+    should: 'rank the row from the tree',
+    actual: repsAfter.rows.map(({ account, rep, rank }) => ({ account, rep, rank })),
+    expected: [
+      { account: firstuser, rep: 5, rank: 0 },
+      { account: seconduser, rep: 21, rank: 33 },
+      { account: thirduser, rep: 1031, rank: 66 }
+    ]
+  })
+
+})
+describe('referral stats on a deployed contract', async assert => {
+
+  if (!isLocal()) {
+    console.log("only run unit tests on local - don't reset accounts on mainnet or testnet")
+    return
+  }
+
+  const contracts = await initContracts({ accounts, settings })
+
+  console.log('reset accounts')
+  await contracts.accounts.reset({ authorization: `${accounts}@active` })
+
+  console.log('reset settings')
+  await contracts.settings.reset({ authorization: `${settings}@active` })
+
+  const invited = [seconduser, thirduser, fourthuser, fifthuser]
+
+  console.log('add users and referrals')
+  await contracts.accounts.adduser(firstuser, 'referrer', 'individual', { authorization: `${accounts}@active` })
+  for (const user of invited) {
+    await contracts.accounts.adduser(user, 'invited', 'individual', { authorization: `${accounts}@active` })
+    await contracts.accounts.addref(firstuser, user, { authorization: `${accounts}@active` })
+  }
+
+  const getStats = async () => {
+    const stats = await getTableRows({ code: accounts, scope: accounts, table: 'refstats', json: true })
+    return stats.rows
+  }
+
+  const getState = async () => {
+    const state = await getTableRows({ code: accounts, scope: accounts, table: 'refstatsst', json: true })
+    return state.rows[0]
+  }
+
+  console.log('rebuild refstats one referral per transaction')
+  await contracts.settings.configure('batchsize', 1, { authorization: `${settings}@active` })
+  await contracts.accounts.initrefstats(0, { authorization: `${accounts}@active` })
+
+  const stateWhileBuilding = await getState()
+
+  console.log('change the status of the invited users while it runs')
+  for (const user of invited) {
+    await contracts.accounts.testresident(user, { authorization: `${accounts}@active` })
+  }
+
+  await sleep(6000)
+
+  const statsBuilt = await getStats()
+  const stateBuilt = await getState()
+
+  await contracts.settings.configure('batchsize', 200, { authorization: `${settings}@active` })
+
+  assert({
+    given: 'initrefstats running',
+    should: 'not be built yet',
+    actual: !!stateWhileBuilding.built,
+    expected: false
+  })
+
+  assert({
+    given: 'statuses changed while initrefstats ran',
+    should: 'count every referral and resident once',
+    actual: [statsBuilt, !!stateBuilt.built],
+    expected: [[{ referrer: firstuser, referrals: 4, residents: 4, citizens: 0 }], true]
+  })
+
+})
@@ -167,13 +167,15 @@ describe('forum', async assert => {
                 account: firstuser,
                 num_votes: 1,
                 points_left: 630000,
-                max_points: 700000
+                max_points: 700000,
+                epoch: 1
                 },
                 {
                 account: seconduser,
                 num_votes: 1,
                 points_left: 315000,
-                max_points: 350000
+                max_points: 350000,
+                epoch: 1
             }
         ]
     })
@@ -101,6 +101,7 @@ describe('gratitude general', async assert => {
   checkReceivedGratitude(seconduser, transferAmount)
 
   console.log('restart gratitude round')
+  await contracts.token.addpayer(gratitude, { authorization: `${token}@active` })
 
   const secondBalanceBefore = await getBalance(seconduser)  
   await contracts.gratitude.newround({ authorization: `${gratitude}@active` })
@@ -104,6 +104,20 @@ describe("Harvest General", async assert => {
 
   await checkTotal(600);
 
+  const profiles = await eos.getTableRows({
+    code: accounts,
+    scope: accounts,
+    table: 'usercore',
+    json: true,
+  })
+
+  assert({
+    given: 'planted and unplanted',
+    should: 'have the planted amount in the transfer profile',
+    actual: profiles.rows.filter(({ account }) => account == firstuser || account == seconduser).map(({ account, planted }) => ({ account, planted })),
+    expected: [{ account: firstuser, planted: 5000000 }, { account: seconduser, planted: 1000000 }]
+  })
+
   var unplantedOverdrawCheck = true
   try {
     await contracts.harvest.unplant(seconduser, '100000000.0000 SEEDS', { authorization: `${seconduser}@active` })
@@ -115,7 +129,7 @@ describe("Harvest General", async assert => {
   const refundsAfterUnplanted = await getTableRows({
     code: harvest,
     scope: seconduser,
-    table: 'refunds',
+    table: 'refundsched',
     json: true,
     limit: 100
   })
@@ -208,7 +222,7 @@ describe("Harvest General", async assert => {
     }
   }
 
-  const totalUnplanted = refundsAfterUnplanted.rows.reduce( (a, b) => a + assetIt(b.amount).amount, 0) / 10000
+  const totalUnplanted = refundsAfterUnplanted.rows.reduce( (a, b) => a + assetIt(b.total).amount, 0) / 10000
 
   console.log('claim refund\n')
   const balanceBeforeClaimed = await getBalanceFloat(seconduser)
@@ -224,7 +238,7 @@ describe("Harvest General", async assert => {
   const refundsAfterClaimed = await getTableRows({
     code: harvest,
     scope: seconduser,
-    table: 'refunds',
+    table: 'refundsched',
     json: true,
     limit: 100
   })
@@ -250,7 +264,7 @@ describe("Harvest General", async assert => {
   const refundsAfterCanceled = await getTableRows({
     code: harvest,
     scope: seconduser,
-    table: 'refunds',
+    table: 'refundsched',
     json: true,
     limit: 100
   })
@@ -349,21 +363,21 @@ describe("Harvest General", async assert => {
 
   assert({
     given: 'unplant called',
-    should: 'create refunds rows',
-    actual: refundsAfterUnplanted.rows.length,
-    expected: 12
+    should: 'create one refund schedule over 12 weeks',
+    actual: refundsAfterUnplanted.rows.map(r => [r.request_id, r.weeks, r.claimed]),
+    expected: [[1, 12, '0.0000 SEEDS']]
   })
 
   assert({
     given: 'claimed refund',
-    should: 'keep refunds rows',
-    actual: refundsAfterClaimed.rows.length,
-    expected: 10
+    should: 'keep the schedule with the claimed amount',
+    actual: refundsAfterClaimed.rows.map(r => [r.total, Math.round(assetIt(r.claimed).amount)]),
+    expected: [[num_seeds_unplanted + '.0000 SEEDS', Math.floor(num_seeds_unplanted * 10000 / 12) * weeks_expired]]
   })
 
   assert({
     given: 'canceled refund',
-    should: 'withdraw refunds to user',
+    should: 'remove the fully claimed schedule',
     actual: refundsAfterCanceled.rows.length,
     expected: 0
   })
@@ -883,6 +897,33 @@ describe('contribution score', async assert => {
   await contracts.harvest.calccss({ authorization: `${harvest}@active` })
   await sleep(2000)
 
+  const scoreVectors = await getTableRows({
+    code: harvest,
+    scope: harvest,
+    table: 'scorevector',
+    json: true
+  })
+  const repRanks = await getTableRows({
+    code: accounts,
+    scope: accounts,
+    table: 'rep',
+    json: true
+  })
+  const vectorRepRanks = users.map(user => {
+    const row = scoreVectors.rows.find(r => r.account == user)
+    return row ? row.rep_rank : 0
+  })
+
+  assert({
+    given: 'reputation ranked in accounts',
+    should: 'copy the ranks to the score vector',
+    actual: vectorRepRanks,
+    expected: users.map(user => {
+      const row = repRanks.rows.find(r => r.account == user)
+      return row ? row.rank : 0
+    })
+  })
+
   let userScores = []
   for (const user of users) { userScores.push(await calcCSPoints(user, accounts)) }
   userScores = userScores.filter(s => s > 0)
@@ -902,6 +943,39 @@ describe('contribution score', async assert => {
   await checkCSScores(individualHarvestScope, userScores, [0, 25, 50, 75])
   await checkCSScores(organizationScope, orgScores, [0, 50])
 
+  const jobState = await getTableRows({
+    code: harvest,
+    scope: harvest,
+    table: 'jobstate',
+    json: true
+  })
+  const jobsDone = ['calctrxpts', 'ranktxs', 'rankplanteds', 'calccss', 'rankcss', 'rankorgcss'].map(job => {
+    const row = jobState.rows.find(r => r.job == job)
+    return row && row.status == 'done' && row.chunks > 0 && row.finished_at >= row.started_at
+  })
+
+  assert({
+    given: 'the harvest pipeline ran',
+    should: 'record every pass as done',
+    actual: jobsDone,
+    expected: [true, true, true, true, true, true]
+  })
+
+  const csCursors = await getTableRows({
+    code: harvest,
+    scope: harvest,
+    table: 'rankcursors',
+    json: true
+  })
+  const csCursor = csCursors.rows.find(r => r.job == 'rankcs')
+
+  assert({
+    given: 'the contribution score pass finished',
+    should: 'publish its generation',
+    actual: csCursor.generation > 0 && csCursor.published == csCursor.generation,
+    expected: true
+  })
+
 })
 
 describe("plant for other user", async assert => {
@@ -1441,11 +1515,154 @@ describe('regions contribution score', async assert => {
 
   assert({
     given: 'cs for regions, the table regioncstemp',
-    should: 'not have entries',
+    should: 'keep the region totals',
     actual: cspointsrgnsTemp.rows,
-    expected: []
+    expected: [
+      { region: 'rgn2.rgn', points: 77 },
+      { region: 'rgn3.rgn', points: 117 }
+    ]
+  })
+
+  console.log('leave region')
+  await contracts.region.leave('rgn2.rgn', fourthuser, { authorization: `${fourthuser}@active` })
+
+  const totalsAfterLeave = await getTableRows({
+    code: harvest,
+    scope: harvest,
+    table: 'regioncstemp',
+    json: true
+  })
+
+  assert({
+    given: 'a member left the region',
+    should: 'take their points out of the region total',
+    actual: totalsAfterLeave.rows,
+    expected: [
+      { region: 'rgn3.rgn', points: 117 }
+    ]
   })
 
 })
 
 
+
+describe('harvest payout modes', async assert => {
+
+  if (!isLocal()) {
+    console.log("only run unit tests on local - don't reset accounts on mainnet or testnet")
+    return
+  }
+
+  const contracts = await initContracts({ accounts, token, harvest, settings })
+
+  const users = [firstuser, seconduser, thirduser]
+
+  const getTestBalance = async (user) => {
+    const balance = await eos.getCurrencyBalance(names.token, user, 'TESTS')
+    return Number.parseFloat(balance[0]) || 0
+  }
+
+  const getClaimable = async () => {
+    const claimable = await getTableRows({
+      code: harvest,
+      scope: harvest,
+      table: 'claimable',
+      json: true
+    })
+    return claimable.rows
+  }
+
+  const distribute = async (payout) => {
+    await contracts.settings.configure('hrvst.payout', payout, { authorization: `${settings}@active` })
+    const before = await Promise.all(users.map(getTestBalance))
+    await contracts.harvest.disthvstusrs(0, 10, '60.0000 TESTS', { authorization: `${harvest}@active` })
+    await sleep(3000)
+    const after = await Promise.all(users.map(getTestBalance))
+    return after.map((balance, index) => parseFloat((balance - before[index]).toFixed(4)))
+  }
+
+  console.log('reset')
+  await contracts.settings.reset({ authorization: `${settings}@active` })
+  await contracts.accounts.reset({ authorization: `${accounts}@active` })
+  await contracts.harvest.reset({ authorization: `${harvest}@active` })
+
+  console.log('add users')
+  for (let index = 0; index < users.length; index++) {
+    await contracts.accounts.adduser(users[index], `${index} user`, 'individual', { authorization: `${accounts}@active` })
+    await contracts.harvest.testcspoints(users[index], (index + 1) * 33, { authorization: `${harvest}@active` })
+  }
+  await contracts.harvest.rankcss({ authorization: `${harvest}@active` })
+  await sleep(2000)
+
+  console.log('fund harvest')
+  await contracts.token.minttst(harvest, '180.0000 TESTS', 'harvest', { authorization: `${token}@active` })
+  await contracts.token.addpayer(harvest, { authorization: `${token}@active` })
+
+  const csTable = await getTableRows({
+    code: harvest,
+    scope: harvest,
+    table: 'cspoints',
+    json: true
+  })
+  const ranks = users.map(user => csTable.rows.find(row => row.account == user).rank)
+  const totalRank = ranks.reduce((acc, curr) => acc + curr)
+  const expected = ranks.map(rank => parseFloat((rank * 60 / totalRank).toFixed(4)))
+
+  const close = (actual) => actual.every((value, index) => Math.abs(value - expected[index]) <= 0.0002)
+
+  console.log('payout to claimable')
+  const claimHarvest = await distribute(1)
+  const claimableRows = await getClaimable()
+
+  let claimFirst = await getTestBalance(firstuser)
+  await contracts.harvest.claim(firstuser, { authorization: `${firstuser}@active` })
+  claimFirst = parseFloat((await getTestBalance(firstuser) - claimFirst).toFixed(4))
+  const claimableAfterClaim = await getClaimable()
+
+  let claimTwice = true
+  try {
+    await contracts.harvest.claim(firstuser, { authorization: `${firstuser}@active` })
+    claimTwice = false
+  } catch (err) {
+    console.log('nothing left to claim (expected)')
+  }
+
+  console.log('payout by settle')
+  await contracts.harvest.claim(seconduser, { authorization: `${seconduser}@active` })
+  await contracts.harvest.claim(thirduser, { authorization: `${thirduser}@active` })
+  const settleHarvest = await distribute(2)
+  const claimableAfterSettle = await getClaimable()
+
+  console.log('payout by transfer')
+  const transferHarvest = await distribute(0)
+  const claimableAfterTransfer = await getClaimable()
+
+  assert({
+    given: 'hrvst.payout set to claimable',
+    should: 'record the harvest as claimable instead of paying it',
+    actual: [claimHarvest, close(claimableRows.map(row => parseFloat(row.amount)))],
+    expected: [[0, 0, 0], true]
+  })
+
+  assert({
+    given: 'claim called',
+    should: 'pay the claimable amount once and remove the row',
+    actual: [Math.abs(claimFirst - expected[0]) <= 0.0002, claimableAfterClaim.map(row => row.account).includes(firstuser), claimTwice],
+    expected: [true, false, true]
+  })
+
+  assert({
+    given: 'hrvst.payout set to settle',
+    should: 'pay every user and leave nothing claimable',
+    actual: [close(settleHarvest), claimableAfterSettle],
+    expected: [true, []]
+  })
+
+  assert({
+    given: 'hrvst.payout set to transfer',
+    should: 'pay every user directly',
+    actual: [close(transferHarvest), claimableAfterTransfer],
+    expected: [true, []]
+  })
+
+})
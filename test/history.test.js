@@ -444,6 +444,20 @@ describe('individual transactions', async assert => {
     ]
   })
 
+  const txWindows = await getTableRows({
+    code: history,
+    scope: history,
+    table: 'txwindow',
+    json: true
+  })
+
+  assert({
+    given: 'transaction made',
+    should: 'keep the trx points window sums',
+    actual: [firstuser, seconduser, thirduser].map(user => txWindows.rows.find(r => r.account == user).points),
+    expected: [412, 1120, 1]
+  })
+
   assert({
     given: 'transactions made',
     should: 'have the correct entries in qevs tables',
@@ -260,6 +260,27 @@ describe('Proposals', async assert => {
   })
   //console.log("cycle stats 2",cyclestats2)
 
+  const propsAfterExecute = await eos.getTableRows({
+    code: proposals,
+    scope: proposals,
+    table: 'props',
+    json: true,
+  })
+
+  const liveProps = await eos.getTableRows({
+    code: proposals,
+    scope: proposals,
+    table: 'liveprops',
+    json: true,
+  })
+
+  assert({
+    given: 'onperiod ran',
+    should: 'only keep staged and active proposals live',
+    actual: liveProps.rows.map(row => row.id),
+    expected: propsAfterExecute.rows.filter(row => row.stage != 'done').map(row => row.id)
+  })
+
   const repsAfter = await eos.getTableRows({
     code: accounts,
     scope: accounts,
@@ -1918,8 +1939,8 @@ describe('delegate trust', async assert => {
   console.log('settings reset')
   await contracts.settings.reset({ authorization: `${settings}@active` })
 
-  console.log('configure voterep2.ind to 2')
-  await contracts.settings.configure('voterep2.ind', 2, { authorization: `${settings}@active` })
+  console.log('configure voterep2.ind to 10')
+  await contracts.settings.configure('voterep2.ind', 10, { authorization: `${settings}@active` })
 
   console.log('accounts reset')
   await contracts.accounts.reset({ authorization: `${accounts}@active` })
@@ -1948,10 +1969,14 @@ describe('delegate trust', async assert => {
 
   console.log('create alliance proposal')
   await contracts.proposals.create(firstuser, firstuser, '12.0000 SEEDS', 'alliance', 'test alliance', 'description', 'image', 'url', alliancesbank, { authorization: `${firstuser}@active` })
+
+  console.log('create another campaign proposal')
+  await contracts.proposals.create(firstuser, firstuser, '12.0000 SEEDS', 'campaign2', 'test campaign 2', 'description', 'image', 'url', campaignbank, { authorization: `${firstuser}@active` })
   
   console.log('stake')
   await contracts.token.transfer(firstuser, proposals, '555.0000 SEEDS', '1', { authorization: `${firstuser}@active` })
   await contracts.token.transfer(firstuser, proposals, '555.0000 SEEDS', '2', { authorization: `${firstuser}@active` })
+  await contracts.token.transfer(firstuser, proposals, '555.0000 SEEDS', '3', { authorization: `${firstuser}@active` })
   
   console.log('active proposals')
   await contracts.proposals.onperiod({ authorization: `${proposals}@active` })
@@ -1966,6 +1991,7 @@ describe('delegate trust', async assert => {
   await contracts.proposals.delegate(seconduser, firstuser, scopeCampaigns, { authorization: `${seconduser}@active` })
   await contracts.proposals.delegate(thirduser, firstuser, scopeCampaigns, { authorization: `${thirduser}@active` })
   await contracts.proposals.delegate(fourthuser, thirduser, scopeCampaigns, { authorization: `${fourthuser}@active` })
+  await contracts.proposals.delegate(fifthuser, thirduser, scopeCampaigns, { authorization: `${fifthuser}@active` })
 
   console.log('delegate trust for alliances')
   const scopeAlliance = 'alliance'
@@ -2007,23 +2033,30 @@ describe('delegate trust', async assert => {
     json: true,
   })
 
-  console.log('try to vote when voice is deletegated')
-  let noVoteWhenVoiceIsDelegated = true
-  try {
-    await contracts.proposals.favour(seconduser, 1, 5, { authorization: `${seconduser}@active` })
-    noVoteWhenVoiceIsDelegated = false
-  } catch (err) {
-    console.log('user can not vote when voice is delegated')
-  }
-
   console.log('vote for campaigns')
   await contracts.proposals.favour(firstuser, 1, 5, { authorization: `${firstuser}@active` })
   await sleep(3000)
 
+  console.log('delegator votes for alliances before its delegatee')
+  await contracts.proposals.against(fourthuser, 2, 5, { authorization: `${fourthuser}@active` })
+
   console.log('vote for alliances')
   await contracts.proposals.against(thirduser, 2, 50, { authorization: `${thirduser}@active` })
   await sleep(3000)
 
+  console.log('delegator votes for alliances after its delegatee')
+  await contracts.proposals.favour(seconduser, 2, 4, { authorization: `${seconduser}@active` })
+
+  console.log('delegator votes another campaign after its delegatee spent a quarter of the chain')
+  let spentVoiceReused = true
+  try {
+    await contracts.proposals.favour(seconduser, 3, 8, { authorization: `${seconduser}@active` })
+  } catch (err) {
+    spentVoiceReused = false
+    console.log('voice spent by the delegatee can not be voted again')
+  }
+  await contracts.proposals.favour(seconduser, 3, 7, { authorization: `${seconduser}@active` })
+
   const usersTable = await eos.getTableRows({
     code: accounts,
     scope: accounts,
@@ -2035,24 +2068,46 @@ describe('delegate trust', async assert => {
 
   const voicesAfterVote = await getVoices()
 
+  const delegatedAfterVote = await eos.getTableRows({
+    code: proposals,
+    scope: scopeCampaigns,
+    table: 'delvoice',
+    json: true,
+  })
+
+  const propsAfterVote = await eos.getTableRows({
+    code: proposals,
+    scope: proposals,
+    table: 'props',
+    json: true,
+  })
+
   console.log('pass proposals')
   await contracts.proposals.onperiod({ authorization: `${proposals}@active` })
-  await sleep(3000)
+  await sleep(6000)
+
+  const repsAfterOnperiod = (await eos.getTableRows({
+    code: accounts,
+    scope: accounts,
+    table: 'users',
+    json: true,
+  })).rows.map(r => r.reputation)
 
   for (let i = 0; i < users.length; i++) {
     await contracts.proposals.testsetvoice(users[i], voices[i], { authorization: `${proposals}@active` })
   }
 
-  console.log('add another delegation')
-  await contracts.proposals.delegate(fifthuser, firstuser, scopeCampaigns, { authorization: `${fifthuser}@active` }) 
-
   console.log('cancel trust delegation')
   await contracts.proposals.undelegate(fourthuser, scopeCampaigns, { authorization: `${fourthuser}@active` })
+  await contracts.proposals.undelegate(fifthuser, scopeCampaigns, { authorization: `${fifthuser}@active` })
   
   console.log('change opinion')
   await contracts.proposals.against(firstuser, 1, 10, { authorization: `${firstuser}@active` })
   await sleep(3000)
 
+  console.log('add another delegation after the vote')
+  await contracts.proposals.delegate(fifthuser, firstuser, scopeCampaigns, { authorization: `${fifthuser}@active` }) 
+
   const voicesAfterOnperiod = await getVoices()
 
   console.log('cancel trust delegation')
@@ -2060,6 +2115,8 @@ describe('delegate trust', async assert => {
   await contracts.proposals.undelegate(thirduser, scopeCampaigns, { authorization: `${firstuser}@active` })
   await contracts.proposals.undelegate(fifthuser, scopeCampaigns, { authorization: `${fifthuser}@active` })
 
+  const voicesAfterUndelegate = await getVoices()
+
   const delCampaigns = await eos.getTableRows({
     code: proposals,
     scope: scopeCampaigns,
@@ -2089,41 +2146,77 @@ describe('delegate trust', async assert => {
         delegator: fourthuser,
         delegatee: thirduser,
         weight: '1.00000000000000000'
+      },
+      {
+        delegator: fifthuser,
+        delegatee: thirduser,
+        weight: '1.00000000000000000'
       }
     ]
   })
 
   assert({
-    given: 'user delegated its voice',
-    should: 'not be able to vote by itself',
-    actual: noVoteWhenVoiceIsDelegated,
-    expected: true
+    given: 'users voted',
+    should: 'give reputation to the users who voted',
+    actual: reps,
+    expected: [10, 10, 10, 10, 0]
   })
 
   assert({
-    given: 'user delegated its voice',
-    should: 'give a user a percentage of the earned reputation',
-    actual: reps,
-    expected: [2, 1, 1, 1, 0]
+    given: 'the cycle ended',
+    should: 'give delegators whose delegatee voted votedel.mul of the reputation',
+    actual: repsAfterOnperiod,
+    expected: [10, 10, 10, 10, 8]
   })
 
   assert({
     given: 'trust delegated',
-    should: 'decrease the voice of delegators',
+    should: 'aggregate the voice delegated to each delegatee',
+    actual: delegatedAfterVote.rows.map(r => ({ delegatee: r.delegatee, voice: r.voice })),
+    expected: [
+      { delegatee: firstuser, voice: 107 },
+      { delegatee: seconduser, voice: 0 },
+      { delegatee: thirduser, voice: 57 },
+      { delegatee: fourthuser, voice: 0 },
+      { delegatee: fifthuser, voice: 0 }
+    ]
+  })
+
+  assert({
+    given: 'delegatees voted and delegators voted themselves',
+    should: 'add the delegated voice in the same share to the vote, without the delegators that voted',
+    actual: propsAfterVote.rows.map(r => ({ id: r.id, favour: r.favour, against: r.against })),
+    expected: [
+      { id: 1, favour: 34, against: 0 },
+      { id: 2, favour: 4, against: 58 },
+      { id: 3, favour: 7, against: 0 }
+    ]
+  })
+
+  assert({
+    given: 'the delegatee spent a quarter of the chain on another proposal',
+    should: 'not let the delegator vote with that share of its voice',
+    actual: spentVoiceReused,
+    expected: false
+  })
+
+  assert({
+    given: 'trust delegated',
+    should: 'decrease the voice of the delegatees and charge delegators that voted',
     actual: voicesAfterVote,
     expected: {
       campaigns: [
         { account: firstuser, balance: 15 },
-        { account: seconduser, balance: 8 },
-        { account: thirduser, balance: 38 },
-        { account: fourthuser, balance: 27 },
+        { account: seconduser, balance: 0 },
+        { account: thirduser, balance: 50 },
+        { account: fourthuser, balance: 35 },
         { account: fifthuser, balance: 22 }
       ],
       alliances: [
         { account: firstuser, balance: 20 },
-        { account: seconduser, balance: 0 },
+        { account: seconduser, balance: 3 },
         { account: thirduser, balance: 0 },
-        { account: fourthuser, balance: 0 },
+        { account: fourthuser, balance: 30 },
         { account: fifthuser, balance: 22 }
       ]
     }
@@ -2131,13 +2224,13 @@ describe('delegate trust', async assert => {
 
   assert({
     given: 'trust delegated and opinion changed',
-    should: 'decrease the voice of delegators',
+    should: 'only decrease the voice of the delegatee',
     actual: voicesAfterOnperiod,
     expected: {
       campaigns: [
         { account: firstuser, balance: 10 },
-        { account: seconduser, balance: 5 },
-        { account: thirduser, balance: 25 },
+        { account: seconduser, balance: 10 },
+        { account: thirduser, balance: 50 },
         { account: fourthuser, balance: 35 },
         { account: fifthuser, balance: 22 }
       ],
@@ -2151,6 +2244,19 @@ describe('delegate trust', async assert => {
     }
   })
 
+  assert({
+    given: 'trust canceled after the delegatee voted',
+    should: 'charge the delegators the share their delegatee spent since they delegated',
+    actual: voicesAfterUndelegate.campaigns,
+    expected: [
+      { account: firstuser, balance: 10 },
+      { account: seconduser, balance: 5 },
+      { account: thirduser, balance: 25 },
+      { account: fourthuser, balance: 35 },
+      { account: fifthuser, balance: 22 }
+    ]
+  })
+
   assert({
     given: 'trust canceled by delegatee',
     should: 'cancel trust delegation',
@@ -98,7 +98,7 @@ describe('scheduler', async assert => {
     assert({
         given: '1 second delay was executed 30 seonds',
         should: 'be executed close to 30 times (was: '+delta1+')',
-        actual: delta1 >= 20 && delta1 <= 28, // NOTE: ACTUALLY 27 => 31 - 4, 4 is the other action
+        actual: delta1 >= 20 && delta1 <= 32, // NOTE: both ops run in the same tick when both are due
         expected: true
     })
 
@@ -118,6 +118,147 @@ describe('scheduler', async assert => {
 
     
 
+})
+
+describe('scheduler, dependencies', async assert => {
+
+    if (!isLocal()) {
+        console.log("only run unit tests on local - don't reset on mainnet or testnet")
+        return
+    }
+
+    contracts = await Promise.all([
+        eos.contract(scheduler),
+        eos.contract(settings)
+    ]).then(([scheduler, settings]) => ({
+        scheduler, settings
+    }))
+
+    console.log('scheduler reset')
+    await contracts.scheduler.reset({ authorization: `${scheduler}@active` })
+
+    console.log('settings reset')
+    await contracts.settings.reset({ authorization: `${settings}@active` })
+    await contracts.settings.configure('secndstoexec', 1, { authorization: `${settings}@active` })
+
+    console.log('two runs after one, one reports when it is done')
+    await contracts.scheduler.configop('one', 'test1', 'cycle.seeds', 60, 0, { authorization: `${scheduler}@active` })
+    await contracts.scheduler.configop('two', 'test2', 'cycle.seeds', 1, 0, { authorization: `${scheduler}@active` })
+    await contracts.scheduler.configdeps('one', [], true, { authorization: `${scheduler}@active` })
+    await contracts.scheduler.configdeps('two', ['one'], false, { authorization: `${scheduler}@active` })
+
+    await contracts.scheduler.test1({ authorization: `${scheduler}@active` })
+    await contracts.scheduler.test2({ authorization: `${scheduler}@active` })
+
+    const getValues = async () => {
+        const rows = await getTableRows({
+            code: scheduler,
+            scope: scheduler,
+            table: 'test',
+            json: true,
+            lower_bound: 'unit.test.1',
+            upper_bound: 'unit.test.2',
+            limit: 100
+        })
+        return rows.rows.map(r => r.value)
+    }
+
+    const getState = async () => {
+        const rows = await getTableRows({
+            code: scheduler,
+            scope: scheduler,
+            table: 'opstate',
+            json: true,
+            limit: 100
+        })
+        return rows.rows.filter(r => r.id == 'one')[0]
+    }
+
+    await contracts.scheduler.start({ authorization: `${scheduler}@active` })
+
+    await sleep(4000)
+
+    const whileRunning = await getValues()
+    const stateRunning = await getState()
+
+    console.log('one is done')
+    await contracts.scheduler.opdone(scheduler, 'test1', { authorization: `${scheduler}@active` })
+
+    await sleep(4000)
+
+    await contracts.scheduler.stop({ authorization: `${scheduler}@active` })
+
+    const afterDone = await getValues()
+    const stateDone = await getState()
+
+    assert({
+        given: 'one started and has not reported',
+        should: 'be running and two has not run',
+        actual: [whileRunning[0], whileRunning[1], !!stateRunning.running],
+        expected: [1, 0, true]
+    })
+
+    assert({
+        given: 'one reported it is done',
+        should: 'not be running and two has run',
+        actual: [!!stateDone.running, afterDone[1] > 0],
+        expected: [false, true]
+    })
+
+})
+
+describe('scheduler, dependency due every tick', async assert => {
+
+    if (!isLocal()) {
+        console.log("only run unit tests on local - don't reset on mainnet or testnet")
+        return
+    }
+
+    contracts = await Promise.all([
+        eos.contract(scheduler),
+        eos.contract(settings)
+    ]).then(([scheduler, settings]) => ({
+        scheduler, settings
+    }))
+
+    console.log('scheduler reset')
+    await contracts.scheduler.reset({ authorization: `${scheduler}@active` })
+
+    console.log('settings reset')
+    await contracts.settings.reset({ authorization: `${settings}@active` })
+    await contracts.settings.configure('secndstoexec', 1, { authorization: `${settings}@active` })
+
+    console.log('two runs after one, one is due every second and never reports')
+    await contracts.scheduler.configop('one', 'test1', 'cycle.seeds', 1, 0, { authorization: `${scheduler}@active` })
+    await contracts.scheduler.configop('two', 'test2', 'cycle.seeds', 1, 0, { authorization: `${scheduler}@active` })
+    await contracts.scheduler.configdeps('one', [], false, { authorization: `${scheduler}@active` })
+    await contracts.scheduler.configdeps('two', ['one'], false, { authorization: `${scheduler}@active` })
+
+    await contracts.scheduler.test1({ authorization: `${scheduler}@active` })
+    await contracts.scheduler.test2({ authorization: `${scheduler}@active` })
+
+    await contracts.scheduler.start({ authorization: `${scheduler}@active` })
+    await sleep(6000)
+    await contracts.scheduler.stop({ authorization: `${scheduler}@active` })
+
+    const values = await getTableRows({
+        code: scheduler,
+        scope: scheduler,
+        table: 'test',
+        json: true,
+        lower_bound: 'unit.test.1',
+        upper_bound: 'unit.test.2',
+        limit: 100
+    })
+    const [one, two] = values.rows.map(r => r.value)
+
+    assert({
+        given: 'a dependency that is due again on every tick',
+        should: 'still let the op after it run once it has run',
+        actual: [one > 0, two > 0],
+        expected: [true, true]
+    })
+
 })
 
 describe('scheduler, organization.cleandaus', async assert => {
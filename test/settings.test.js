@@ -67,5 +67,21 @@ describe('settings', async assert => {
     expected: 77
   })
 
+  await contract.configure("batchsize", 77, { authorization: `${settings}@active` })
+
+  const snapshot = await eos.getTableRows({
+    code: settings,
+    scope: settings,
+    table: 'confsnap',
+    json: true
+  })
+
+  assert({
+    given: 'set a snapshot parameter',
+    should: 'copy the value into its slot',
+    actual: snapshot.rows[0].values[0],
+    expected: 77
+  })
+
 
 })
@@ -65,7 +65,9 @@ describe('token.transfer.history', async assert => {
   assert({
     given: 'transactions',
     should: 'have transaction stat entries',
-    actual: stats.rows.filter( (item) => item.account == firstuser || item.account == seconduser),
+    actual: stats.rows
+      .filter( (item) => item.account == firstuser || item.account == seconduser)
+      .map(({ epoch, ...item }) => item),
     expected: [
       {
         "account": "seedsuseraaa",
@@ -230,12 +232,39 @@ describe('token calculate circulating supply', async assert => {
   
   console.log("circulating: "+JSON.stringify(rows, null, 2))
 
+  const getCirculating = async () => {
+    const { rows } = await getTableRows({
+      code: token,
+      scope: token,
+      table: 'circulating',
+      json: true
+    })
+    return rows[0].circulating
+  }
+
+  console.log('transfer to a system account')
+  await contracts.token.addsysacct(seconduser, { authorization: `${token}@active` })
+  await contracts.token.transfer(firstuser, seconduser, '10.0000 SEEDS', `cc2`, { authorization: `${firstuser}@active` })
+  const tracked = await getCirculating()
+
+  await contracts.token.updatecirc({ authorization: `${token}@active` })
+  const recomputed = await getCirculating()
+
+  await contracts.token.delsysacct(seconduser, { authorization: `${token}@active` })
+
   assert({
     given: 'update circulating',
     should: 'have token circulating number',
     actual: rows.length,
     expected: 1
   })
+
+  assert({
+    given: 'transfer to a system account',
+    should: 'track circulating supply as it moves',
+    actual: tracked,
+    expected: recomputed
+  })
 })
 
 describe('token.resetweekly', async assert => {
@@ -278,13 +307,24 @@ describe('token.resetweekly', async assert => {
     json: true
   })
 
-  balancesBefore = balancesBefore.rows.map(row => row.outgoing_transactions)
+  const weekOf = async () => {
+    const epochs = await getTableRows({
+      code: token,
+      scope: token,
+      table: 'epochs',
+      json: true
+    })
+    const trxstat = epochs.rows.find(row => row.counter == 'trxstat')
+    return trxstat ? trxstat.epoch : 0
+  }
+
+  const outgoingThisWeek = (rows, epoch) => rows.map(row => (row.epoch || 0) == epoch ? row.outgoing_transactions : 0)
+
+  balancesBefore = outgoingThisWeek(balancesBefore.rows, await weekOf())
  
   console.log('reset token')
   await contracts.token.resetweekly({ authorization: `${token}@active` })
 
-  await sleep(10 * 1000)
-
   let balancesAfter = await getTableRows({
     code: token,
     scope: 'SEEDS',
@@ -292,7 +332,7 @@ describe('token.resetweekly', async assert => {
     json: true
   })
 
-  balancesAfter = balancesAfter.rows.map(row => row.outgoing_transactions)
+  balancesAfter = outgoingThisWeek(balancesAfter.rows, await weekOf())
 
   await contracts.settings.reset({ authorization: `${settings}@active` })
 
@@ -382,3 +422,98 @@ describe('transaction limits', async assert => {
   await verifyLimit(thirduser, firstuser, minTrx)
 
 })
+
+describe('token.transfermany', async assert => {
+
+  if (!isLocal()) {
+    console.log("only run unit tests on local - don't reset accounts on mainnet or testnet")
+    return
+  }
+
+  const contracts = await initContracts({ token, settings, accounts })
+
+  console.log('reset settings')
+  await contracts.settings.reset({ authorization: `${settings}@active` })
+
+  console.log('reset accounts')
+  await contracts.accounts.reset({ authorization: `${accounts}@active` })
+
+  try {
+    await contracts.token.delpayer(firstuser, { authorization: `${token}@active` })
+  } catch (err) {
+    console.log('firstuser is not a payer yet')
+  }
+
+  const payouts = [
+    { first: seconduser, second: '1.0000 SEEDS' },
+    { first: thirduser, second: '2.0000 SEEDS' }
+  ]
+
+  const fails = async (transfers) => {
+    try {
+      await contracts.token.transfermany(firstuser, transfers, 'payout', { authorization: `${firstuser}@active` })
+      return false
+    } catch (err) {
+      return true
+    }
+  }
+
+  console.log('transfermany before addpayer')
+  const failsWithoutPayer = await fails(payouts)
+
+  console.log('add payer')
+  await contracts.token.addpayer(firstuser, { authorization: `${token}@active` })
+
+  const balancesBefore = await Promise.all([firstuser, seconduser, thirduser].map(getBalance))
+
+  console.log('transfermany')
+  await contracts.token.transfermany(firstuser, payouts, 'payout', { authorization: `${firstuser}@active` })
+
+  const balancesAfter = await Promise.all([firstuser, seconduser, thirduser].map(getBalance))
+
+  const failsEmpty = await fails([])
+  const failsToSelf = await fails([{ first: firstuser, second: '1.0000 SEEDS' }])
+  const failsZero = await fails([{ first: seconduser, second: '0.0000 SEEDS' }])
+  const failsMixedSymbols = await fails([{ first: seconduser, second: '1.0000 SEEDS' }, { first: thirduser, second: '1.0000 TESTS' }])
+  const failsOverdrawn = await fails([{ first: seconduser, second: `${balancesAfter[0] + 1}.0000 SEEDS` }])
+
+  const payers = await getTableRows({
+    code: token,
+    scope: token,
+    table: 'payers',
+    lower_bound: firstuser,
+    upper_bound: firstuser,
+    json: true
+  })
+
+  await contracts.token.delpayer(firstuser, { authorization: `${token}@active` })
+
+  assert({
+    given: 'transfermany from an account that is not a payer',
+    should: 'fail',
+    actual: failsWithoutPayer,
+    expected: true
+  })
+
+  assert({
+    given: 'transfermany from a payer',
+    should: 'debit the payer once and credit every payee',
+    actual: balancesAfter.map((balance, index) => balance - balancesBefore[index]),
+    expected: [-3, 1, 2]
+  })
+
+  assert({
+    given: 'invalid payouts',
+    should: 'fail',
+    actual: [failsEmpty, failsToSelf, failsZero, failsMixedSymbols, failsOverdrawn],
+    expected: [true, true, true, true, true]
+  })
+
+  assert({
+    given: 'transfermany from a payer',
+    should: 'count the payout',
+    actual: payers.rows.map(({ sender, payouts, recipients, volume }) => ({ sender, payouts, recipients, volume })),
+    expected: [{ sender: firstuser, payouts: 1, recipients: 2, volume: '3.0000 SEEDS' }]
+  })
+
+})